@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef DATASETWRITER_H
+#define DATASETWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+
+/**
+ * Write rendered frames to a folder through a pool of writer threads.
+ *
+ * In `Layout::chunked` layout, frames are stored in `chunk_XXXXXX.bin` files of up to `chunk_frames` frames each.
+ * A frame is a fixed-size record made of the enabled outputs, in order: color as 8-bit BGR, depth as 32-bit floats
+ * in meters and mask as 16-bit instance IDs, each with rows stored contiguously. `dataset.txt` describes the records.
+ *
+ * In `Layout::images` layout, each output of each frame is stored as a PNG image, i.e. `color_XXXXXX.png`,
+ * `depth_XXXXXX.png` as 16-bit integers in units of 1 / `depth_scale` meters, and `mask_XXXXXX.png` as 16-bit instance IDs.
+ */
+class DatasetWriter
+{
+public:
+    enum class Layout
+    {
+        chunked,
+        images
+    };
+
+    struct Outputs
+    {
+        bool color = true;
+
+        bool depth = false;
+
+        bool mask = false;
+    };
+
+    /**
+     * @throws std::runtime_error if the folder can not be created or no output is enabled.
+     */
+    DatasetWriter(const std::string& folder, const Layout& layout, const Outputs& outputs, const cv::Size& size, const size_t chunk_frames,
+                  const double depth_scale, const size_t threads_number);
+
+    /**
+     * Wait for the queued frames to be written.
+     */
+    ~DatasetWriter();
+
+    /**
+     * Queue a frame. Images of disabled outputs are ignored. Images are shared with the writer threads, so that they
+     * must not be modified afterwards, but they may be regions of a larger image.
+     *
+     * Blocks while the queue is full, so that rendering does not outpace writing.
+     */
+    void write(const cv::Mat& color, const cv::Mat& depth, const cv::Mat& mask);
+
+    /**
+     * Write the last partial chunk and the dataset description, and wait for the queued frames to be written.
+     *
+     * @return true upon success, false if any file could not be written.
+     */
+    bool finish();
+
+    size_t getFramesNumber() const;
+
+private:
+    DatasetWriter(const DatasetWriter&) = delete;
+
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    void enqueue(std::function<bool()> job);
+
+    void run();
+
+    void appendImage(const cv::Mat& image, std::vector<unsigned char>& data) const;
+
+    void flushChunk();
+
+    bool writeDescription() const;
+
+    const std::string log_ID_ = "[SI::DatasetWriter]";
+
+    const std::string folder_;
+
+    const Layout layout_;
+
+    const Outputs outputs_;
+
+    const cv::Size size_;
+
+    const size_t chunk_frames_;
+
+    const double depth_scale_;
+
+    size_t frames_number_ = 0;
+
+    size_t chunks_number_ = 0;
+
+    std::vector<unsigned char> chunk_;
+
+    size_t chunk_frames_number_ = 0;
+
+    bool finished_ = false;
+
+    std::vector<std::thread> threads_;
+
+    std::deque<std::function<bool()>> jobs_;
+
+    size_t max_jobs_;
+
+    bool stop_ = false;
+
+    std::atomic<bool> failed_;
+
+    std::mutex mutex_;
+
+    std::condition_variable job_queued_;
+
+    std::condition_variable job_taken_;
+};
+
+#endif /* DATASETWRITER_H */
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef POSESTREAM_H
+#define POSESTREAM_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/**
+ * A memory-mapped stream of frames, each made of a camera pose followed by the pose of each mesh model.
+ * Poses are 7-component vectors, (x, y, z) position and (ux, uy, uz, theta) axis-angle orientation.
+ *
+ * In `Format::binary` files, frames are consecutive records of native-endian 64-bit floating point values.
+ * In `Format::csv` files, each line is a frame with values separated by commas or white spaces.
+ * Empty lines and lines starting with `#` are skipped. Line starts are indexed when the file is opened,
+ * and each line is parsed in place when its frame is requested.
+ */
+class PoseStream
+{
+public:
+    enum class Format
+    {
+        binary,
+        csv
+    };
+
+    /**
+     * Open a pose stream file and memory-map it.
+     *
+     * @throws std::runtime_error if the file can not be opened, or if a binary file is not made of whole frames.
+     */
+    PoseStream(const std::string& path, const Format& format, const size_t models_number);
+
+    ~PoseStream();
+
+    size_t size() const;
+
+    /**
+     * Returns the number of values in a frame, i.e. 7 times the number of mesh models plus one.
+     */
+    size_t getFrameSize() const;
+
+    /**
+     * Copy the values of the frame at `index` to `values`.
+     *
+     * @return true upon success, false if the index is out of range or if a CSV line does not hold a whole frame.
+     */
+    bool getFrame(const size_t index, std::vector<double>& values) const;
+
+private:
+    PoseStream(const PoseStream&) = delete;
+
+    PoseStream& operator=(const PoseStream&) = delete;
+
+    void unmap();
+
+    bool parseLine(const size_t index, std::vector<double>& values) const;
+
+    const std::string log_ID_ = "[SI::PoseStream]";
+
+    Format format_;
+
+    size_t frame_size_;
+
+    const char* data_ = nullptr;
+
+    size_t data_size_ = 0;
+
+    /* Offsets of the first character of each frame line, CSV only. */
+    std::vector<size_t> line_offsets_;
+
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+#endif /* POSESTREAM_H */
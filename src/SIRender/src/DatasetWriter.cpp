@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "DatasetWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include <opencv2/highgui/highgui.hpp>
+
+
+namespace
+{
+    std::string getFileName(const std::string& folder, const std::string& prefix, const size_t index, const std::string& extension)
+    {
+        std::ostringstream name;
+        name << folder << "/" << prefix << "_" << std::setw(6) << std::setfill('0') << index << extension;
+
+        return name.str();
+    }
+}
+
+
+DatasetWriter::DatasetWriter
+(
+    const std::string& folder,
+    const Layout& layout,
+    const Outputs& outputs,
+    const cv::Size& size,
+    const size_t chunk_frames,
+    const double depth_scale,
+    const size_t threads_number
+) :
+    folder_(folder),
+    layout_(layout),
+    outputs_(outputs),
+    size_(size),
+    chunk_frames_(std::max<size_t>(chunk_frames, 1)),
+    depth_scale_(depth_scale),
+    max_jobs_(2 * std::max<size_t>(threads_number, 1)),
+    failed_(false)
+{
+    if (!outputs_.color && !outputs_.depth && !outputs_.mask)
+        throw std::runtime_error("ERROR::DATASETWRITER::CTOR\nERROR:\n\tNo output is enabled.");
+
+#ifdef _WIN32
+    const int result = _mkdir(folder_.c_str());
+#else
+    const int result = mkdir(folder_.c_str(), 0755);
+#endif
+    if (result != 0 && errno != EEXIST)
+        throw std::runtime_error("ERROR::DATASETWRITER::CTOR\nERROR:\n\tCould not create folder " + folder_ + ": " + std::strerror(errno) + ".");
+
+    for (size_t i = 0; i < std::max<size_t>(threads_number, 1); ++i)
+        threads_.emplace_back(&DatasetWriter::run, this);
+
+    std::cout << log_ID_ << "Writing to " << folder_ << " with " << threads_.size() << " threads." << std::endl;
+}
+
+
+DatasetWriter::~DatasetWriter()
+{
+    finish();
+}
+
+
+void DatasetWriter::write(const cv::Mat& color, const cv::Mat& depth, const cv::Mat& mask)
+{
+    const size_t frame = frames_number_++;
+
+    if (layout_ == Layout::chunked)
+    {
+        /* Copy the frame to the chunk buffer, so that the images can be released as soon as the frame is queued. */
+        if (outputs_.color)
+            appendImage(color, chunk_);
+
+        if (outputs_.depth)
+            appendImage(depth, chunk_);
+
+        if (outputs_.mask)
+            appendImage(mask, chunk_);
+
+        if (++chunk_frames_number_ == chunk_frames_)
+            flushChunk();
+
+        return;
+    }
+
+    const std::string folder = folder_;
+    const Outputs outputs = outputs_;
+    const double depth_scale = depth_scale_;
+
+    enqueue([folder, outputs, depth_scale, frame, color, depth, mask]()
+    {
+        bool success = true;
+
+        if (outputs.color)
+            success &= cv::imwrite(getFileName(folder, "color", frame, ".png"), color);
+
+        if (outputs.depth)
+        {
+            cv::Mat depth_u16;
+            depth.convertTo(depth_u16, CV_16U, depth_scale);
+
+            success &= cv::imwrite(getFileName(folder, "depth", frame, ".png"), depth_u16);
+        }
+
+        if (outputs.mask)
+            success &= cv::imwrite(getFileName(folder, "mask", frame, ".png"), mask);
+
+        if (!success)
+            std::cerr << "ERROR::DATASETWRITER::WRITE\nERROR:\n\tCould not write the images of frame " << frame << "." << std::endl;
+
+        return success;
+    });
+}
+
+
+bool DatasetWriter::finish()
+{
+    if (finished_)
+        return !failed_;
+
+    if (chunk_frames_number_ > 0)
+        flushChunk();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    job_queued_.notify_all();
+
+    for (std::thread& thread : threads_)
+        thread.join();
+    threads_.clear();
+
+    finished_ = true;
+
+    if (!writeDescription())
+        failed_ = true;
+
+    return !failed_;
+}
+
+
+size_t DatasetWriter::getFramesNumber() const
+{
+    return frames_number_;
+}
+
+
+void DatasetWriter::enqueue(std::function<bool()> job)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_taken_.wait(lock, [this] { return jobs_.size() < max_jobs_; });
+
+        jobs_.push_back(std::move(job));
+    }
+
+    job_queued_.notify_one();
+}
+
+
+void DatasetWriter::run()
+{
+    while (true)
+    {
+        std::function<bool()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_queued_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+
+            /* Queued jobs are completed before stopping. */
+            if (jobs_.empty())
+                return;
+
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job_taken_.notify_one();
+
+        if (!job())
+            failed_ = true;
+    }
+}
+
+
+void DatasetWriter::appendImage(const cv::Mat& image, std::vector<unsigned char>& data) const
+{
+    /* Images may be regions of a larger image, hence rows are copied one by one. */
+    const size_t row_bytes = image.cols * image.elemSize();
+    for (int y = 0; y < image.rows; ++y)
+        data.insert(data.end(), image.ptr<unsigned char>(y), image.ptr<unsigned char>(y) + row_bytes);
+}
+
+
+void DatasetWriter::flushChunk()
+{
+    const std::string file_name = getFileName(folder_, "chunk", chunks_number_++, ".bin");
+    const std::shared_ptr<std::vector<unsigned char>> chunk = std::make_shared<std::vector<unsigned char>>(std::move(chunk_));
+
+    chunk_ = std::vector<unsigned char>();
+    chunk_.reserve(chunk->size());
+    chunk_frames_number_ = 0;
+
+    enqueue([file_name, chunk]()
+    {
+        std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(chunk->data()), chunk->size());
+
+        if (!file.good())
+        {
+            std::cerr << "ERROR::DATASETWRITER::WRITE\nERROR:\n\tCould not write " << file_name << "." << std::endl;
+            return false;
+        }
+
+        return true;
+    });
+}
+
+
+bool DatasetWriter::writeDescription() const
+{
+    std::ofstream file(folder_ + "/dataset.txt", std::ios::trunc);
+
+    file << "layout " << (layout_ == Layout::chunked ? "chunked" : "images") << "\n";
+    file << "width " << size_.width << "\n";
+    file << "height " << size_.height << "\n";
+    file << "frames " << frames_number_ << "\n";
+
+    file << "outputs";
+    if (outputs_.color)
+        file << " color";
+    if (outputs_.depth)
+        file << " depth";
+    if (outputs_.mask)
+        file << " mask";
+    file << "\n";
+
+    if (layout_ == Layout::chunked)
+    {
+        const size_t pixels = static_cast<size_t>(size_.area());
+        const size_t frame_bytes = pixels * ((outputs_.color ? 3 : 0) + (outputs_.depth ? 4 : 0) + (outputs_.mask ? 2 : 0));
+
+        file << "chunks " << chunks_number_ << "\n";
+        file << "chunk_frames " << chunk_frames_ << "\n";
+        file << "frame_bytes " << frame_bytes << "\n";
+        if (outputs_.color)
+            file << "color uint8 bgr\n";
+        if (outputs_.depth)
+            file << "depth float32 meters\n";
+        if (outputs_.mask)
+            file << "mask uint16 instance_id\n";
+    }
+    else
+    {
+        file << "depth_scale " << depth_scale_ << "\n";
+    }
+
+    if (!file.good())
+    {
+        std::cerr << "ERROR::DATASETWRITER::FINISH\nERROR:\n\tCould not write " << folder_ << "/dataset.txt." << std::endl;
+        return false;
+    }
+
+    return true;
+}
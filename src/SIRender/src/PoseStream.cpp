@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "PoseStream.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+PoseStream::PoseStream(const std::string& path, const Format& format, const size_t models_number) :
+    format_(format),
+    frame_size_(7 * (models_number + 1))
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("ERROR::POSESTREAM::CTOR\nERROR:\n\tCould not open " + path + ".");
+    file_handle_ = file;
+
+    LARGE_INTEGER file_size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    mapping_handle_ = mapping;
+
+    if (mapping != nullptr)
+    {
+        data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        data_size_ = static_cast<size_t>(file_size.QuadPart);
+    }
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        throw std::runtime_error("ERROR::POSESTREAM::CTOR\nERROR:\n\tCould not open " + path + ".");
+
+    struct stat file_stat;
+    if (fstat(file, &file_stat) == 0 && file_stat.st_size > 0)
+    {
+        void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (data != MAP_FAILED)
+        {
+            /* Frames are read in order. */
+            madvise(data, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+
+            data_ = static_cast<const char*>(data);
+            data_size_ = static_cast<size_t>(file_stat.st_size);
+        }
+    }
+
+    /* The mapping stays valid after closing the file descriptor. */
+    close(file);
+#endif
+
+    if (data_ == nullptr)
+    {
+        unmap();
+
+        throw std::runtime_error("ERROR::POSESTREAM::CTOR\nERROR:\n\tCould not map " + path + " to memory. Is the file empty?");
+    }
+
+    if (format_ == Format::binary)
+    {
+        if (data_size_ % (frame_size_ * sizeof(double)) != 0)
+        {
+            unmap();
+
+            throw std::runtime_error("ERROR::POSESTREAM::CTOR\nERROR:\n\tThe size of " + path + " is not a multiple of the frame size of " +
+                                     std::to_string(frame_size_ * sizeof(double)) + " bytes.");
+        }
+    }
+    else
+    {
+        size_t begin = 0;
+        while (begin < data_size_)
+        {
+            const char* line_end = static_cast<const char*>(std::memchr(data_ + begin, '\n', data_size_ - begin));
+            const size_t end = line_end != nullptr ? static_cast<size_t>(line_end - data_) : data_size_;
+
+            size_t first = begin;
+            while (first < end && (data_[first] == ' ' || data_[first] == '\t' || data_[first] == '\r'))
+                ++first;
+
+            if (first < end && data_[first] != '#')
+                line_offsets_.push_back(first);
+
+            begin = end + 1;
+        }
+    }
+
+    std::cout << log_ID_ << "Mapped " << size() << " frames from " << path << "." << std::endl;
+}
+
+
+PoseStream::~PoseStream()
+{
+    unmap();
+}
+
+
+size_t PoseStream::size() const
+{
+    if (format_ == Format::binary)
+        return data_size_ / (frame_size_ * sizeof(double));
+
+    return line_offsets_.size();
+}
+
+
+size_t PoseStream::getFrameSize() const
+{
+    return frame_size_;
+}
+
+
+bool PoseStream::getFrame(const size_t index, std::vector<double>& values) const
+{
+    if (index >= size())
+        return false;
+
+    values.resize(frame_size_);
+
+    if (format_ == Format::csv)
+        return parseLine(index, values);
+
+    /* Records are not necessarily aligned to 8 bytes in memory. */
+    std::memcpy(values.data(), data_ + index * frame_size_ * sizeof(double), frame_size_ * sizeof(double));
+
+    return true;
+}
+
+
+void PoseStream::unmap()
+{
+#ifdef _WIN32
+    if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+
+    if (mapping_handle_ != nullptr)
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+
+    if (file_handle_ != nullptr)
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    if (data_ != nullptr)
+        munmap(const_cast<char*>(data_), data_size_);
+#endif
+
+    data_ = nullptr;
+    data_size_ = 0;
+}
+
+
+bool PoseStream::parseLine(const size_t index, std::vector<double>& values) const
+{
+    const auto is_separator = [](const char c) { return c == ',' || c == ' ' || c == '\t' || c == '\r'; };
+
+    size_t position = line_offsets_[index];
+    size_t count = 0;
+
+    while (position < data_size_ && data_[position] != '\n')
+    {
+        if (is_separator(data_[position]))
+        {
+            ++position;
+            continue;
+        }
+
+        /* The mapped file is not null-terminated, so that each value is copied before being converted. */
+        char token[64];
+        size_t length = 0;
+        while (position < data_size_ && data_[position] != '\n' && !is_separator(data_[position]) && length < sizeof(token) - 1)
+            token[length++] = data_[position++];
+        token[length] = '\0';
+
+        char* token_end = nullptr;
+        const double value = std::strtod(token, &token_end);
+        if (token_end != token + length || length == sizeof(token) - 1 || count == frame_size_)
+        {
+            std::cerr << "ERROR::POSESTREAM::GETFRAME\nERROR:\n\tLine of frame " << index << " is not a list of " << frame_size_ << " numbers." << std::endl;
+            return false;
+        }
+
+        values[count++] = value;
+    }
+
+    if (count != frame_size_)
+    {
+        std::cerr << "ERROR::POSESTREAM::GETFRAME\nERROR:\n\tLine of frame " << index << " has " << count << " values instead of " << frame_size_ << "." << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "DatasetWriter.h"
+#include "PoseStream.h"
+
+#include <SuperimposeMesh/SICAD.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+
+namespace
+{
+    const std::string log_ID = "[si-render]";
+
+
+    void printUsage()
+    {
+        std::cout << "Usage: si-render --model <tag>=<mesh file> [--model ...] --intrinsics <width>,<height>,<fx>,<fy>,<cx>,<cy>\n"
+                     "                 --poses <pose file> --output <folder> [options]\n"
+                     "\n"
+                     "Render a stream of camera and mesh model poses to a dataset.\n"
+                     "\n"
+                     "Each frame of the pose file holds the camera pose followed by the pose of each mesh model, in the order of the\n"
+                     "--model options. Poses are 7 values: (x, y, z) position and (ux, uy, uz, theta) axis-angle orientation.\n"
+                     "\n"
+                     "Options:\n"
+                     "  --pose-format binary|csv       Binary files are records of 64-bit floats, CSV files have one frame per line.\n"
+                     "                                 Default is csv for .csv and .txt files, binary otherwise.\n"
+                     "  --layout chunked|images        Chunked binary files or PNG image sequences. Default is chunked.\n"
+                     "  --outputs <list>               Comma-separated list of color, depth and mask. Default is color.\n"
+                     "  --tiles <number>               Number of frames rendered at once. Default is 16.\n"
+                     "  --writers <number>             Number of writer threads. Default is the number of hardware threads.\n"
+                     "  --chunk-frames <number>        Number of frames per chunk in the chunked layout. Default is 256.\n"
+                     "  --depth-scale <scale>          Depth units per meter in the images layout. Default is 1000, i.e. millimeters.\n"
+                     "  --help                         Print this message." << std::endl;
+    }
+
+
+    std::vector<std::string> split(const std::string& text, const char separator)
+    {
+        std::vector<std::string> tokens;
+
+        std::istringstream stream(text);
+        std::string token;
+        while (std::getline(stream, token, separator))
+            tokens.push_back(token);
+
+        return tokens;
+    }
+
+
+    glm::dmat4 toMatrix(const double* pose)
+    {
+        glm::dmat4 matrix(1.0);
+
+        const glm::dvec3 axis(pose[3], pose[4], pose[5]);
+        if (glm::length(axis) > 0)
+            matrix = glm::rotate(matrix, pose[6], axis);
+
+        matrix[3] = glm::dvec4(pose[0], pose[1], pose[2], 1.0);
+
+        return matrix;
+    }
+
+
+    Superimpose::ModelPose toPose(const glm::dmat4& matrix)
+    {
+        const glm::dquat orientation = glm::quat_cast(glm::dmat3(matrix));
+        const glm::dvec3 axis = glm::axis(orientation);
+
+        return Superimpose::ModelPose{ matrix[3].x, matrix[3].y, matrix[3].z, axis.x, axis.y, axis.z, glm::angle(orientation) };
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    SICAD::ModelPathContainer model_paths;
+    std::vector<std::string> model_tags;
+    std::vector<double> intrinsics;
+    std::string poses_path;
+    std::string pose_format;
+    std::string output_folder;
+    DatasetWriter::Layout layout = DatasetWriter::Layout::chunked;
+    DatasetWriter::Outputs outputs;
+    size_t tiles = 16;
+    size_t writers = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+    size_t chunk_frames = 256;
+    double depth_scale = 1000.0;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option = argv[i];
+
+            if (option == "--help")
+            {
+                printUsage();
+                return EXIT_SUCCESS;
+            }
+
+            if (i + 1 == argc)
+                throw std::invalid_argument("Missing value of " + option + ".");
+
+            const std::string value = argv[++i];
+
+            if (option == "--model")
+            {
+                const size_t separator = value.find('=');
+                if (separator == std::string::npos || separator == 0 || !model_paths.emplace(value.substr(0, separator), value.substr(separator + 1)).second)
+                    throw std::invalid_argument("Invalid or repeated mesh model " + value + ".");
+
+                model_tags.push_back(value.substr(0, separator));
+            }
+            else if (option == "--intrinsics")
+            {
+                for (const std::string& token : split(value, ','))
+                    intrinsics.push_back(std::stod(token));
+
+                if (intrinsics.size() != 6 || intrinsics[0] < 1 || intrinsics[1] < 1)
+                    throw std::invalid_argument("Intrinsics must be <width>,<height>,<fx>,<fy>,<cx>,<cy>.");
+            }
+            else if (option == "--poses")
+                poses_path = value;
+            else if (option == "--pose-format")
+                pose_format = value;
+            else if (option == "--output")
+                output_folder = value;
+            else if (option == "--layout")
+            {
+                if (value == "chunked")
+                    layout = DatasetWriter::Layout::chunked;
+                else if (value == "images")
+                    layout = DatasetWriter::Layout::images;
+                else
+                    throw std::invalid_argument("Unknown layout " + value + ".");
+            }
+            else if (option == "--outputs")
+            {
+                outputs.color = false;
+                for (const std::string& token : split(value, ','))
+                {
+                    if (token == "color")
+                        outputs.color = true;
+                    else if (token == "depth")
+                        outputs.depth = true;
+                    else if (token == "mask")
+                        outputs.mask = true;
+                    else
+                        throw std::invalid_argument("Unknown output " + token + ".");
+                }
+            }
+            else if (option == "--tiles")
+                tiles = std::stoul(value);
+            else if (option == "--writers")
+                writers = std::stoul(value);
+            else if (option == "--chunk-frames")
+                chunk_frames = std::stoul(value);
+            else if (option == "--depth-scale")
+                depth_scale = std::stod(value);
+            else
+                throw std::invalid_argument("Unknown option " + option + ".");
+        }
+
+        if (model_tags.empty() || intrinsics.empty() || poses_path.empty() || output_folder.empty())
+            throw std::invalid_argument("--model, --intrinsics, --poses and --output are required.");
+
+        if (tiles == 0)
+            throw std::invalid_argument("--tiles must be positive.");
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << log_ID << " " << e.what() << "\n" << std::endl;
+        printUsage();
+
+        return EXIT_FAILURE;
+    }
+
+    if (pose_format.empty())
+    {
+        const std::string extension = poses_path.substr(std::min(poses_path.size(), poses_path.rfind('.')));
+        pose_format = (extension == ".csv" || extension == ".txt") ? "csv" : "binary";
+    }
+
+    if (pose_format != "csv" && pose_format != "binary")
+    {
+        std::cerr << log_ID << " Unknown pose format " << pose_format << "." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    const GLsizei cam_width  = static_cast<GLsizei>(intrinsics[0]);
+    const GLsizei cam_height = static_cast<GLsizei>(intrinsics[1]);
+
+    try
+    {
+        PoseStream poses(poses_path, pose_format == "csv" ? PoseStream::Format::csv : PoseStream::Format::binary, model_tags.size());
+
+        /* Color and depth need different render modes, hence two renderers if both are requested.
+         * Masks are the instance IDs written by the first renderer in the same pass. */
+        std::unique_ptr<SICAD> color_renderer;
+        std::unique_ptr<SICAD> depth_renderer;
+
+        if (outputs.color)
+            color_renderer.reset(new SICAD(model_paths, cam_width, cam_height, intrinsics[2], intrinsics[3], intrinsics[4], intrinsics[5], tiles));
+
+        if (outputs.depth || (outputs.mask && !outputs.color))
+        {
+            depth_renderer.reset(new SICAD(model_paths, cam_width, cam_height, intrinsics[2], intrinsics[3], intrinsics[4], intrinsics[5], tiles));
+
+            if (!depth_renderer->setRenderModeOpt(SICAD::RenderMode::depth))
+                throw std::runtime_error("Could not set up depth rendering.");
+        }
+
+        SICAD& mask_renderer = outputs.color ? *color_renderer : *depth_renderer;
+        if (outputs.mask && !mask_renderer.setInstanceIdOpt(true))
+            throw std::runtime_error("Could not set up mask rendering.");
+
+        /* All the renderers share the same render grid, see SICAD::getTilesNumber(). */
+        const size_t batch_size = static_cast<size_t>(mask_renderer.getTilesNumber());
+        const int tiles_cols = mask_renderer.getTilesCols();
+        const cv::Size tile_size = mask_renderer.getTileSize();
+
+        DatasetWriter writer(output_folder, layout, outputs, tile_size, chunk_frames, depth_scale, writers);
+
+        /* Each frame has its own camera, so that mesh models are rendered in the camera frame with an identity camera. */
+        double cam_x[] = { 0, 0, 0 };
+        double cam_o[] = { 1.0, 0, 0, 0 };
+
+        std::vector<double> frame;
+        std::vector<Superimpose::ModelPoseContainer> objposes;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point last_report = start;
+
+        for (size_t first = 0; first < poses.size(); first += batch_size)
+        {
+            const size_t batch = std::min(batch_size, poses.size() - first);
+
+            objposes.assign(batch, Superimpose::ModelPoseContainer());
+            for (size_t k = 0; k < batch; ++k)
+            {
+                if (!poses.getFrame(first + k, frame))
+                    throw std::runtime_error("Could not read frame " + std::to_string(first + k) + ".");
+
+                const glm::dmat4 root_to_camera = glm::inverse(toMatrix(frame.data()));
+                for (size_t m = 0; m < model_tags.size(); ++m)
+                    objposes[k].emplace(model_tags[m], toPose(root_to_camera * toMatrix(frame.data() + 7 * (m + 1))));
+            }
+
+            /* Images are allocated by every call, so that the writer threads may keep the ones of previous batches. */
+            cv::Mat color_img;
+            cv::Mat depth_img;
+            cv::Mat mask_img;
+
+            if (color_renderer && !color_renderer->superimpose(objposes, cam_x, cam_o, color_img))
+                throw std::runtime_error("Could not render the color of frame " + std::to_string(first) + " onwards.");
+
+            if (depth_renderer && !depth_renderer->superimpose(objposes, cam_x, cam_o, depth_img))
+                throw std::runtime_error("Could not render the depth of frame " + std::to_string(first) + " onwards.");
+
+            if (outputs.mask)
+                mask_img = mask_renderer.getInstanceIdImage().clone();
+
+            for (size_t k = 0; k < batch; ++k)
+            {
+                const cv::Rect tile(tile_size.width * static_cast<int>(k % tiles_cols), tile_size.height * static_cast<int>(k / tiles_cols), tile_size.width, tile_size.height);
+
+                writer.write(outputs.color ? color_img(tile) : cv::Mat(),
+                             outputs.depth ? depth_img(tile) : cv::Mat(),
+                             outputs.mask ? mask_img(tile) : cv::Mat());
+            }
+
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (now - last_report >= std::chrono::seconds(1))
+            {
+                const double seconds = std::chrono::duration<double>(now - start).count();
+                std::cout << log_ID << " Rendered " << first + batch << "/" << poses.size() << " frames, " << (first + batch) / seconds << " fps." << std::endl;
+
+                last_report = now;
+            }
+        }
+
+        const double render_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!writer.finish())
+            throw std::runtime_error("Could not write the dataset.");
+
+        const double total_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << log_ID << " Rendered " << writer.getFramesNumber() << " frames in " << render_seconds << " s, " << writer.getFramesNumber() / render_seconds << " fps, "
+                  << writer.getFramesNumber() / total_seconds << " fps including writing." << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << log_ID << " " << e.what() << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -22,6 +22,24 @@
 
 class Mesh {
 public:
+    /**
+     * Layout of the vertices stored in the vertex buffer object.
+     *
+     * - `full` stores position, normal and texture coordinates (32 bytes per vertex).
+     * - `position` stores the position only (12 bytes per vertex).
+     * - `quantized_position` stores the position only as 16-bit unsigned normalized integers (8 bytes per vertex).
+     *   Positions are quantized within an axis-aligned box and must be dequantized by the vertex shader,
+     *   e.g. by pre-multiplying the dequantization matrix to the model matrix.
+     *
+     * Layouts other than `full` can only be drawn by shaders reading the vertex position at location 0.
+     */
+    enum class VertexLayout
+    {
+        full,
+        position,
+        quantized_position
+    };
+
     struct Vertex
     {
         glm::vec3 Position;
@@ -36,22 +54,151 @@ public:
         aiString path;
     };
 
+    /**
+     * A range of `index_count` indices, starting at `first_index`, that refer to the `vertex_count`
+     * vertices starting at `base_vertex`. Indices are relative to `base_vertex`.
+     */
+    struct Submesh
+    {
+        GLuint first_index;
+        GLuint index_count;
+        GLuint base_vertex;
+        GLuint vertex_count;
+    };
+
+    /**
+     * Create a mesh from its vertices, indices and textures.
+     *
+     * Meshes are created on the CPU only, so that they can be built on any thread. The OpenGL objects
+     * are created when the mesh is uploaded, either explicitly or the first time it is drawn.
+     */
     Mesh(std::vector<Vertex> vertices, std::vector<GLuint> indices, std::vector<Texture> textures);
 
+    /**
+     * Create a mesh packing several submeshes, sharing the same textures, in a single vertex and index buffer.
+     *
+     * Indices are stored as 16-bit integers whenever either the whole mesh or each submesh has at most 65536 vertices.
+     * The whole mesh is always drawn with a single draw call.
+     */
+    Mesh(std::vector<Vertex> vertices, std::vector<GLuint> indices, std::vector<Texture> textures, std::vector<Submesh> submeshes);
+
     void Draw(Shader shader);
 
+    /**
+     * Draw the `lod`-th level of detail of the mesh. Level 0 is the original mesh.
+     */
+    void Draw(Shader shader, const size_t lod);
+
+    /**
+     * Draw the `lod`-th level of detail of the mesh. If the shader has a `triangle_offset` uniform, it is set, before each draw,
+     * to `triangle_offset` plus the index of the first drawn triangle in the level of detail, so that `triangle_offset + gl_PrimitiveID`
+     * is the index of the triangle in the level of detail, offset by `triangle_offset`, even if submeshes are drawn separately.
+     */
+    void Draw(Shader shader, const size_t lod, const GLuint triangle_offset);
+
+    /**
+     * Create the OpenGL objects of the mesh and upload vertices and indices. Does nothing if the mesh is already uploaded.
+     *
+     * @note The OpenGL context owning the mesh must be current.
+     */
+    void upload();
+
+    /**
+     * Create the buffer objects of the mesh and upload vertices and indices, but not the vertex array object, that cannot be shared
+     * among OpenGL contexts. Buffers can then be uploaded on a context sharing its objects with the one drawing the mesh,
+     * where `upload()` only creates the vertex array object. Does nothing if the buffers are already uploaded.
+     *
+     * @note An OpenGL context sharing its objects with the one drawing the mesh must be current.
+     */
+    void uploadBuffers();
+
+    /**
+     * Delete the OpenGL objects of the mesh. The mesh is uploaded again if drawn afterwards.
+     *
+     * @note Meshes do not delete their OpenGL objects on destruction, as they are copied by value.
+     *
+     * @note The OpenGL context owning the mesh must be current.
+     */
+    void release();
+
+    bool isUploaded() const;
+
+    const std::vector<Texture>& getTextures() const;
+
+    /**
+     * Replace the textures of the mesh, e.g. once the texture objects have been created.
+     */
+    void setTextures(std::vector<Texture> textures);
+
+    /**
+     * Add a coarser level of detail of the mesh, reusing the same vertices.
+     *
+     * `submeshes` must have the same base vertex and vertex count of the submeshes of the original mesh,
+     * while `indices`, first index and index count of each submesh describe the coarser triangles.
+     *
+     * @note If the mesh is already uploaded, the OpenGL context owning the mesh must be current.
+     */
+    void addLevelOfDetail(std::vector<GLuint> indices, std::vector<Submesh> submeshes);
+
+    /**
+     * Returns the number of levels of detail, including the original mesh.
+     */
+    size_t getLevelsOfDetail() const;
+
+    /**
+     * Returns the number of triangles of the `lod`-th level of detail.
+     */
+    size_t getTrianglesNumber(const size_t lod) const;
+
+    /**
+     * Upload the vertices to the vertex buffer object using the given `layout`.
+     *
+     * @note If the mesh is already uploaded, the OpenGL context owning the mesh must be current.
+     *
+     * @param layout The vertex layout.
+     * @param quantization_min Minimum corner of the box used to quantize positions, if `layout` is `quantized_position`.
+     * @param quantization_extent Size of the box used to quantize positions, if `layout` is `quantized_position`.
+     */
+    void setVertexLayout(const VertexLayout layout, const glm::vec3& quantization_min, const glm::vec3& quantization_extent);
+
+    VertexLayout getVertexLayout() const;
+
 private:
-    GLuint VAO_;
+    struct LevelOfDetail
+    {
+        std::vector<GLuint> indices;
+        std::vector<Submesh> submeshes;
+        std::vector<GLsizei> draw_counts;
+        std::vector<const GLvoid*> draw_offsets;
+        std::vector<GLint> draw_base_vertices;
+        std::vector<GLuint> draw_first_triangles;
+    };
 
-    GLuint VBO_;
+    void uploadIndices();
 
-    GLuint EBO_;
+    void uploadVertices();
 
-    std::vector<Vertex> vertices_;
+    void setUpVertexArray();
+
+    GLuint VAO_ = 0;
+
+    GLuint VBO_ = 0;
 
-    std::vector<GLuint> indices_;
+    GLuint EBO_ = 0;
+
+    std::vector<Vertex> vertices_;
 
     std::vector<Texture> textures_;
+
+    std::vector<LevelOfDetail> lods_;
+
+    VertexLayout layout_ = VertexLayout::full;
+
+    glm::vec3 quantization_min_ = glm::vec3(0.0f);
+
+    glm::vec3 quantization_extent_ = glm::vec3(1.0f);
+
+    GLenum index_type_ = GL_UNSIGNED_INT;
 };
 
 #endif /* MESH_H */
@@ -13,38 +13,309 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 #include <assimp/scene.h>
 
 #include <GL/glew.h>
 
+#include <glm/glm.hpp>
+
+#include <opencv2/core/core.hpp>
+
 
 class Model
 {
 public:
+    /**
+     * Optimizations applied to the meshes when they are imported.
+     *
+     * - `weld_vertices` merges the vertices having the same position, normal and texture coordinates.
+     * - `optimize_vertex_cache` reorders triangles to improve the post-transform vertex cache hit rate.
+     * - `optimize_overdraw` reorders clusters of triangles so that outward-facing clusters are drawn first, reducing overdraw.
+     * - `vertex_cache_size` is the size of the post-transform vertex cache being optimized and simulated.
+     * - `lod_ratios` are the fractions of triangles, in (0, 1), kept by each coarser level of detail of the meshes.
+     *   Levels of detail are built by quadric error metric edge collapse and share the vertices of the original meshes.
+     *   Vertices on normal or texture coordinate seams are kept, hence meshes with many seams may keep more triangles than requested.
+     *
+     * All the optimizations are disabled by default, i.e. meshes are imported as they are stored in the file.
+     */
+    struct ImportProfile
+    {
+        bool weld_vertices = false;
+        bool optimize_vertex_cache = false;
+        bool optimize_overdraw = false;
+        unsigned int vertex_cache_size = 16;
+        std::vector<GLfloat> lod_ratios;
+    };
+
+    /**
+     * Number of vertices and Average Cache Miss Ratio (ACMR), i.e. the number of vertices transformed per triangle
+     * with a FIFO post-transform vertex cache, before and after applying an import profile.
+     */
+    struct ImportStatistics
+    {
+        size_t vertices_before = 0;
+        size_t vertices_after = 0;
+        float acmr_before = 0.0f;
+        float acmr_after = 0.0f;
+    };
+
+    /**
+     * A file stored in memory, e.g. downloaded by another component or embedded in the executable.
+     * Data are not copied and must remain valid while the model is being imported.
+     */
+    struct MemoryFile
+    {
+        const char* data;
+        size_t size;
+    };
+
+    /**
+     * A (path, file) container of files stored in memory, e.g. a mesh together with its material and texture files.
+     */
+    typedef std::unordered_map<std::string, MemoryFile> MemoryFileContainer;
+
     Model(const GLchar* path);
 
+    /**
+     * Import a model from file.
+     *
+     * Models are imported on the CPU only, so that they can be imported on any thread.
+     * The OpenGL objects are created when the model is uploaded, either explicitly or the first time it is drawn.
+     */
+    Model(const GLchar* path, const ImportProfile& profile);
+
+    /**
+     * Import a model whose mesh, material and texture files are looked up in `files` first, then in the filesystem.
+     * Relative paths referenced by the mesh file are resolved with respect to the directory of `path`, e.g.
+     * a mesh stored as `alien/alien.obj` referencing `alien.mtl` looks up for `alien/alien.mtl`.
+     * Textures embedded in the mesh file, e.g. in binary glTF files, are decoded as well.
+     */
+    Model(const GLchar* path, const MemoryFileContainer& files, const ImportProfile& profile);
+
+    /**
+     * Collect the files stored under `directory` of a `cmrc` embedded filesystem, to import models with
+     * `Model(path, files, profile)`. Paths of the collected files include `directory`.
+     */
+    template<typename EmbeddedFilesystem>
+    static MemoryFileContainer getEmbeddedFiles(const EmbeddedFilesystem& filesystem, const std::string& directory)
+    {
+        MemoryFileContainer files;
+
+        for (const auto& entry : filesystem.iterate_directory(directory))
+        {
+            std::string path = directory + "/" + entry.filename();
+
+            if (entry.is_file())
+            {
+                auto file = filesystem.open(path);
+                files[path] = MemoryFile{ file.begin(), static_cast<size_t>(file.size()) };
+            }
+            else
+            {
+                MemoryFileContainer subdirectory_files = getEmbeddedFiles(filesystem, path);
+                files.insert(subdirectory_files.begin(), subdirectory_files.end());
+            }
+        }
+
+        return files;
+    }
+
+    /**
+     * Returns true if the model has been successfully imported.
+     */
+    bool is_loaded() const;
+
+    /**
+     * Create the OpenGL textures, buffers and vertex arrays of the model. Does nothing if the model is already uploaded.
+     * Textures are shared with the other models through the `TextureCache`. Decoded texture images are freed once uploaded.
+     *
+     * @note The OpenGL context owning the model must be current.
+     */
+    void upload();
+
+    /**
+     * Create the OpenGL textures and buffers of the model, but not its vertex arrays, that cannot be shared among OpenGL contexts,
+     * e.g. to upload the model on a worker context sharing its objects with the one drawing the model, where `upload()` then
+     * only creates the vertex arrays. Does nothing if the textures and buffers are already uploaded.
+     *
+     * @note An OpenGL context sharing its objects with the one drawing the model must be current.
+     */
+    void uploadBuffers();
+
+    /**
+     * Delete the OpenGL objects of the model. The model cannot be drawn afterwards.
+     *
+     * @note The OpenGL context owning the model must be current.
+     */
+    void release();
+
+    bool isUploaded() const;
+
     void Draw(Shader shader);
 
+    /**
+     * Draw the `lod`-th level of detail of the model. Level 0 is the original model.
+     *
+     * If the shader has a `triangle_offset` uniform, `triangle_offset + gl_PrimitiveID` is the index of the triangle in the level of detail
+     * of the model, i.e. in the triangles of all its meshes, in the order they are imported, see `Model::getTrianglesNumber()`.
+     */
+    void Draw(Shader shader, const size_t lod);
+
     bool has_texture();
 
+    /**
+     * Returns the number of levels of detail, including the original model.
+     */
+    size_t getLevelsOfDetail() const;
+
+    /**
+     * Returns the geometric error of the `lod`-th level of detail in model units, i.e. an estimate of the
+     * maximum distance between the surface, hence the silhouette, of the level of detail and of the original model.
+     */
+    GLfloat getLevelOfDetailError(const size_t lod) const;
+
+    /**
+     * Returns the number of triangles of the `lod`-th level of detail.
+     */
+    size_t getTrianglesNumber(const size_t lod) const;
+
+    /**
+     * Returns the coarsest level of detail having a geometric error less than or equal to `max_error`, in model units.
+     */
+    size_t selectLevelOfDetail(const GLfloat max_error) const;
+
+    /**
+     * Axis-aligned bounding box and bounding sphere of the model, in model coordinates, computed at load time.
+     */
+    const glm::vec3& getBoundingBoxMin() const;
+
+    const glm::vec3& getBoundingBoxMax() const;
+
+    const glm::vec3& getBoundingSphereCenter() const;
+
+    GLfloat getBoundingSphereRadius() const;
+
+    /**
+     * Set the layout of the vertices of all the meshes of the model.
+     *
+     * @note The OpenGL context owning the model must be current.
+     *
+     * @note Textured models must be drawn with the `Mesh::VertexLayout::full` layout, while the position-only layouts
+     * can be used whenever the shader drawing the model reads only the vertex position.
+     */
+    void setVertexLayout(const Mesh::VertexLayout layout);
+
+    Mesh::VertexLayout getVertexLayout() const;
+
+    /**
+     * Returns the matrix mapping the vertices stored on the GPU to model coordinates.
+     *
+     * The matrix is the identity unless the `Mesh::VertexLayout::quantized_position` layout is used,
+     * in which case it must be applied before the model matrix, i.e. `model * getVertexTransform()`.
+     */
+    glm::mat4 getVertexTransform() const;
+
+    const ImportStatistics& getImportStatistics() const;
+
 protected:
-    void loadModel(std::string path);
+    /**
+     * Geometry of the submeshes sharing the same textures, to be packed in a single mesh.
+     */
+    struct MeshBatch
+    {
+        std::vector<Mesh::Vertex> vertices;
+        std::vector<GLuint> indices;
+        std::vector<Mesh::Texture> textures;
+        std::vector<Mesh::Submesh> submeshes;
+    };
+
+    void loadModel(std::string path, const MemoryFileContainer& files);
+
+    void processNode(aiNode* node, const aiScene* scene, std::vector<MeshBatch>& batches);
+
+    void processMesh(aiMesh* mesh, const aiScene* scene, std::vector<MeshBatch>& batches);
 
-    void processNode(aiNode* node, const aiScene* scene);
+    /**
+     * Sort the clusters of triangles of a mesh by decreasing distance of their centroid from the mesh centroid,
+     * measured along the cluster normal. Clusters are delimited where the vertex cache must be entirely refilled,
+     * so that the vertex cache locality of the current triangle order is mostly preserved.
+     */
+    void optimizeOverdraw(const std::vector<Mesh::Vertex>& vertices, std::vector<GLuint>& indices);
 
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
+    /**
+     * Returns the number of vertex cache misses when drawing `indices` with a FIFO cache.
+     */
+    size_t countCacheMisses(const GLuint* indices, const size_t num_indices, const size_t num_vertices);
 
-    GLint TextureFromFile(const char* path, std::string directory);
+    /**
+     * Build the levels of detail of all the meshes as specified by the import profile.
+     */
+    void buildLevelsOfDetail(const std::vector<MeshBatch>& batches);
 
-    std::vector<Mesh::Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+    /**
+     * Simplify a triangle mesh by quadric error metric edge collapse, where vertices are collapsed onto
+     * one of their neighbours. Vertices whose position is shared by vertices with different normals or texture coordinates,
+     * i.e. on a seam, are never removed. Returns, for each number of triangles in `target_triangles` (in decreasing order),
+     * the indices of the simplified mesh, referring to the input vertices. The square root of the maximum
+     * collapse cost, i.e. an estimate of the geometric error, is stored in `errors`.
+     */
+    std::vector<std::vector<GLuint>> simplifyMesh(const Mesh::Vertex* vertices, const size_t num_vertices, const GLuint* indices, const size_t num_indices, const std::vector<size_t>& target_triangles, std::vector<GLfloat>& errors);
+
+    /**
+     * Source of a texture, identified by its texture cache key. The texture is decoded at import time unless
+     * already cached; otherwise it is decoded at upload time, if needed, from its file or encoded content.
+     */
+    struct TextureSource
+    {
+        std::string key;
+        std::string path;
+        std::vector<char> encoded;
+        cv::Mat image;
+    };
+
+    TextureSource TextureFromFile(const char* path, std::string directory);
+
+    TextureSource TextureFromEmbedded(const aiTexture* texture);
+
+    cv::Mat decodeTexture(const TextureSource& source);
+
+    std::vector<Mesh::Texture> loadMaterialTextures(aiMaterial* mat, const aiScene* scene, aiTextureType type, std::string typeName);
 
 private:
+    ImportProfile profile_;
+
+    ImportStatistics statistics_;
+
     std::vector<Mesh> meshes_;
 
     std::string directory_;
 
+    /* Files stored in memory, valid while the model is being imported only. */
+    const MemoryFileContainer* files_ = nullptr;
+
     std::vector<Mesh::Texture> textures_loaded_;
+
+    std::vector<TextureSource> texture_sources_;
+
+    bool loaded_ = false;
+
+    bool buffers_uploaded_ = false;
+
+    bool uploaded_ = false;
+
+    Mesh::VertexLayout layout_ = Mesh::VertexLayout::full;
+
+    glm::vec3 aabb_min_ = glm::vec3(0.0f);
+
+    glm::vec3 aabb_max_ = glm::vec3(0.0f);
+
+    glm::vec3 sphere_center_ = glm::vec3(0.0f);
+
+    GLfloat sphere_radius_ = 0.0f;
+
+    std::vector<GLfloat> lod_errors_ = std::vector<GLfloat>(1, 0.0f);
 };
 
 #endif /* MODEL_H */
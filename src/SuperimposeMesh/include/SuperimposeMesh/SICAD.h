@@ -13,7 +13,13 @@
 #include "Model.h"
 #include "Shader.h"
 
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <utility>
@@ -44,6 +50,119 @@ public:
         linear
     };
 
+    enum class RenderMode
+    {
+        color,
+        depth
+    };
+
+    enum class PointCloudFrame
+    {
+        camera,
+        world
+    };
+
+    enum class PointCloudFormat
+    {
+        float32,
+        float16
+    };
+
+    enum class TensorLayout
+    {
+        nchw,
+        nhwc
+    };
+
+    enum class TensorFormat
+    {
+        float32,
+        float16
+    };
+
+    /**
+     * A tensor in a contiguous buffer owned by SICAD, e.g. to be wrapped by learning frameworks without copies.
+     * The buffer is valid until the next call to `SICAD::superimposeTensor()` or the destruction of SICAD.
+     */
+    struct Tensor
+    {
+        const void* data = nullptr;
+
+        TensorLayout layout = TensorLayout::nchw;
+
+        TensorFormat format = TensorFormat::float32;
+
+        /* Size of an element in bytes, i.e. 4 for float32 and 2 for float16 elements. */
+        size_t element_size = sizeof(GLfloat);
+
+        /* Sizes and strides, in elements, of the dimensions in layout order, i.e. (N, C, H, W) or (N, H, W, C). */
+        std::array<size_t, 4> shape = { { 0, 0, 0, 0 } };
+
+        std::array<size_t, 4> strides = { { 0, 0, 0, 0 } };
+    };
+
+    /**
+     * Statistics of a mesh model in a tile.
+     */
+    struct ObjectStatistics
+    {
+        /* Number of pixels where the mesh model is visible, i.e. not occluded nor outside the tile. */
+        GLuint visible_pixels = 0;
+
+        /* Bounding box of the visible pixels of the mesh model, in pixels from the upper-left corner of the tile. */
+        cv::Rect bounding_box;
+
+        /* Range of distances from the camera plane of the visible pixels of the mesh model. */
+        GLfloat min_depth = 0.0f;
+        GLfloat max_depth = 0.0f;
+    };
+
+    /**
+     * A rendered pixel and the point of the mesh model it comes from.
+     */
+    struct Correspondence
+    {
+        /* Tile, ordered as the poses of the multi-tile superimpose(). */
+        GLint tile;
+
+        /* Pixel column and row in the tile, from the upper-left corner. */
+        GLint u;
+        GLint v;
+
+        /* Instance ID of the mesh model, if written, 0 otherwise. See `SICAD::setInstanceIdOpt()`. */
+        GLuint instance_id;
+
+        /* Index of the triangle in the level of detail of the mesh model drawn in the tile, counted across all the meshes of the model
+           in import order, see `Model::Draw()` and `Model::getTrianglesNumber()`. */
+        GLuint triangle;
+
+        /* Point in model coordinates. */
+        glm::vec3 point;
+    };
+
+    /**
+     * The fastest render configuration found by `SICAD::calibrate()` on the current machine.
+     */
+    struct Calibration
+    {
+        /* Render grid. Its tiles are at least as many as the requested images, so that the PBO superimpose() methods accept them all. */
+        GLsizei tiles_cols = 0;
+        GLsizei tiles_rows = 0;
+
+        /* Rows of tiles rendered per pass by the multi-tile superimpose() reading back to cv::Mat. Batches smaller than the grid
+           render the requested images in multiple passes, reading back each pass while the next one renders. */
+        GLsizei batch_rows = 0;
+
+        /* Whether reading back to a PBO, rather than to cv::Mat, is faster. */
+        bool pbo_readback = false;
+
+        /* Number of PBOs cycled by the readback: those of the multi-pass readback to cv::Mat, or those to cycle with PBO readback. */
+        size_t pbo_depth = 0;
+
+        /* Measured throughput. */
+        double images_per_second = 0.0;
+    };
+
     /**
      * Create a SICAD object with a dedicated OpenGL context and default shaders.
      *
@@ -150,6 +269,50 @@ public:
      */
     SICAD(const ModelPathContainer& objfile_map, const GLsizei cam_width, const GLsizei cam_height, const GLfloat cam_fx, const GLfloat cam_fy, const GLfloat cam_cx, const GLfloat cam_cy, const GLint num_images, const std::string& shader_folder, const std::vector<float>& ogl_to_cam);
 
+    /**
+     * Create a SICAD object with a dedicated OpenGL context, custom shaders and a custom import profile for mesh models.
+     *
+     * The mesh models are optimized, when imported, according to `import_profile`. Refer to `Model::ImportProfile`
+     * for the available optimizations. The number of vertices and the vertex cache Average Cache Miss Ratio (ACMR),
+     * before and after the optimizations, are reported on the standard output for each model.
+     *
+     * Refer to the other constructors for the remaining parameters. To use the default shaders, set `shader_folder` to `"__prc/shader"`.
+     *
+     * @param objfile_map A (tag, path) container to associate a 'tag' to the mesh file specified in 'path'.
+     * @param cam_width Camera or image width.
+     * @param cam_height Camera or image height.
+     * @param cam_fx focal Length along the x axis in pixels.
+     * @param cam_fy focal Length along the y axis in pixels.
+     * @param num_images Number of images (i.e. viewports) rendered in the same GL context.
+     * @param shader_folder Path to the folder containing the required shaders.
+     * @param ogl_to_cam A 7-component pose vector, (x, y, z) position and a (ux, uy, uz, theta) axis-angle orientation, defining a camera rotation applied to the OpenGL camera.
+     * @param import_profile Optimizations applied to the mesh models when they are imported.
+     */
+    SICAD(const ModelPathContainer& objfile_map, const GLsizei cam_width, const GLsizei cam_height, const GLfloat cam_fx, const GLfloat cam_fy, const GLfloat cam_cx, const GLfloat cam_cy, const GLint num_images, const std::string& shader_folder, const std::vector<float>& ogl_to_cam, const Model::ImportProfile& import_profile);
+
+    /**
+     * Create a SICAD object with a dedicated OpenGL context, custom shaders, a custom import profile for mesh models
+     * and mesh models stored in memory.
+     *
+     * The paths in `objfile_map`, as well as the material and texture files they reference, are looked up in `model_files`
+     * first, then in the filesystem, so that mesh models can be served from memory buffers or from a `cmrc` resource library
+     * (see `Model::getEmbeddedFiles()`) without any file I/O. `model_files` is used during construction only.
+     *
+     * Refer to the other constructors for the remaining parameters. To use the default shaders, set `shader_folder` to `"__prc/shader"`.
+     *
+     * @param objfile_map A (tag, path) container to associate a 'tag' to the mesh file specified in 'path'.
+     * @param cam_width Camera or image width.
+     * @param cam_height Camera or image height.
+     * @param cam_fx focal Length along the x axis in pixels.
+     * @param cam_fy focal Length along the y axis in pixels.
+     * @param num_images Number of images (i.e. viewports) rendered in the same GL context.
+     * @param shader_folder Path to the folder containing the required shaders.
+     * @param ogl_to_cam A 7-component pose vector, (x, y, z) position and a (ux, uy, uz, theta) axis-angle orientation, defining a camera rotation applied to the OpenGL camera.
+     * @param import_profile Optimizations applied to the mesh models when they are imported.
+     * @param model_files A (path, file) container of mesh, material and texture files stored in memory.
+     */
+    SICAD(const ModelPathContainer& objfile_map, const GLsizei cam_width, const GLsizei cam_height, const GLfloat cam_fx, const GLfloat cam_fy, const GLfloat cam_cx, const GLfloat cam_cy, const GLint num_images, const std::string& shader_folder, const std::vector<float>& ogl_to_cam, const Model::ImportProfile& import_profile, const Model::MemoryFileContainer& model_files);
+
     virtual ~SICAD();
 
     bool getOglWindowShouldClose();
@@ -180,6 +343,11 @@ public:
      *
      * @note The size of the grid representing the tiled viewports can be accessed through `getTilesRows()` and `getTilesCols()`.
      *
+     * @note `objpos_multimap` may hold any number of poses. The image always has `getTilesCols()` columns of tiles and as many rows
+     * as needed, in the order of `objpos_multimap`: smaller batches render and read back the rows in use only, while larger batches are
+     * rendered in multiple passes whose readback is pipelined with the rendering of the next pass. Unused tiles of the last row are blank.
+     * Instance IDs, correspondences and point clouds require a batch fitting the render grid.
+     *
      * @note If cv::Mat `img` is a background image it must be of size `cam_width * cam_height`, as specified during object construction,
      * and the `SICAD::setBackgroundOpt(bool show_background)` must have been invoked with `true`.
      *
@@ -244,6 +412,9 @@ public:
      *
      * @note The size of the grid representing the tiled viewports can be accessed through `getTilesRows()` and `getTilesCols()`.
      *
+     * @note `objpos_multimap` may hold up to `getTilesNumber()` poses. Only the rows of tiles in use are stored, starting from the
+     * beginning of the PBO.
+     *
      * @param objpos_map A (tag, pose) container to associate a 7-component `pose`, (x, y, z) position and a (ux, uy, uz, theta) axis-angle orientation, to a mesh with tag 'tag'.
      * @param cam_x (x, y, z) position.
      * @param cam_o (ux, uy, uz, theta) axis-angle orientation.
@@ -261,6 +432,9 @@ public:
      *
      * @note The size of the grid representing the tiled viewports can be accessed through `getTilesRows()` and `getTilesCols()`.
      *
+     * @note `objpos_multimap` may hold up to `getTilesNumber()` poses. Only the rows of tiles in use are stored, starting from the
+     * beginning of the PBO.
+     *
      * @note `img` must be of size `cam_width * cam_height`, as specified during object construction, and the
      * `SICAD::setBackgroundOpt(bool show_background)` must have been invoked with `true`.
      *
@@ -305,6 +479,61 @@ public:
      */
     std::pair<bool, GLuint> getPBO(const size_t pbo_index) const;
 
+    /**
+     * Lay out the render grid anew for `num_images` images of size `cam_width * cam_height`, keeping models, textures,
+     * shaders and options. Framebuffer attachments and PBOs are reallocated only when they grow, so that smaller grids and
+     * image sizes reuse their storage.
+     *
+     * @note The projection is kept, i.e. the intrinsic parameters are meant to scale with the image size.
+     * Use `setProjectionMatrix()` to render with a different camera.
+     *
+     * @param num_images Number of images, i.e. tiles, to render in a single pass.
+     * @param cam_width Image width.
+     * @param cam_height Image height.
+     *
+     * @return true upon success, false otherswise.
+     */
+    bool resize(const GLint num_images, const GLsizei cam_width, const GLsizei cam_height);
+
+    /**
+     * Set the file where `SICAD::calibrate()` stores its results. SICAD objects constructed afterwards look for the configuration
+     * calibrated with the same renderer, image size and number of images, and use its render grid in place of the default one.
+     *
+     * @param calibration_file Path to the calibration file. An empty path disables the persistence of the calibration (default).
+     */
+    static void setCalibrationFile(const std::string& calibration_file);
+
+    /**
+     * Benchmark candidate configurations, rendering the mesh models in `objpos_map` once per requested image:
+     * render grids with at least as many tiles as the requested images, batch sizes of a whole, a half and a quarter of the grid rows,
+     * readback to cv::Mat and to PBOs, and the number of PBOs cycled by the readback.
+     * The fastest configuration is then used by this object, also after `SICAD::resize()` back to the same configuration,
+     * and stored in the calibration file, if any, for the later constructions. See `SICAD::setCalibrationFile()`.
+     *
+     * @note The render grid, the batch size and the number of PBOs of the multi-pass readback are applied by SICAD. The readback format,
+     * and the number of PBOs to cycle with PBO readback, depend on the superimpose() method called, hence are only reported by
+     * `SICAD::getCalibration()` for the caller to follow.
+     *
+     * @note Batches smaller than the render grid are benchmarked without instance IDs, correspondences and point clouds only,
+     * and are used with none of them, nor ROIs and the render cache, enabled. PBO readback is benchmarked with batches of the whole grid only.
+     *
+     * @note Calibration takes a few rendering passes per candidate configuration, hence it is meant to be run once per machine.
+     * The render cache and ROIs are disabled while benchmarking.
+     *
+     * @param objpos_map A (tag, pose) container with representative mesh models and poses.
+     * @param cam_x (x, y, z) position.
+     * @param cam_o (ux, uy, uz, theta) axis-angle orientation.
+     *
+     * @return true upon success, false otherswise.
+     */
+    bool calibrate(const ModelPoseContainer& objpos_map, const double* cam_x, const double* cam_o);
+
+    /**
+     * Returns the configuration found by `SICAD::calibrate()`, or read from the calibration file at construction.
+     * All values are 0 if none is available.
+     */
+    const Calibration& getCalibration() const;
+
     bool setProjectionMatrix(const GLsizei cam_width, const GLsizei cam_height, const GLfloat cam_fx, const GLfloat cam_fy, const GLfloat cam_cx, const GLfloat cam_cy);
 
     bool getBackgroundOpt() const;
@@ -319,12 +548,400 @@ public:
 
     MIPMaps getMipmapsOpt() const;
 
+    /**
+     * Store the vertex positions of untextured mesh models as 16-bit normalized integers, i.e. 8 bytes per vertex,
+     * instead of 32-bit floating point numbers.
+     * Positions are quantized within the model bounding box and dequantized in the vertex shader by means of the model matrix.
+     *
+     * @note Quantization is applied only if the mesh model shader reads the vertex position only, as the default one does.
+     * Quantization introduces an error up to 1/131070 of the model bounding box size along each axis.
+     *
+     * @note The OpenGL context current when calling this method is current again on return.
+     *
+     * @param quantize_vertices true to quantize vertex positions, false to use floating point positions (default).
+     */
+    void setVertexQuantizationOpt(bool quantize_vertices);
+
+    bool getVertexQuantizationOpt() const;
+
+    /**
+     * Set the maximum silhouette error, in pixels, allowed when drawing a coarser level of detail of a mesh model.
+     * The level of detail is selected per object and per tile from the radius of the model bounding sphere projected on the tile.
+     * Levels of detail are built at load time according to `Model::ImportProfile::lod_ratios`.
+     *
+     * @param max_pixel_error maximum silhouette error in pixels. Default is 1 pixel, 0 always draws the original models.
+     */
+    void setLevelOfDetailErrorOpt(const GLfloat max_pixel_error);
+
+    GLfloat getLevelOfDetailErrorOpt() const;
+
+    /**
+     * Set what superimpose() renders and reads back.
+     *
+     * In `RenderMode::color` mode (default), superimpose() renders and reads back the color of the mesh models, as a CV_8UC3 BGR image.
+     * In `RenderMode::depth` mode, color writes are disabled and the mesh models are rendered by an empty fragment shader,
+     * so that only the depth buffer is written. The background is not drawn and superimpose() returns a CV_32FC1 image
+     * with the distance of each pixel from the camera plane, or 0 if no model is drawn in the pixel.
+     * PBOs are reallocated to store one float per pixel with the depth in window coordinates, i.e. in [0, 1].
+     *
+     * @note Changing mode invalidates the content of the PBOs and may upload the vertices of the mesh models again.
+     *
+     * @return true upon success, false if the depth-only shader could not be created. In the latter case the mode is not changed.
+     */
+    bool setRenderModeOpt(const RenderMode& render_mode);
+
+    RenderMode getRenderModeOpt() const;
+
+    /**
+     * Write the instance ID of the mesh models to an additional 16-bit unsigned integer attachment of the framebuffer,
+     * in the same rendering pass of color or depth.
+     *
+     * The instance ID of a mesh model is its 1-based position in the iteration order of the `ModelPoseContainer` of its tile,
+     * i.e. sorted by tag and then by insertion order, 0 being the background. Reference frames and the background have ID 0.
+     * Mesh models are drawn by the built-in mesh model shader, instead of the ones in the shader folder.
+     *
+     * @note Instance IDs are read back to memory by every superimpose() call, including the ones storing pixels in PBOs.
+     *
+     * @return true upon success, false if the shader programs could not be created. In the latter case the option is not changed.
+     */
+    bool setInstanceIdOpt(const bool write_instance_id);
+
+    bool getInstanceIdOpt() const;
+
+    /**
+     * Returns the CV_16UC1 instance ID image read by the last call to superimpose(), with the same size of the rendered image.
+     * Returns an empty image if `SICAD::setInstanceIdOpt()` has not been invoked with `true`.
+     */
+    const cv::Mat& getInstanceIdImage() const;
+
+    /**
+     * Returns, for each tile of the last call to superimpose(), the number of visible pixels of each instance ID.
+     * The element 0 counts the background pixels. Tiles are ordered as the poses of the multi-tile superimpose().
+     */
+    const std::vector<std::vector<size_t>>& getInstancePixelCounts() const;
+
+    /**
+     * Write, for each pixel, the triangle and the point in model coordinates the pixel comes from to an additional
+     * 32-bit unsigned integer RGBA attachment of the framebuffer, in the same rendering pass of color or depth.
+     * Points are interpolated by the rasterizer, i.e. they are the barycentric combination of the triangle vertices.
+     * Mesh models are drawn by the built-in mesh model shader, instead of the ones in the shader folder.
+     *
+     * @note Correspondences are read back to memory by every superimpose() call, including the ones storing pixels in PBOs.
+     *
+     * @return true upon success, false if the shader programs could not be created. In the latter case the option is not changed.
+     */
+    bool setCorrespondenceOpt(const bool write_correspondences);
+
+    bool getCorrespondenceOpt() const;
+
+    /**
+     * Returns the correspondences of the foreground pixels, i.e. the ones where a mesh model has been drawn,
+     * read by the last call to superimpose(). Pixels are ordered by row and column of the rendered image.
+     */
+    const std::vector<Correspondence>& getCorrespondences() const;
+
+    /**
+     * Write, for each pixel, the point of the mesh models it comes from to an additional floating point attachment of the framebuffer,
+     * in the same rendering pass of color or depth. Points are computed on the GPU and read back on demand by `SICAD::getPointCloud()`.
+     * Mesh models are drawn by the built-in mesh model shader, instead of the ones in the shader folder.
+     *
+     * @param write_point_cloud true to write point clouds.
+     * @param frame `PointCloudFrame::camera` for points in the camera frame, i.e. the one given by `cam_x` and `cam_o`,
+     *              or `PointCloudFrame::world` for points in the frame where `cam_x`, `cam_o` and the mesh model poses are expressed.
+     * @param format `PointCloudFormat::float32` for single precision coordinates, `PointCloudFormat::float16` for half precision ones.
+     *
+     * @return true upon success, false if the shader programs could not be created. In the latter case the option is not changed.
+     */
+    bool setPointCloudOpt(const bool write_point_cloud, const PointCloudFrame& frame, const PointCloudFormat& format);
+
+    bool getPointCloudOpt() const;
+
+    PointCloudFrame getPointCloudFrameOpt() const;
+
+    PointCloudFormat getPointCloudFormatOpt() const;
+
+    /**
+     * Copy the point cloud of the `tile`-th tile rendered by the last call to superimpose() into `points`.
+     *
+     * Each point has 3 coordinates, in the format set by `SICAD::setPointCloudOpt()`, and starts `point_stride` bytes after the previous one,
+     * so that points can be written directly in buffers with interleaved fields, e.g. (x, y, z, padding, rgb, ...).
+     * Organized point clouds have one point per pixel, row by row from the upper-left corner, and NaN coordinates where no model has been drawn.
+     * Compact point clouds have the valid points only, in the same order.
+     *
+     * @param tile The tile index, ordered as the poses of the multi-tile superimpose().
+     * @param points The buffer, at least `point_stride` times the number of pixels of a tile bytes long.
+     * @param point_stride Bytes between the beginning of two consecutive points, at least the size of 3 coordinates.
+     * @param compact true to copy the valid points only, false to copy an organized point cloud.
+     * @param points_number Set to the number of points copied.
+     *
+     * @return true upon success, false otherwise.
+     */
+    bool getPointCloud(const size_t tile, void* points, const size_t point_stride, const bool compact, size_t& points_number);
+
+    /**
+     * Measure the statistics of each mesh model in each tile during superimpose().
+     *
+     * Visible pixels are counted by `GL_SAMPLES_PASSED` occlusion queries: after each tile is drawn, each mesh model inside
+     * the view frustum is drawn again, with color and depth writes disabled, where its depth equals the one of the tile.
+     * Bounding boxes and depth ranges are reduced on the GPU from the instance IDs and the depth of the rendered tiles,
+     * blending the pixels of each mesh model into a small texture with min blending by a single draw call per pass over the render grid.
+     * The texture and the queries are read back once per superimpose() call.
+     *
+     * @note Statistics cost a second draw of each mesh model and the instance ID attachment, that is written even if
+     * `SICAD::setInstanceIdOpt()` is disabled.
+     *
+     * @note Combine with `SICAD::setReadbackOpt(false)` to gate hypotheses before paying for the readback of the rendered images.
+     *
+     * @return true upon success, false otherwise.
+     */
+    bool setStatisticsOpt(const bool measure_statistics);
+
+    bool getStatisticsOpt() const;
+
+    /**
+     * Returns, for each tile of the last call to superimpose(), the statistics of each mesh model, ordered as in the
+     * `ModelPoseContainer` of the tile, i.e. as the instance IDs. Models that are not visible have all statistics set to 0.
+     * Single-tile superimpose() calls report the statistics of the first tile only.
+     */
+    const std::vector<std::vector<ObjectStatistics>>& getStatistics() const;
+
+    /**
+     * Set whether superimpose() reads back the rendered images, in memory or in PBOs, the instance IDs and the correspondences.
+     * When disabled the framebuffer can still be read afterwards, e.g. by `SICAD::getPointCloud()`, until the next superimpose() call.
+     *
+     * @param read_back true to read back the rendered images (default), false otherwise.
+     */
+    void setReadbackOpt(const bool read_back);
+
+    bool getReadbackOpt() const;
+
+    /**
+     * Set whether the multi-tile superimpose() returning a cv::Mat reuses the tiles of its previous call. Each tile is identified by
+     * its camera and mesh model poses, quantized to `resolution`. Tiles unchanged since the previous call are kept in the framebuffer,
+     * tiles of the previous call at a different position are copied on the GPU from a layer holding the previous render grid,
+     * duplicates in the batch are rendered once and copied, and only the remaining tiles are rendered. The render grid is then
+     * read back at once.
+     *
+     * Tiles whose quantized poses hash to the same key are compared pose by pose, so that a hash collision never returns the tile of a different pose.
+     *
+     * @note Changes of the projection, of the render mode, of the auxiliary outputs, of the background, wireframe, mipmaps, vertex quantization
+     * and level of detail options, of the tile size, of the mesh models and of the static scene invalidate the cache.
+     * Call `SICAD::clearRenderCache()` after changing anything else affecting the rendering, e.g. a shader.
+     * The cache is not used with background images, ROIs, statistics, instance IDs, correspondences, point clouds and without readback.
+     *
+     * @param cache true to enable the cache, false otherwise (default).
+     * @param resolution Quantization of positions and axis-angle components. Default is 1e-6.
+     */
+    void setRenderCacheOpt(const bool cache, const double resolution);
+
+    bool getRenderCacheOpt() const;
+
+    double getRenderCacheResolutionOpt() const;
+
+    void clearRenderCache();
+
+    /**
+     * Returns the number of tiles rendered by the last call to the multi-tile superimpose(), i.e. the batch size unless the render cache is used.
+     */
+    size_t getRenderedTilesNumber() const;
+
+    /**
+     * Set the mesh models shared by all the tiles, in the same pose, e.g. a table or a robot arm held still.
+     * They are rendered once in a cached layer that is copied in every tile before drawing the mesh models of the tile on top,
+     * and rendered again only when the camera, the projection, their poses or the mesh models change.
+     *
+     * @note The cached layer is not used with background images, instance IDs, statistics, correspondences and point clouds: static mesh models
+     * are then drawn in each tile. Static mesh models have instance ID 0, are not measured by statistics and do not enter ROIs.
+     *
+     * @param objpos_map A (tag, pose) container of the static mesh models. Empty to disable the static scene (default).
+     */
+    void setStaticModels(const ModelPoseContainer& objpos_map);
+
+    const ModelPoseContainer& getStaticModels() const;
+
+    /**
+     * Set whether the superimpose() calls returning a cv::Mat clear, draw and read back only the region of interest (ROI) of each tile,
+     * i.e. the rectangle enclosing the projected bounding boxes of its mesh models. The image is then an atlas of the ROIs, packed
+     * left to right on rows as wide as the render grid, and the ROI of a single tile for the single-tile superimpose(),
+     * unless packing is disabled by `SICAD::setRoiPackingOpt()`. Tiles with reference frames take the whole tile.
+     *
+     * The ROIs are read back to a PBO one after the other, so that the GPU is waited for once per call rather than once per ROI.
+     *
+     * @note ROIs require batches fitting the render grid, and are not available with instance IDs, correspondences and point clouds.
+     * PBO readbacks are not affected.
+     *
+     * @param roi true to render and read back the ROIs only, false otherwise (default).
+     */
+    void setRoiOpt(const bool roi);
+
+    bool getRoiOpt() const;
+
+    /**
+     * Returns, for each tile of the last call to superimpose() with ROIs enabled, its ROI in image coordinates from the upper-left
+     * corner of the tile. Empty ROIs contain no mesh model.
+     */
+    const std::vector<cv::Rect>& getRois() const;
+
+    /**
+     * Returns, for each tile of the last call to superimpose() with ROIs enabled, the position of its ROI in the image. Empty ROIs are not stored.
+     */
+    const std::vector<cv::Rect>& getRoiAtlas() const;
+
+    /**
+     * Set whether the ROIs are packed in an atlas (default). Otherwise the image is laid out as without ROIs, with the ROIs in place
+     * and the pixels outside them set to 0, so that no ROI moves, at the cost of allocating and zeroing the whole image.
+     */
+    void setRoiPackingOpt(const bool pack);
+
+    bool getRoiPackingOpt() const;
+
+    /**
+     * Returns, for each tile of the last call to superimpose() with ROIs enabled, the image of its ROI, sharing the pixels of the returned image.
+     * Empty ROIs have empty images.
+     */
+    const std::vector<cv::Mat>& getRoiImages() const;
+
+    /**
+     * Render the tiles of the next superimpose() calls at `scale` times the image size, keeping the number of tiles and the field of view,
+     * i.e. the intrinsic parameters are scaled with the image size. Images, statistics, instance IDs and correspondences
+     * are then in scaled pixels.
+     *
+     * @note The static layer, see `SICAD::setStaticModels()`, and the render cache of each scale are kept, so that switching back to a scale reuses them.
+     *
+     * @param scale Resolution scale in (0, 1]. Default is 1.
+     *
+     * @return true upon success, false otherwise.
+     */
+    bool setResolutionScaleOpt(const GLfloat scale);
+
+    GLfloat getResolutionScaleOpt() const;
+
+    /**
+     * Render `objpos_multimap` at a coarse resolution, let `select` pick the hypotheses worth the full resolution, and render
+     * those only at the current resolution scale. `select` receives the coarse image, tiled as in the multi-tile superimpose(),
+     * and may also query `SICAD::getStatistics()` and `SICAD::getEmptyTiles()`, that refer to the coarse level while it runs.
+     * Each level keeps its own static layer and render cache across calls.
+     *
+     * @param objpos_multimap The hypotheses, see the multi-tile superimpose().
+     * @param cam_x (x, y, z) position.
+     * @param cam_o (ux, uy, uz, theta) axis-angle orientation.
+     * @param scale Resolution scale of the coarse level, in (0, `SICAD::getResolutionScaleOpt()`).
+     * @param select Returns the indices of the hypotheses of `objpos_multimap` to render at full resolution, e.g. the top-K ones.
+     * @param img The full resolution images of the selected hypotheses, tiled in the order of `selected`. Released if none is selected.
+     * @param selected The indices returned by `select`.
+     *
+     * @return true upon success, false otherwise.
+     */
+    bool superimposeCascade(const std::vector<ModelPoseContainer>& objpos_multimap, const double* cam_x, const double* cam_o, const GLfloat scale,
+                            const std::function<std::vector<size_t>(const cv::Mat&)>& select, cv::Mat& img, std::vector<size_t>& selected);
+
+    /**
+     * Set the tensor written by `SICAD::superimposeTensor()`. Each element is `(color - mean) / std_dev`, with colors in [0, 1] and
+     * channels in RGB order.
+     *
+     * @param layout `TensorLayout::nchw` (default) or `TensorLayout::nhwc`.
+     * @param format `TensorFormat::float32` (default) or `TensorFormat::float16`.
+     * @param mean Per-channel mean, in RGB order. Default is 0.
+     * @param std_dev Per-channel standard deviation, in RGB order. Default is 1.
+     *
+     * @return true upon success, false if a standard deviation is 0. In the latter case the options are not changed.
+     */
+    bool setTensorOpt(const TensorLayout& layout, const TensorFormat& format, const std::array<GLfloat, 3>& mean, const std::array<GLfloat, 3>& std_dev);
+
+    TensorLayout getTensorLayoutOpt() const;
+
+    TensorFormat getTensorFormatOpt() const;
+
+    const std::array<GLfloat, 3>& getTensorMeanOpt() const;
+
+    const std::array<GLfloat, 3>& getTensorStdOpt() const;
+
+    /**
+     * Render `objpos_multimap` as the multi-tile superimpose(), and write the tiles as a tensor of `objpos_multimap.size()` images,
+     * with the layout, format and normalization set by `SICAD::setTensorOpt()`. Tiles are flipped, normalized, converted and
+     * reordered on the GPU, so that the tensor is read back as is, with no further pass on the CPU.
+     *
+     * @note Tensors require `RenderMode::color`. The background is not drawn, and instance IDs, correspondences and point clouds
+     * are not read back. Batches larger than the render grid are rendered in multiple passes.
+     *
+     * @param objpos_multimap The hypotheses, see the multi-tile superimpose().
+     * @param cam_x (x, y, z) position.
+     * @param cam_o (ux, uy, uz, theta) axis-angle orientation.
+     * @param tensor The tensor, pointing to a buffer owned by SICAD.
+     *
+     * @return true upon success, false otherwise.
+     */
+    bool superimposeTensor(const std::vector<ModelPoseContainer>& objpos_multimap, const double* cam_x, const double* cam_o, Tensor& tensor);
+
+    /**
+     * Returns the silhouette error, in model units, of each level of detail of a mesh model. Level 0 is the original model.
+     * Returns an empty vector if the mesh model does not exist.
+     */
+    std::vector<GLfloat> getLevelOfDetailErrors(const std::string& mesh_id) const;
+
+    /**
+     * Add a mesh model, or replace an existing one, at runtime.
+     *
+     * The model is imported asynchronously on a separate thread, that also uploads its textures and buffers on a hidden OpenGL context
+     * sharing its objects with the rendering one. The model is swapped in at the beginning of the next superimpose() call, that only
+     * waits, on the GPU, for the upload to complete and creates the vertex arrays of the model, which cannot be shared among contexts.
+     * All the updates completed before a superimpose() call take effect together, so that no frame is rendered with a partially updated model set.
+     * If several updates of the same model are requested, only the last one takes effect.
+     *
+     * @note This method is thread-safe.
+     *
+     * @param mesh_id The model tag.
+     * @param path The mesh file path.
+     *
+     * @return A future that is set to true when the model is imported and ready to be swapped in,
+     *         or to false if the import failed or has been superseded by a later update of the same model.
+     */
+    std::shared_future<bool> updateModel(const std::string& mesh_id, const std::string& path);
+
+    /**
+     * Add a mesh model, or replace an existing one, at runtime, looking up its files in `files` first, then in the filesystem.
+     *
+     * @note The data of `files` must remain valid until the returned future is ready.
+     */
+    std::shared_future<bool> updateModel(const std::string& mesh_id, const std::string& path, const Model::MemoryFileContainer& files);
+
+    /**
+     * Remove a mesh model at runtime. The model is removed, and its OpenGL resources deleted, at the beginning
+     * of the next superimpose() call. Pending updates of the same model are discarded.
+     *
+     * @note This method is thread-safe.
+     */
+    void removeModel(const std::string& mesh_id);
+
+    /**
+     * Returns true if the model is used by superimpose(). Models added with updateModel() are not used
+     * until they are swapped in.
+     *
+     * @note This method is thread-safe.
+     */
+    bool hasModel(const std::string& mesh_id);
+
+    /**
+     * Returns, for each tile of the last call to superimpose(), whether no model has been drawn in the tile,
+     * e.g. because all the models lie outside the view frustum. Tiles are ordered as the poses of the multi-tile superimpose().
+     * Single-tile superimpose() calls report all tiles but the first one as empty.
+     *
+     * @note Empty tiles contain the background only, so that callers can skip their processing.
+     */
+    const std::vector<bool>& getEmptyTiles() const;
+
     int getTilesNumber() const;
 
     int getTilesRows() const;
 
     int getTilesCols() const;
 
+    /**
+     * Returns the size of the tiles of the images rendered by superimpose(). It differs from the camera image size
+     * with a resolution scale other than 1, see `SICAD::setResolutionScaleOpt()`, or on HDPI displays.
+     */
+    cv::Size getTileSize() const;
+
 /* FIXME
  * Change pointer with smartpointers.
  */
@@ -333,16 +950,34 @@ private:
 
     static GLsizei renderbuffer_size_;
 
+    /* Window whose context shares its objects, e.g. the textures of the TextureCache, with all the other contexts. */
+    static GLFWwindow* shared_window_;
+
+    static std::string calibration_file_;
+
     const std::string log_ID_ = "[SI::SICAD]";
 
     GLFWwindow* window_ = nullptr;
 
+    /* Hidden window whose context shares its objects with the one of window_, where the import threads upload the updated models. */
+    GLFWwindow* upload_window_ = nullptr;
+
+    /* The upload context is current on one import thread at a time. */
+    std::mutex upload_mutex_;
+
     GLint tiles_num_ = 0;
 
     GLsizei tiles_cols_ = 0;
 
     GLsizei tiles_rows_ = 0;
 
+    GLint requested_images_ = 0;
+
+    Calibration calibration_;
+
+    /* Rows of tiles rendered per pass by the multi-tile superimpose() reading back to cv::Mat, 0 for the whole render grid. */
+    GLsizei batch_rows_ = 0;
+
     GLsizei image_width_ = 0;
 
     GLsizei image_height_ = 0;
@@ -357,6 +992,10 @@ private:
 
     GLsizei tile_img_height_ = 0;
 
+    GLsizei attachment_width_ = 0;
+
+    GLsizei attachment_height_ = 0;
+
     const GLfloat near_ = 0.001f;
 
     const GLfloat far_ = 1000.0f;
@@ -369,6 +1008,259 @@ private:
 
     MIPMaps mesh_mmaps_ = MIPMaps::nearest;
 
+    Model::ImportProfile import_profile_;
+
+    bool vertex_quantization_ = false;
+
+    GLfloat lod_error_threshold_ = 1.0f;
+
+    RenderMode render_mode_ = RenderMode::color;
+
+    bool instance_id_ = false;
+
+    cv::Mat instance_ids_;
+
+    std::vector<std::vector<size_t>> instance_pixel_counts_;
+
+    bool correspondence_ = false;
+
+    std::vector<Correspondence> correspondences_;
+
+    bool point_cloud_ = false;
+
+    PointCloudFrame point_cloud_frame_ = PointCloudFrame::camera;
+
+    PointCloudFormat point_cloud_format_ = PointCloudFormat::float32;
+
+    bool statistics_ = false;
+
+    std::vector<std::vector<ObjectStatistics>> object_statistics_;
+
+    /**
+     * A rendered tile whose statistics are reduced, or are still to be reduced, to the statistics texture:
+     * its position in the render grid, its index in the batch, the region reduced, in pixels from the upper-left corner of the tile,
+     * the number of mesh models, the offset of its first mesh model in the statistics texture and the occlusion query of each
+     * mesh model inside the view frustum, with the position of the mesh model in the tile.
+     */
+    struct StatisticsTile
+    {
+        size_t tile;
+
+        size_t index;
+
+        cv::Rect region;
+
+        size_t objects;
+
+        size_t offset;
+
+        std::vector<std::pair<size_t, GLuint>> queries;
+    };
+
+    std::vector<StatisticsTile> statistics_tiles_;
+
+    /* Number of the tiles, and of their mesh models, already reduced to the statistics texture. */
+    size_t statistics_tiles_reduced_ = 0;
+
+    size_t statistics_entries_ = 0;
+
+    std::unique_ptr<Shader> statistics_shader_;
+
+    GLuint statistics_fbo_ = 0;
+
+    /* Occlusion queries counting visible pixels, reused across calls, and the number of those in use. */
+    std::vector<GLuint> queries_;
+
+    size_t queries_used_ = 0;
+
+    /* Textures storing, for each mesh model, (min u, min v, -max u, -max v) and (min depth, -max depth, unused, unused). */
+    GLuint texture_statistics_[2] = { 0, 0 };
+
+    GLuint vao_statistics_ = 0;
+
+    /* Number of mesh models per row of the statistics textures. */
+    GLsizei statistics_width_ = 256;
+
+    GLsizei statistics_height_ = 0;
+
+    bool readback_ = true;
+
+    GLfloat resolution_scale_ = 1.0f;
+
+    bool roi_ = false;
+
+    std::vector<cv::Rect> rois_;
+
+    std::vector<cv::Rect> roi_atlas_;
+
+    bool roi_packing_ = true;
+
+    std::vector<cv::Mat> roi_images_;
+
+    ModelPoseContainer static_objpos_map_;
+
+    GLuint static_fbo_ = 0;
+
+    GLuint texture_static_color_ = 0;
+
+    GLuint texture_static_depth_ = 0;
+
+    GLsizei static_width_ = 0;
+
+    GLsizei static_height_ = 0;
+
+    bool static_scene_valid_ = false;
+
+    bool static_scene_in_use_ = false;
+
+    glm::mat4 static_view_;
+
+    glm::mat4 static_projection_;
+
+    RenderMode static_render_mode_ = RenderMode::color;
+
+    GLenum static_mesh_mode_ = GL_FILL;
+
+    bool render_cache_ = false;
+
+    double render_cache_resolution_ = 1e-6;
+
+    /**
+     * The quantized camera and model poses of a tile, and their hash. Keys having the same hash are compared
+     * element-wise, so that hash collisions never return the tile of a different pose.
+     */
+    struct RenderCacheKey
+    {
+        std::vector<std::string> tags;
+
+        std::vector<long long> values;
+
+        size_t hash = 0;
+
+        bool operator==(const RenderCacheKey& other) const
+        {
+            return hash == other.hash && values == other.values && tags == other.tags;
+        }
+    };
+
+    struct RenderCacheKeyHash
+    {
+        size_t operator()(const RenderCacheKey& key) const
+        {
+            return key.hash;
+        }
+    };
+
+    std::vector<RenderCacheKey> render_cache_keys_;
+
+    std::vector<bool> render_cache_empty_tiles_;
+
+    /* Layer holding the render grid of the previous call, as large as the framebuffer and with the same formats, as required to blit it. */
+    GLuint render_cache_fbo_ = 0;
+
+    GLuint texture_render_cache_color_ = 0;
+
+    GLuint texture_render_cache_depth_ = 0;
+
+    cv::Size render_cache_size_;
+
+    /* Value of framebuffer_generation_ when the framebuffer was left holding the render grid of the previous call. */
+    size_t render_cache_generation_ = 0;
+
+    glm::mat4 render_cache_projection_;
+
+    RenderMode render_cache_mode_ = RenderMode::color;
+
+    GLenum render_cache_mesh_mode_ = GL_FILL;
+
+    cv::Size render_cache_tile_size_;
+
+    /**
+     * The static layer and the render cache of a resolution scale other than the current one, so that switching scale,
+     * e.g. between the levels of `SICAD::superimposeCascade()`, does not invalidate them.
+     */
+    struct ScaleLayers
+    {
+        GLuint static_fbo = 0;
+
+        GLuint texture_static_color = 0;
+
+        GLuint texture_static_depth = 0;
+
+        GLsizei static_width = 0;
+
+        GLsizei static_height = 0;
+
+        bool static_scene_valid = false;
+
+        glm::mat4 static_view;
+
+        glm::mat4 static_projection;
+
+        RenderMode static_render_mode = RenderMode::color;
+
+        GLenum static_mesh_mode = GL_FILL;
+
+        std::vector<RenderCacheKey> render_cache_keys;
+
+        std::vector<bool> render_cache_empty_tiles;
+
+        GLuint render_cache_fbo = 0;
+
+        GLuint texture_render_cache_color = 0;
+
+        GLuint texture_render_cache_depth = 0;
+
+        cv::Size render_cache_size;
+
+        size_t render_cache_generation = 0;
+
+        glm::mat4 render_cache_projection;
+
+        RenderMode render_cache_mode = RenderMode::color;
+
+        GLenum render_cache_mesh_mode = GL_FILL;
+
+        cv::Size render_cache_tile_size;
+    };
+
+    std::map<GLfloat, ScaleLayers> scale_layers_;
+
+    /* Incremented whenever the tiles of the framebuffer are overwritten, so that the render cache knows whether they are still in place. */
+    size_t framebuffer_generation_ = 1;
+
+    size_t rendered_tiles_number_ = 0;
+
+    TensorLayout tensor_layout_ = TensorLayout::nchw;
+
+    TensorFormat tensor_format_ = TensorFormat::float32;
+
+    std::array<GLfloat, 3> tensor_mean_ = { { 0.0f, 0.0f, 0.0f } };
+
+    std::array<GLfloat, 3> tensor_std_ = { { 1.0f, 1.0f, 1.0f } };
+
+    std::unique_ptr<Shader> tensor_shader_;
+
+    GLuint tensor_fbo_ = 0;
+
+    /* Texture holding 4 consecutive elements of the tensor in each texel. */
+    GLuint texture_tensor_ = 0;
+
+    GLuint vao_tensor_ = 0;
+
+    GLsizei tensor_width_ = 0;
+
+    GLsizei tensor_height_ = 0;
+
+    GLint tensor_internal_format_ = 0;
+
+    std::vector<unsigned char> tensor_data_;
+
+    /* Whether color writes are enabled, i.e. unless no color attachment is drawn in depth mode. */
+    bool color_writes_ = true;
+
+    std::vector<bool> empty_tiles_;
+
     Shader* shader_background_ = nullptr;
 
     Shader* shader_cad_ = nullptr;
@@ -377,14 +1269,48 @@ private:
 
     Shader* shader_frame_ = nullptr;
 
+    /* Variants of the built-in mesh model shader, e.g. the depth-only one, compiled on first use. */
+    std::unique_ptr<ShaderVariants> mesh_shaders_;
+
+    /* Variants drawing untextured and textured mesh models with the current options, if built-in mesh model shaders are used. */
+    Shader* mesh_shader_ = nullptr;
+
+    Shader* mesh_texture_shader_ = nullptr;
+
     ModelContainer model_obj_;
 
+    /* Models imported and uploaded, or removed if null, but not swapped in yet, and the fences signaled when their upload completes. */
+    ModelContainer pending_models_;
+
+    std::unordered_map<std::string, GLsync> pending_fences_;
+
+    /* Models uploaded, then superseded or removed before being swapped in, whose OpenGL objects are deleted by the next swap. */
+    std::vector<std::pair<Model*, GLsync>> discarded_models_;
+
+    /* Vertex layouts of untextured and textured models with the current options, read by the import threads. */
+    std::array<Mesh::VertexLayout, 2> vertex_layouts_ = { { Mesh::VertexLayout::full, Mesh::VertexLayout::full } };
+
+    /* Index of the last update requested for each model, used to discard superseded updates. */
+    std::unordered_map<std::string, size_t> model_requests_;
+
+    size_t models_importing_ = 0;
+
+    std::mutex model_mutex_;
+
+    std::condition_variable model_imported_;
+
     GLuint fbo_;
 
     GLuint texture_color_buffer_;
 
     GLuint texture_depth_buffer_;
 
+    GLuint texture_instance_id_ = 0;
+
+    GLuint texture_correspondence_ = 0;
+
+    GLuint texture_point_cloud_ = 0;
+
     GLuint texture_background_;
 
     GLuint vao_background_;
@@ -401,16 +1327,160 @@ private:
 
     GLuint pbo_[2];
 
+    /* Ring of PBOs where the passes of a batch are read back, each copied to cv::Mat while the next ones render. */
+    std::vector<GLuint> batch_pbo_;
+
+    size_t pbo_size_ = 0;
+
     glm::mat4 back_proj_;
 
     glm::mat4 projection_;
 
     glm::mat4 getViewTransformationMatrix(const double* cam_x, const double* cam_o);
 
+    glm::mat4 getModelTransformationMatrix(const double* pose);
+
     void pollOrPostEvent();
 
+    std::vector<std::string> getMeshShaderDefines(const bool textured) const;
+
+    bool setUpMeshShaders();
+
+    bool useMeshShaders() const;
+
+    /**
+     * Whether the instance ID attachment is drawn, i.e. if instance IDs are written or statistics are measured.
+     */
+    bool useInstanceIds() const;
+
+    void setUpTiles(const GLint num_images, const GLsizei cam_width, const GLsizei cam_height);
+
+    void setUpGrid(const GLsizei tiles_cols, const GLsizei tiles_rows);
+
+    void setUpFramebufferSize();
+
+    /**
+     * Render at `scale`, keeping the static layer and the render cache of the current scale and restoring the ones of `scale`.
+     *
+     * @note The OpenGL context must be current.
+     */
+    bool switchResolutionScale(const GLfloat scale);
+
+    void swapScaleLayers(ScaleLayers& layers);
+
+    bool resizeAttachments();
+
+    std::string getCalibrationKey() const;
+
+    bool readCalibration(Calibration& calibration) const;
+
+    bool writeCalibration() const;
+
+    void applyCalibration();
+
+    double benchmarkGrid(const ModelPoseContainer& objpos_map, const double* cam_x, const double* cam_o, const bool pbo_readback, const size_t pbo_depth);
+
+    void createColorAttachment(GLuint& texture, const GLenum attachment, const GLint internal_format, const GLenum format, const GLenum type);
+
+    void setUpFramebuffer();
+
+    void maskAuxiliaryOutputs(const bool mask) const;
+
+    void allocatePBOs();
+
+    void setUpBatchPBOs(const size_t depth);
+
+    size_t getBatchTiles() const;
+
+    void clearBuffers();
+
+    void readPixels(const GLint x, const GLint y, const GLsizei width, const GLsizei height, cv::Mat& img);
+
+    void readPixels(const GLint x, const GLint y, const GLsizei width, const GLsizei height, const size_t pbo_index);
+
+    GLsizei getTilesHeight(const size_t tiles) const;
+
+    void renderTiles(const std::vector<ModelPoseContainer>& objpos_multimap, const size_t first, const size_t count, const glm::mat4& view, const cv::Mat* background, const bool use_rois);
+
+    void setTileViewport(const size_t tile) const;
+
+    void renderTile(const ModelPoseContainer& objpos_map, const size_t tile, const size_t index, const glm::mat4& view, const cv::Mat* background, const bool use_roi);
+
+    bool setUpRenderCacheLayer();
+
+    bool renderCachedTiles(const std::vector<ModelPoseContainer>& objpos_multimap, const double* cam_x, const double* cam_o, const glm::mat4& view, cv::Mat& img);
+
+    void blitTile(const GLuint read_fbo, const size_t read_tile, const GLuint draw_fbo, const size_t draw_tile);
+
+    RenderCacheKey getRenderCacheKey(const ModelPoseContainer& objpos_map, const double* cam_x, const double* cam_o) const;
+
+    bool useRenderCache() const;
+
+    void readBatchPass(const size_t pass, const size_t count);
+
+    void copyBatchPass(const size_t pass, const size_t first, const size_t count, cv::Mat& img);
+
+    bool setUpTensor();
+
+    void writeTensorPass(const size_t first, const size_t count);
+
+    void readImage(const GLint x, const GLint y, const GLsizei width, const GLsizei height, cv::Mat& img);
+
+    /**
+     * Read back the ROIs of the first `count` tiles, to an image `width` pixels wide if they are not packed.
+     */
+    void readRois(const size_t count, const GLsizei width, cv::Mat& img);
+
+    cv::Rect getTileRoi(const ModelPoseContainer& objpos_map, const glm::mat4& view);
+
+    void scissorRoi(const size_t tile, const cv::Rect& roi) const;
+
+    void readInstanceIds(const GLint x, const GLint y, const GLsizei width, const GLsizei height);
+
+    void readCorrespondences(const GLint x, const GLint y, const GLsizei width, const GLsizei height);
+
+    void linearizeDepth(cv::Mat& depth) const;
+
     void renderBackground(const cv::Mat& img) const;
 
+    bool updateStaticScene(const glm::mat4& view);
+
+    void invalidateStaticScene();
+
+    void drawStaticScene(const glm::mat4& view, const size_t tile);
+
+    void drawStaticModels(const glm::mat4& view);
+
+    bool renderModels(const ModelPoseContainer& objpos_map, const glm::mat4& view);
+
+    void drawModel(Model& model_obj, const glm::mat4& model, const glm::mat4& view, const GLuint object_id);
+
+    void projectBoundingBox(const Model& model, const glm::mat4& model_view, ObjectStatistics& statistics) const;
+
+    void queueStatistics(const ModelPoseContainer& objpos_map, const glm::mat4& view, const size_t tile, const size_t index, const bool use_roi);
+
+    bool setUpStatistics(const size_t entries);
+
+    void reduceStatistics();
+
+    void collectStatistics();
+
+    void readStatistics();
+
+    bool isInsideFrustum(const Model& model, const glm::mat4& model_view) const;
+
+    size_t selectLevelOfDetail(const Model& model, const glm::mat4& model_view) const;
+
+    bool importModel(const std::string& mesh_id, const std::string& path, const Model::MemoryFileContainer& files, const size_t request);
+
+    void swapModels();
+
+    void updateVertexLayouts();
+
+    void updateVertexLayout(Model& model);
+
+    Mesh::VertexLayout selectVertexLayout(const bool textured) const;
+
     void setWireframe(GLenum mode);
 
     void factorize_int(const GLsizei area, const GLsizei width_limit, const GLsizei height_limit, GLsizei& width, GLsizei& height);
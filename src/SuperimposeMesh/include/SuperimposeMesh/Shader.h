@@ -8,8 +8,12 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <cstdint>
 #include <exception>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <GL/glew.h>
 
@@ -22,6 +26,46 @@ public:
      */
     Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path);
 
+    /**
+     * Create a shader program with given vertex and fragment shader paths, specialized by the given `#define`s.
+     * Each element of `defines` is injected as `#define <element>` right after the `#version` directive of both shaders,
+     * e.g. `"TEXTURED"` or `"MAX_LIGHTS 4"`.
+     */
+    Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const std::vector<std::string>& defines);
+
+    /**
+     * Create a shader program with given vertex, fragment and geometry shader paths, specialized by the given `#define`s
+     * injected in all the shaders. An empty `geometry_shader_path` links no geometry stage.
+     */
+    Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const std::string& geometry_shader_path, const std::vector<std::string>& defines);
+
+    /**
+     * Set the folder where linked shader programs are cached, so that they are loaded, instead of compiled,
+     * by the shaders created afterwards. An empty folder, the default, disables the cache.
+     *
+     * Cached programs are identified by the hash of their source code and of the OpenGL vendor, renderer and version strings.
+     * Programs rejected by the driver, e.g. after a driver update, are compiled from source and cached again.
+     *
+     * @note The program binary cache requires OpenGL 4.1 or the ARB_get_program_binary extension.
+     */
+    static void set_binary_cache_folder(const std::string& folder);
+
+    static const std::string& get_binary_cache_folder();
+
+    /**
+     * Check whether the program has been loaded from the program binary cache.
+     */
+    inline bool is_cached() const
+    {
+        return cached_;
+    }
+
+    /**
+     * Returns the path of the program binary cache file of the program in the current cache folder,
+     * or an empty string if the cache was disabled or not supported when the program was created.
+     */
+    std::string get_binary_cache_file() const;
+
     /**
      * Activate the shader program.
      */
@@ -38,11 +82,65 @@ public:
         return shader_program_id_;
     }
 
+    /**
+     * Check whether the vertex attribute at `location` is read by the shader program.
+     */
+    bool is_attribute_active(const GLint location) const;
+
 private:
+    static std::string binary_cache_folder_;
+
+    /**
+     * Load the program from a binary cache file. Returns false if the file does not exist or is rejected by the driver.
+     */
+    bool load_binary(const std::string& cache_file);
+
+    void store_binary(const std::string& cache_file) const;
+
     /**
      * The program ID.
      */
     GLuint shader_program_id_;
+
+    bool cached_ = false;
+
+    /* Hash identifying the program in the binary cache, 0 if the cache is not used. */
+    std::uint64_t binary_hash_ = 0;
+};
+
+
+/**
+ * The permutations, i.e. variants, of a shader program specialized by different sets of `#define`s.
+ * Variants are compiled on first use and then cached.
+ */
+class ShaderVariants
+{
+public:
+    ShaderVariants(const std::string& vertex_shader_path, const std::string& fragment_shader_path);
+
+    /**
+     * Create the variants of a shader program whose geometry stage is linked only to the variants defining `geometry_define`,
+     * e.g. the `LAYERED` variants of the built-in mesh model shader, which write `gl_Layer` from the geometry shader.
+     */
+    ShaderVariants(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const std::string& geometry_shader_path, const std::string& geometry_define);
+
+    /**
+     * Returns the variant specialized by `defines`, compiling it if needed. The order of the defines does not matter.
+     *
+     * @note The OpenGL context owning the variants must be current.
+     */
+    Shader& get(const std::vector<std::string>& defines);
+
+private:
+    std::string vertex_shader_path_;
+
+    std::string fragment_shader_path_;
+
+    std::string geometry_shader_path_;
+
+    std::string geometry_define_;
+
+    std::map<std::vector<std::string>, std::unique_ptr<Shader>> variants_;
 };
 
 #endif /* SHADER_H */
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef TEMPLATELIBRARY_H
+#define TEMPLATELIBRARY_H
+
+#include <SuperimposeMesh/SICAD.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+
+/**
+ * A library of silhouette templates of a mesh model, rendered over a grid of orientations and distances from the camera.
+ *
+ * Templates are generated by `TemplateLibrary::generate()` through the multi-tile path of SICAD and stored in a single
+ * binary file, which is memory-mapped when opened. The file holds an index of all the templates, followed by the
+ * orientations and distances of the grid, so that nearest-orientation lookups do not touch the template data.
+ * Each template stores the bounding box of the mesh model in the image, and the binary mask and silhouette edges
+ * within the bounding box, packed at 1 bit per pixel.
+ *
+ * Templates are indexed by `orientation_index * getDistancesNumber() + distance_index`.
+ */
+class TemplateLibrary
+{
+public:
+    /**
+     * A template unpacked from the library.
+     */
+    struct Template
+    {
+        /* 7-component pose of the mesh model used to render the template, with the camera in the origin of the root frame. */
+        Superimpose::ModelPose pose;
+
+        /* Bounding box of the mesh model in the image. Empty if the mesh model is not visible. */
+        cv::Rect roi;
+
+        /* CV_8UC1 masks with the size of `roi`, 255 where the mesh model is drawn or on its silhouette edges, 0 elsewhere. */
+        cv::Mat mask;
+
+        cv::Mat edges;
+    };
+
+    /**
+     * Open a template library file and memory-map it.
+     *
+     * @throws std::runtime_error if the file can not be opened or is not a valid template library.
+     */
+    TemplateLibrary(const std::string& path);
+
+    ~TemplateLibrary();
+
+    /**
+     * Returns `orientations_num` orientations spread uniformly over SO(3), as (ux, uy, uz, theta) axis-angle vectors.
+     * The grid is deterministic, i.e. the same number of orientations always yields the same grid.
+     */
+    static std::vector<std::array<double, 4>> getOrientationGrid(const size_t orientations_num);
+
+    /**
+     * Render the templates of the mesh model `mesh_id` over a grid of `orientations_num` orientations, see
+     * `TemplateLibrary::getOrientationGrid()`, times the given distances, and write them to `path`.
+     *
+     * The camera is in the origin with identity orientation, and the mesh model is placed at each distance along `optical_axis`,
+     * which must be changed from the default (0, 0, -1) if `si_cad` has been created with an `ogl_to_cam` rotation.
+     * Templates are rendered in batches of `SICAD::getTilesNumber()` poses in `SICAD::RenderMode::depth` mode,
+     * so that masks do not depend on lighting nor on textures. ROIs, readback skipping and the render cache are disabled while rendering.
+     * The options of `si_cad` are restored afterwards.
+     *
+     * @note Static mesh models of `si_cad` are part of the templates.
+     *
+     * @note Libraries are stored in the byte order of the current machine and can not be opened on machines with a different byte order.
+     *
+     * @return true upon success, false otherwise, in which case no file is left at `path`.
+     */
+    static bool generate(SICAD& si_cad, const std::string& mesh_id, const size_t orientations_num, const std::vector<double>& distances, const std::string& path,
+                         const std::array<double, 3>& optical_axis = std::array<double, 3>{ { 0.0, 0.0, -1.0 } });
+
+    size_t size() const;
+
+    size_t getOrientationsNumber() const;
+
+    size_t getDistancesNumber() const;
+
+    /**
+     * Returns the size of the images the templates have been rendered into.
+     */
+    cv::Size getImageSize() const;
+
+    /**
+     * Unpack the template at `index`. Returns an empty template, with an empty pose, if the index is out of range.
+     */
+    Template getTemplate(const size_t index) const;
+
+    /**
+     * Returns the index of the template with the nearest orientation to `pose`, at the distance of the grid nearest to
+     * the distance of `pose` from the camera.
+     *
+     * @param pose 7-component pose of the mesh model with respect to the camera, as passed to SICAD.
+     */
+    size_t findNearest(const Superimpose::ModelPose& pose) const;
+
+    /**
+     * Returns the indexes of the templates with the `k` nearest orientations to `pose`, sorted by increasing angular distance,
+     * at the distance of the grid nearest to the distance of `pose` from the camera.
+     */
+    std::vector<size_t> findNearest(const Superimpose::ModelPose& pose, const size_t k) const;
+
+private:
+    TemplateLibrary(const TemplateLibrary&) = delete;
+
+    TemplateLibrary& operator=(const TemplateLibrary&) = delete;
+
+    struct Header;
+
+    struct Entry;
+
+    static std::array<double, 4> toQuaternion(const double* axis_angle);
+
+    static std::array<double, 4> toAxisAngle(const double* quaternion);
+
+    static void packBits(const cv::Mat& mask, std::vector<unsigned char>& data);
+
+    static cv::Mat unpackBits(const unsigned char* data, const cv::Size& size);
+
+    void unmap();
+
+    size_t findNearestDistance(const Superimpose::ModelPose& pose) const;
+
+    const std::string log_ID_ = "[SI::TemplateLibrary]";
+
+    const unsigned char* data_ = nullptr;
+
+    size_t data_size_ = 0;
+
+    const Header* header_ = nullptr;
+
+    const Entry* entries_ = nullptr;
+
+    const float* orientations_ = nullptr;
+
+    const float* distances_ = nullptr;
+
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+#endif /* TEMPLATELIBRARY_H */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <GL/glew.h>
+
+#include <opencv2/core/core.hpp>
+
+
+/**
+ * A process-wide cache of texture objects, shared by all the models of all the OpenGL contexts created by SICAD,
+ * which share their objects.
+ *
+ * Textures are identified by a key built from the hash of their encoded content, so that the same image is decoded
+ * and uploaded once even if referenced by different paths or loaded from memory. Canonical file paths are mapped
+ * to keys, so that files already cached are not read again.
+ *
+ * Texture objects are reference counted and deleted when no model uses them anymore.
+ * If uploading a texture would exceed the memory budget, the texture is downscaled to the largest mipmap level that fits.
+ *
+ * @note All the methods are thread-safe.
+ */
+class TextureCache
+{
+public:
+    static TextureCache& getInstance();
+
+    /**
+     * Returns the key of a texture from its encoded content, e.g. the bytes of a JPEG file.
+     */
+    static std::string getKey(const char* data, const size_t size);
+
+    /**
+     * Returns the absolute path of a file with symbolic links and relative components resolved,
+     * or an empty string if the file does not exist.
+     */
+    static std::string getCanonicalPath(const std::string& path);
+
+    /**
+     * Retrieve the key of the texture last read from `canonical_path`.
+     */
+    bool findPath(const std::string& canonical_path, std::string& key) const;
+
+    void addPath(const std::string& canonical_path, const std::string& key);
+
+    /**
+     * Returns true if a texture object for `key` exists.
+     */
+    bool contains(const std::string& key) const;
+
+    /**
+     * Get a new reference to the texture object for `key`, if it exists. No OpenGL call is made.
+     */
+    bool acquire(const std::string& key, GLuint& texture);
+
+    /**
+     * Get a new reference to the texture object for `key`, uploading `image` if the texture object does not exist.
+     *
+     * @note The OpenGL context using the texture must be current.
+     */
+    GLuint acquire(const std::string& key, const cv::Mat& image);
+
+    /**
+     * Release a reference to a texture object, deleting it if not referenced anymore.
+     *
+     * @note The OpenGL context using the texture must be current.
+     */
+    void release(const GLuint texture);
+
+    /**
+     * Set the maximum amount of memory, in bytes, used by the texture objects, including their mipmaps.
+     * The budget applies to textures uploaded afterwards. Default is no limit.
+     */
+    void setMemoryBudget(const size_t bytes);
+
+    size_t getMemoryBudget() const;
+
+    /**
+     * Returns the amount of memory, in bytes, used by the texture objects, including their mipmaps.
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    TextureCache() = default;
+
+    TextureCache(const TextureCache&) = delete;
+
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    struct Texture
+    {
+        GLuint id;
+        size_t references;
+        size_t bytes;
+    };
+
+    const std::string log_ID_ = "[SI::TextureCache]";
+
+    std::unordered_map<std::string, Texture> textures_;
+
+    std::unordered_map<GLuint, std::string> keys_;
+
+    std::unordered_map<std::string, std::string> paths_;
+
+    size_t memory_budget_ = static_cast<size_t>(-1);
+
+    size_t memory_usage_ = 0;
+
+    mutable std::mutex mutex_;
+};
+
+#endif /* TEXTURECACHE_H */
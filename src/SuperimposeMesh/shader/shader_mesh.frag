@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+/*
+ * Mesh model shader, specialized by the following defines, in order of precedence:
+ *  - DEPTH_ONLY writes no color, to be used with color writes disabled
+ *  - SILHOUETTE writes white
+ *  - ID writes the object_id uniform as a little-endian 24-bit integer in the BGR channels
+ *  - TEXTURED samples the diffuse texture
+ *  - UNTEXTURED, the default, writes a constant color
+ * and, in addition to any of the above,
+ *  - INSTANCE_ID writes the object_id uniform to the unsigned integer output at location 1
+ *  - CORRESPONDENCE writes the 1-based triangle index, offset by the triangle_offset uniform, and the bits of the model coordinates of the fragment
+ *    to the unsigned integer output at location 2
+ *  - POINT_CLOUD writes the point of the fragment, in the frame set by the vertex shader, and 1 to the floating point output at location 3
+ */
+
+#version 330 core
+
+#if defined(ID) || defined(INSTANCE_ID)
+uniform uint object_id;
+#endif
+
+#ifdef INSTANCE_ID
+layout (location = 1) out uint instance_id;
+#endif
+
+#ifdef CORRESPONDENCE
+uniform uint triangle_offset;
+
+in vec3 ModelPosition;
+
+layout (location = 2) out uvec4 correspondence;
+#endif
+
+#ifdef POINT_CLOUD
+in vec3 Point;
+
+layout (location = 3) out vec4 point;
+#endif
+
+#if !defined(DEPTH_ONLY)
+layout (location = 0) out vec4 color;
+
+#if defined(SILHOUETTE)
+#elif defined(ID)
+#elif defined(TEXTURED)
+in vec2 TexCoords;
+
+uniform sampler2D texture_diffuse1;
+#endif
+#endif
+
+void main()
+{
+#ifdef INSTANCE_ID
+    instance_id = object_id;
+#endif
+
+#ifdef CORRESPONDENCE
+    correspondence = uvec4(triangle_offset + uint(gl_PrimitiveID) + 1u, floatBitsToUint(ModelPosition));
+#endif
+
+#ifdef POINT_CLOUD
+    point = vec4(Point, 1.0f);
+#endif
+
+#if defined(DEPTH_ONLY)
+#elif defined(SILHOUETTE)
+    color = vec4(1.0f, 1.0f, 1.0f, 1.0f);
+#elif defined(ID)
+    color = vec4(float((object_id >> 16) & 0xFFu), float((object_id >> 8) & 0xFFu), float(object_id & 0xFFu), 255.0f) / 255.0f;
+#elif defined(TEXTURED)
+    color = texture(texture_diffuse1, TexCoords);
+#else
+    color = vec4(0.2f, 0.5f, 1.0f, 1.0f); // BGR orange-like color
+#endif
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+/*
+ * Mesh model shader, specialized by the following defines:
+ *  - TEXTURED passes the texture coordinates to the fragment shader
+ *  - CORRESPONDENCE passes the vertex position in model coordinates, mapped by the vertex_transform uniform, to the fragment shader
+ *  - POINT_CLOUD passes the vertex position mapped by the point_transform uniform, i.e. in the camera or world frame, to the fragment shader
+ *  - INSTANCED reads the model matrix from the per-instance attribute at locations 3 to 6 instead of the model uniform
+ *  - LAYERED passes the layer selected by the layer uniform, plus the instance index if INSTANCED, to shader_mesh.geom,
+ *    which renders to that layer of a layered framebuffer and passes the other outputs on to the fragment shader
+ */
+
+#version 330 core
+
+#ifdef LAYERED
+#define TexCoords VertexTexCoords
+#define ModelPosition VertexModelPosition
+#define Point VertexPoint
+
+uniform int layer;
+
+flat out int VertexLayer;
+#endif
+
+layout (location = 0) in vec3 position;
+#ifdef TEXTURED
+layout (location = 2) in vec2 texCoords;
+
+out vec2 TexCoords;
+#endif
+
+#ifdef CORRESPONDENCE
+uniform mat4 vertex_transform;
+
+out vec3 ModelPosition;
+#endif
+
+#ifdef POINT_CLOUD
+uniform mat4 point_transform;
+
+out vec3 Point;
+#endif
+
+#ifdef INSTANCED
+layout (location = 3) in mat4 instance_model;
+#else
+uniform mat4 model;
+#endif
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+#ifdef INSTANCED
+    vec4 world_position = instance_model * vec4(position, 1.0f);
+#else
+    vec4 world_position = model * vec4(position, 1.0f);
+#endif
+
+    gl_Position = projection * view * world_position;
+
+#ifdef TEXTURED
+    TexCoords = texCoords;
+#endif
+
+#ifdef CORRESPONDENCE
+    ModelPosition = vec3(vertex_transform * vec4(position, 1.0f));
+#endif
+
+#ifdef POINT_CLOUD
+    Point = vec3(point_transform * world_position);
+#endif
+
+#ifdef LAYERED
+#ifdef INSTANCED
+    VertexLayer = layer + gl_InstanceID;
+#else
+    VertexLayer = layer;
+#endif
+#endif
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#version 330 core
+
+flat in vec4 Bounds;
+flat in vec4 Depths;
+
+layout (location = 0) out vec4 bounds;
+layout (location = 1) out vec4 depths;
+
+void main()
+{
+    bounds = Bounds;
+    depths = Depths;
+}
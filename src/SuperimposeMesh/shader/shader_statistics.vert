@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+/*
+ * Statistics reduction shader, drawing a point for each pixel of a region of a tile, with no vertex attribute.
+ * Each point lands on the texel of the statistics textures of the mesh model visible in the pixel, if any,
+ * where the bounds and the depth range of all its pixels are reduced by min blending.
+ */
+
+#version 330 core
+
+uniform usampler2D instance_ids;
+uniform sampler2D depth;
+uniform ivec2 tile_origin;
+uniform ivec4 region;
+uniform uint objects;
+uniform int offset;
+uniform ivec2 statistics_size;
+uniform float z_near;
+uniform float z_far;
+
+flat out vec4 Bounds;
+flat out vec4 Depths;
+
+void main()
+{
+    /* Pixels are counted from the upper-left corner of the tile, whose rows are stored bottom-up from tile_origin. */
+    ivec2 pixel = region.xy + ivec2(gl_VertexID % region.z, gl_VertexID / region.z);
+    ivec2 texel = ivec2(tile_origin.x + pixel.x, tile_origin.y - pixel.y);
+
+    Bounds = vec4(0.0f);
+    Depths = vec4(0.0f);
+
+    /* Pixels of the background, of the static scene and of reference frames have no instance ID, their points are clipped. */
+    uint id = texelFetch(instance_ids, texel, 0).r;
+    if (id == 0u || id > objects)
+    {
+        gl_Position = vec4(2.0f, 2.0f, 2.0f, 1.0f);
+        return;
+    }
+
+    int entry = offset + int(id) - 1;
+    vec2 target = vec2(entry % statistics_size.x, entry / statistics_size.x) + 0.5f;
+
+    gl_Position = vec4(target / vec2(statistics_size) * 2.0f - 1.0f, 0.0f, 1.0f);
+
+    /* Invert the perspective division of the projection matrix, mapping window depth in [0, 1] to the distance from the camera plane.
+       The expression is rearranged so that window depths close to 1 do not cancel out in single precision. */
+    float window_depth = texelFetch(depth, texel, 0).r;
+    float distance = z_near * z_far / (z_far * (1.0f - window_depth) + z_near * window_depth);
+
+    /* Maxima are reduced as minima of the opposite values. Visible pixels are counted by occlusion queries instead. */
+    Bounds = vec4(pixel.x, pixel.y, -pixel.x, -pixel.y);
+    Depths = vec4(distance, -distance, 0.0f, 0.0f);
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#version 330 core
+
+out vec4 value;
+
+uniform sampler2D color;
+uniform ivec2 tile_size;
+uniform int tiles_cols;
+uniform int tiles_count;
+uniform int framebuffer_height;
+uniform int tensor_width;
+uniform bool channels_first;
+uniform vec3 mean;
+uniform vec3 inverse_std;
+
+float element(int index)
+{
+    int pixels = tile_size.x * tile_size.y;
+
+    int n = index / (3 * pixels);
+    if (n >= tiles_count)
+        return 0.0f;
+
+    int offset = index - n * 3 * pixels;
+
+    int c;
+    int h;
+    int w;
+    if (channels_first)
+    {
+        c = offset / pixels;
+        h = (offset % pixels) / tile_size.x;
+        w = offset % tile_size.x;
+    }
+    else
+    {
+        c = offset % 3;
+        h = offset / (3 * tile_size.x);
+        w = (offset / 3) % tile_size.x;
+    }
+
+    /* Tiles are laid out from the upper-left corner of the framebuffer, whose rows are stored bottom-up. */
+    ivec2 texel = ivec2((n % tiles_cols) * tile_size.x + w, framebuffer_height - 1 - ((n / tiles_cols) * tile_size.y + h));
+
+    return (texelFetch(color, texel, 0)[c] - mean[c]) * inverse_std[c];
+}
+
+void main()
+{
+    int index = 4 * (int(gl_FragCoord.y) * tensor_width + int(gl_FragCoord.x));
+
+    value = vec4(element(index), element(index + 1), element(index + 2), element(index + 3));
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#version 330 core
+
+void main()
+{
+    /* A triangle covering the viewport, with vertices (-1, -1), (3, -1) and (-1, 3). */
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+
+    gl_Position = vec4(position * 2.0f - 1.0f, 0.0f, 1.0f);
+}
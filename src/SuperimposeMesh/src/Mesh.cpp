@@ -7,6 +7,8 @@
 
 #include "SuperimposeMesh/Mesh.h"
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 #include <glm/glm.hpp>
@@ -19,46 +21,49 @@ Mesh::Mesh
     std::vector<Vertex> vertices,
     std::vector<GLuint> indices,
     std::vector<Texture> textures
+) :
+    Mesh(vertices, indices, textures, { { 0, static_cast<GLuint>(indices.size()), 0, static_cast<GLuint>(vertices.size()) } })
+{ }
+
+
+Mesh::Mesh
+(
+    std::vector<Vertex> vertices,
+    std::vector<GLuint> indices,
+    std::vector<Texture> textures,
+    std::vector<Submesh> submeshes
 ) :
     vertices_(vertices),
-    indices_(indices),
     textures_(textures)
 {
-    glGenVertexArrays(1, &VAO_);
-    glGenBuffers(1, &VBO_);
-    glGenBuffers(1, &EBO_);
-
-    glBindVertexArray(VAO_);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-    glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex), &vertices_[0], GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_.size() * sizeof(GLuint), &indices_[0], GL_STATIC_DRAW);
+    lods_.push_back(LevelOfDetail());
+    lods_.back().indices = indices;
+    lods_.back().submeshes = submeshes;
+}
 
-    /* Vertex Positions */
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*) 0);
-    glEnableVertexAttribArray(0);
 
-    /* Vertex Normals. */
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)sizeof(glm::vec3));
-    glEnableVertexAttribArray(1);
+void Mesh::Draw(Shader shader)
+{
+    Draw(shader, 0);
+}
 
-    /* Vertex Texture Coords */
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*) (2 * sizeof(glm::vec3)));
-    glEnableVertexAttribArray(2);
 
-    glBindVertexArray(0);
+void Mesh::Draw(Shader shader, const size_t lod)
+{
+    Draw(shader, lod, 0);
 }
 
 
-void Mesh::Draw(Shader shader)
+void Mesh::Draw(Shader shader, const size_t lod, const GLuint triangle_offset)
 {
     /* FIXME
      * This part of code assumes that the fragment shader has several uniform variables with names
      *  - texture_diffuse<number>
      *  - texture_specular<number>
      */
+    if (!isUploaded())
+        upload();
+
     GLuint diffuseNr = 1;
     GLuint specularNr = 1;
     for (GLuint i = 0; i < textures_.size(); ++i)
@@ -86,7 +91,282 @@ void Mesh::Draw(Shader shader)
     glActiveTexture(GL_TEXTURE0);
 
     /* Draw mesh. */
+    const LevelOfDetail& level = lods_[std::min(lod, lods_.size() - 1)];
+
     glBindVertexArray(VAO_);
-    glDrawElements(GL_TRIANGLES, indices_.size(), GL_UNSIGNED_INT, 0);
+
+    /* gl_PrimitiveID restarts from 0 in each draw, including each draw of a multi-draw, hence submeshes are drawn
+       one by one, each with the index of its first triangle, if the shader needs triangle indices. */
+    const GLint triangle_offset_location = glGetUniformLocation(shader.get_program(), "triangle_offset");
+    if (triangle_offset_location != -1)
+    {
+        for (size_t i = 0; i < level.draw_counts.size(); ++i)
+        {
+            glUniform1ui(triangle_offset_location, triangle_offset + level.draw_first_triangles[i]);
+            glDrawElementsBaseVertex(GL_TRIANGLES, level.draw_counts[i], index_type_, const_cast<GLvoid*>(level.draw_offsets[i]), level.draw_base_vertices[i]);
+        }
+    }
+    else if (level.draw_counts.size() == 1 && level.draw_base_vertices[0] == 0)
+        glDrawElements(GL_TRIANGLES, level.draw_counts[0], index_type_, level.draw_offsets[0]);
+    else
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, level.draw_counts.data(), index_type_, level.draw_offsets.data(), level.draw_counts.size(), level.draw_base_vertices.data());
+    glBindVertexArray(0);
+}
+
+
+void Mesh::addLevelOfDetail(std::vector<GLuint> indices, std::vector<Submesh> submeshes)
+{
+    lods_.push_back(LevelOfDetail());
+    lods_.back().indices = indices;
+    lods_.back().submeshes = submeshes;
+
+    if (VBO_ != 0)
+        uploadIndices();
+}
+
+
+void Mesh::upload()
+{
+    if (isUploaded())
+        return;
+
+    uploadBuffers();
+
+    glGenVertexArrays(1, &VAO_);
+
+    setUpVertexArray();
+}
+
+
+void Mesh::uploadBuffers()
+{
+    if (VBO_ != 0)
+        return;
+
+    glGenBuffers(1, &VBO_);
+    glGenBuffers(1, &EBO_);
+
+    uploadIndices();
+
+    uploadVertices();
+}
+
+
+void Mesh::release()
+{
+    if (VBO_ == 0)
+        return;
+
+    glDeleteVertexArrays(1, &VAO_);
+    glDeleteBuffers(1, &VBO_);
+    glDeleteBuffers(1, &EBO_);
+
+    VAO_ = 0;
+    VBO_ = 0;
+    EBO_ = 0;
+}
+
+
+bool Mesh::isUploaded() const
+{
+    return VAO_ != 0;
+}
+
+
+const std::vector<Mesh::Texture>& Mesh::getTextures() const
+{
+    return textures_;
+}
+
+
+void Mesh::setTextures(std::vector<Texture> textures)
+{
+    textures_ = textures;
+}
+
+
+size_t Mesh::getLevelsOfDetail() const
+{
+    return lods_.size();
+}
+
+
+size_t Mesh::getTrianglesNumber(const size_t lod) const
+{
+    return lods_[std::min(lod, lods_.size() - 1)].indices.size() / 3;
+}
+
+
+void Mesh::setVertexLayout(const VertexLayout layout, const glm::vec3& quantization_min, const glm::vec3& quantization_extent)
+{
+    layout_ = layout;
+    quantization_min_ = quantization_min;
+    quantization_extent_ = quantization_extent;
+
+    if (VBO_ != 0)
+        uploadVertices();
+
+    if (isUploaded())
+        setUpVertexArray();
+}
+
+
+Mesh::VertexLayout Mesh::getVertexLayout() const
+{
+    return layout_;
+}
+
+
+void Mesh::uploadIndices()
+{
+    const std::vector<Submesh>& submeshes = lods_.front().submeshes;
+
+    GLuint max_submesh_vertices = 0;
+    for (const Submesh& submesh : submeshes)
+        max_submesh_vertices = std::max(max_submesh_vertices, submesh.vertex_count);
+
+    /* Indices are rebased to the beginning of the vertex buffer, so that the whole mesh is drawn
+       with a single glDrawElements(), unless 16-bit indices fit each submesh but not the whole mesh.
+       In the latter case submeshes are drawn with a single glMultiDrawElementsBaseVertex(). */
+    bool rebase = vertices_.size() <= 65536 || max_submesh_vertices > 65536;
+
+    index_type_ = (vertices_.size() <= 65536 || max_submesh_vertices <= 65536) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    const size_t index_size = index_type_ == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+
+    /* All the levels of detail are stored one after the other in the same index buffer. */
+    size_t num_indices = 0;
+    for (const LevelOfDetail& lod : lods_)
+        num_indices += lod.indices.size();
+
+    std::vector<GLubyte> index_data(num_indices * index_size);
+    size_t lod_first_index = 0;
+    for (LevelOfDetail& lod : lods_)
+    {
+        for (const Submesh& submesh : lod.submeshes)
+        {
+            for (GLuint i = submesh.first_index; i < submesh.first_index + submesh.index_count; ++i)
+            {
+                GLuint index = rebase ? lod.indices[i] + submesh.base_vertex : lod.indices[i];
+
+                if (index_type_ == GL_UNSIGNED_SHORT)
+                    reinterpret_cast<GLushort*>(index_data.data())[lod_first_index + i] = static_cast<GLushort>(index);
+                else
+                    reinterpret_cast<GLuint*>(index_data.data())[lod_first_index + i] = index;
+            }
+        }
+
+        lod.draw_counts.clear();
+        lod.draw_offsets.clear();
+        lod.draw_base_vertices.clear();
+        lod.draw_first_triangles.clear();
+        if (rebase)
+        {
+            lod.draw_counts.push_back(lod.indices.size());
+            lod.draw_offsets.push_back(reinterpret_cast<const GLvoid*>(lod_first_index * index_size));
+            lod.draw_base_vertices.push_back(0);
+            lod.draw_first_triangles.push_back(0);
+        }
+        else
+        {
+            for (const Submesh& submesh : lod.submeshes)
+            {
+                lod.draw_counts.push_back(submesh.index_count);
+                lod.draw_offsets.push_back(reinterpret_cast<const GLvoid*>((lod_first_index + submesh.first_index) * index_size));
+                lod.draw_base_vertices.push_back(submesh.base_vertex);
+                lod.draw_first_triangles.push_back(submesh.first_index / 3);
+            }
+        }
+
+        lod_first_index += lod.indices.size();
+    }
+
+    /* The element array buffer binding belongs to the vertex array, hence indices are uploaded through another target. */
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO_);
+    glBufferData(GL_COPY_WRITE_BUFFER, index_data.size(), index_data.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+
+void Mesh::uploadVertices()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+
+    if (layout_ == VertexLayout::full)
+        glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex), &vertices_[0], GL_STATIC_DRAW);
+    else if (layout_ == VertexLayout::position)
+    {
+        std::vector<glm::vec3> positions;
+        positions.reserve(vertices_.size());
+        for (const Vertex& vertex : vertices_)
+            positions.push_back(vertex.Position);
+
+        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), &positions[0], GL_STATIC_DRAW);
+    }
+    else if (layout_ == VertexLayout::quantized_position)
+    {
+        /* Unsigned normalized integers are converted as c / 65535 by any OpenGL version,
+           while signed ones changed conversion rule in OpenGL 4.2. The 4th component pads
+           the vertex to 8 bytes to keep attributes 4-byte aligned. */
+        std::vector<GLushort> positions;
+        positions.reserve(vertices_.size() * 4);
+        for (const Vertex& vertex : vertices_)
+        {
+            for (GLuint i = 0; i < 3; ++i)
+            {
+                GLfloat normalized = quantization_extent_[i] > 0.0f ? (vertex.Position[i] - quantization_min_[i]) / quantization_extent_[i] : 0.0f;
+                normalized = std::min(std::max(normalized, 0.0f), 1.0f);
+
+                positions.push_back(static_cast<GLushort>(std::round(normalized * 65535.0f)));
+            }
+            positions.push_back(0);
+        }
+
+        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(GLushort), &positions[0], GL_STATIC_DRAW);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+
+void Mesh::setUpVertexArray()
+{
+    glBindVertexArray(VAO_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+
+    if (layout_ == VertexLayout::full)
+    {
+        /* Vertex Positions */
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*) 0);
+        glEnableVertexAttribArray(0);
+
+        /* Vertex Normals. */
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)sizeof(glm::vec3));
+        glEnableVertexAttribArray(1);
+
+        /* Vertex Texture Coords */
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*) (2 * sizeof(glm::vec3)));
+        glEnableVertexAttribArray(2);
+    }
+    else if (layout_ == VertexLayout::position)
+    {
+        /* Vertex Positions */
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (GLvoid*) 0);
+        glEnableVertexAttribArray(0);
+
+        glDisableVertexAttribArray(1);
+        glDisableVertexAttribArray(2);
+    }
+    else if (layout_ == VertexLayout::quantized_position)
+    {
+        /* Vertex Positions */
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, 4 * sizeof(GLushort), (GLvoid*) 0);
+        glEnableVertexAttribArray(0);
+
+        glDisableVertexAttribArray(1);
+        glDisableVertexAttribArray(2);
+    }
+
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
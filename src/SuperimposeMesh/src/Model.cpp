@@ -6,29 +6,287 @@
  */
 
 #include "SuperimposeMesh/Model.h"
+#include "SuperimposeMesh/TextureCache.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <queue>
+#include <tuple>
 
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/Importer.hpp>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 #include <assimp/postprocess.h>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
 
 
-Model::Model(const GLchar* path)
+namespace
 {
-    loadModel(path);
+
+/**
+ * Remove the "." components of a path and collapse the ".." ones against the previous component, so that paths built by assimp,
+ * e.g. of textures referenced as "../texture.jpg" by a material, match the paths of the files stored in memory.
+ */
+std::string normalizePath(const std::string& path)
+{
+    const bool absolute = !path.empty() && path[0] == '/';
+
+    std::vector<std::string> components;
+
+    size_t begin = 0;
+    while (begin < path.size())
+    {
+        size_t end = std::min(path.find('/', begin), path.size());
+
+        std::string component = path.substr(begin, end - begin);
+        if (component == "..")
+        {
+            /* Leading ".." components are kept in relative paths and dropped in absolute ones, as the root has no parent. */
+            if (!components.empty() && components.back() != "..")
+                components.pop_back();
+            else if (!absolute)
+                components.push_back(component);
+        }
+        else if (!component.empty() && component != ".")
+            components.push_back(component);
+
+        begin = end + 1;
+    }
+
+    std::string normalized = absolute ? "/" : "";
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        if (i > 0)
+            normalized += "/";
+        normalized += components[i];
+    }
+
+    return normalized;
+}
+
+
+/**
+ * Read-only stream over a file stored in memory.
+ */
+class MemoryIOStream : public Assimp::IOStream
+{
+public:
+    MemoryIOStream(const Model::MemoryFile& file) :
+        file_(file)
+    { }
+
+    size_t Read(void* buffer, size_t size, size_t count) override
+    {
+        if (size == 0)
+            return 0;
+
+        count = std::min(count, (file_.size - position_) / size);
+        std::copy(file_.data + position_, file_.data + position_ + size * count, static_cast<char*>(buffer));
+        position_ += size * count;
+
+        return count;
+    }
+
+    size_t Write(const void* buffer, size_t size, size_t count) override
+    {
+        return 0;
+    }
+
+    aiReturn Seek(size_t offset, aiOrigin origin) override
+    {
+        size_t position = offset;
+        if (origin == aiOrigin_CUR)
+            position += position_;
+        else if (origin == aiOrigin_END)
+            position = file_.size - offset;
+
+        if (position > file_.size)
+            return aiReturn_FAILURE;
+
+        position_ = position;
+
+        return aiReturn_SUCCESS;
+    }
+
+    size_t Tell() const override
+    {
+        return position_;
+    }
+
+    size_t FileSize() const override
+    {
+        return file_.size;
+    }
+
+    void Flush() override
+    { }
+
+private:
+    Model::MemoryFile file_;
+
+    size_t position_ = 0;
+};
+
+
+/**
+ * Assimp file system looking up files stored in memory first, then the filesystem.
+ */
+class MemoryIOSystem : public Assimp::DefaultIOSystem
+{
+public:
+    MemoryIOSystem(const Model::MemoryFileContainer& files) :
+        files_(files)
+    { }
+
+    bool Exists(const char* path) const override
+    {
+        return files_.find(normalizePath(path)) != files_.end() || Assimp::DefaultIOSystem::Exists(path);
+    }
+
+    Assimp::IOStream* Open(const char* path, const char* mode = "rb") override
+    {
+        auto iter_file = files_.find(normalizePath(path));
+        if (iter_file != files_.end())
+            return new MemoryIOStream(iter_file->second);
+
+        return Assimp::DefaultIOSystem::Open(path, mode);
+    }
+
+    void Close(Assimp::IOStream* stream) override
+    {
+        delete stream;
+    }
+
+private:
+    const Model::MemoryFileContainer& files_;
+};
+
+}
+
+
+Model::Model(const GLchar* path) :
+    Model(path, ImportProfile())
+{ }
+
+
+Model::Model(const GLchar* path, const ImportProfile& profile) :
+    Model(path, MemoryFileContainer(), profile)
+{ }
+
+
+Model::Model(const GLchar* path, const MemoryFileContainer& files, const ImportProfile& profile) :
+    profile_(profile)
+{
+    loadModel(path, files);
+}
+
+
+bool Model::is_loaded() const
+{
+    return loaded_;
+}
+
+
+void Model::upload()
+{
+    if (uploaded_)
+        return;
+
+    uploadBuffers();
+
+    for (Mesh& mesh : meshes_)
+        mesh.upload();
+
+    uploaded_ = true;
+}
+
+
+void Model::uploadBuffers()
+{
+    if (buffers_uploaded_)
+        return;
+
+    /* Textures are shared by all the models through the texture cache, and decoded only if not cached yet. */
+    TextureCache& texture_cache = TextureCache::getInstance();
+    for (size_t i = 0; i < textures_loaded_.size(); ++i)
+    {
+        if (!texture_cache.acquire(texture_sources_[i].key, textures_loaded_[i].id))
+            textures_loaded_[i].id = texture_cache.acquire(texture_sources_[i].key, decodeTexture(texture_sources_[i]));
+    }
+    texture_sources_.clear();
+
+    /* Meshes store a copy of the textures they use, which have been imported without texture objects. */
+    for (Mesh& mesh : meshes_)
+    {
+        std::vector<Mesh::Texture> textures = mesh.getTextures();
+        for (Mesh::Texture& texture : textures)
+        {
+            for (const Mesh::Texture& loaded : textures_loaded_)
+            {
+                if (loaded.path == texture.path)
+                    texture.id = loaded.id;
+            }
+        }
+        mesh.setTextures(textures);
+
+        mesh.uploadBuffers();
+    }
+
+    buffers_uploaded_ = true;
+}
+
+
+void Model::release()
+{
+    for (Mesh& mesh : meshes_)
+        mesh.release();
+
+    for (Mesh::Texture& texture : textures_loaded_)
+    {
+        if (texture.id != 0)
+            TextureCache::getInstance().release(texture.id);
+        texture.id = 0;
+    }
+}
+
+
+bool Model::isUploaded() const
+{
+    return uploaded_;
 }
 
 
 void Model::Draw(Shader shader)
 {
-    for(GLuint i = 0; i < meshes_.size(); i++)
+    Draw(shader, 0);
+}
+
+
+void Model::Draw(Shader shader, const size_t lod)
+{
+    if (!uploaded_)
+        upload();
+
+    /* Triangles are numbered across the meshes, see Mesh::Draw(). */
+    GLuint triangle_offset = 0;
+    for (Mesh& mesh : meshes_)
     {
-        meshes_[i].Draw(shader);
+        mesh.Draw(shader, lod, triangle_offset);
+        triangle_offset += static_cast<GLuint>(mesh.getTrianglesNumber(lod));
     }
 }
 
@@ -39,17 +297,153 @@ bool Model::has_texture()
 }
 
 
-void Model::loadModel(std::string path)
+void Model::setVertexLayout(const Mesh::VertexLayout layout)
+{
+    layout_ = layout;
+
+    for (Mesh& mesh : meshes_)
+        mesh.setVertexLayout(layout_, aabb_min_, aabb_max_ - aabb_min_);
+}
+
+
+Mesh::VertexLayout Model::getVertexLayout() const
+{
+    return layout_;
+}
+
+
+glm::mat4 Model::getVertexTransform() const
+{
+    if (layout_ != Mesh::VertexLayout::quantized_position)
+        return glm::mat4(1.0f);
+
+    /* Quantized positions are normalized in [0, 1] within the model axis-aligned bounding box. */
+    return glm::scale(glm::translate(glm::mat4(1.0f), aabb_min_), aabb_max_ - aabb_min_);
+}
+
+
+const Model::ImportStatistics& Model::getImportStatistics() const
+{
+    return statistics_;
+}
+
+
+size_t Model::getLevelsOfDetail() const
+{
+    return lod_errors_.size();
+}
+
+
+GLfloat Model::getLevelOfDetailError(const size_t lod) const
+{
+    return lod_errors_[std::min(lod, lod_errors_.size() - 1)];
+}
+
+
+size_t Model::getTrianglesNumber(const size_t lod) const
+{
+    size_t triangles = 0;
+    for (const Mesh& mesh : meshes_)
+        triangles += mesh.getTrianglesNumber(lod);
+
+    return triangles;
+}
+
+
+size_t Model::selectLevelOfDetail(const GLfloat max_error) const
+{
+    /* Errors are non-decreasing with the level of detail. */
+    size_t lod = 0;
+    while (lod + 1 < lod_errors_.size() && lod_errors_[lod + 1] <= max_error)
+        ++lod;
+
+    return lod;
+}
+
+
+const glm::vec3& Model::getBoundingBoxMin() const
+{
+    return aabb_min_;
+}
+
+
+const glm::vec3& Model::getBoundingBoxMax() const
+{
+    return aabb_max_;
+}
+
+
+const glm::vec3& Model::getBoundingSphereCenter() const
+{
+    return sphere_center_;
+}
+
+
+GLfloat Model::getBoundingSphereRadius() const
+{
+    return sphere_radius_;
+}
+
+
+void Model::loadModel(std::string path, const MemoryFileContainer& files)
 {
+    /* Paths of the files stored in memory are normalized, so that they match the paths built by assimp. */
+    MemoryFileContainer normalized_files;
+    for (const std::pair<const std::string, MemoryFile>& file : files)
+        normalized_files[normalizePath(file.first)] = file.second;
+
+    files_ = &normalized_files;
+
     Assimp::Importer import;
-    const aiScene* scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+    if (!normalized_files.empty())
+        import.SetIOHandler(new MemoryIOSystem(normalized_files));
+
+    const aiScene* scene = import.ReadFile(normalizePath(path), aiProcess_Triangulate | aiProcess_FlipUVs);
 
     if(!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
     {
         std::cerr << "ERROR::ASSIMP::" << import.GetErrorString() << std::endl;
+        files_ = nullptr;
         return;
     }
 
+    /* Statistics of the meshes as stored in the file. */
+    size_t num_indices = 0;
+    size_t cache_misses = 0;
+    for (GLuint i = 0; i < scene->mNumMeshes; ++i)
+    {
+        const aiMesh* mesh = scene->mMeshes[i];
+
+        std::vector<GLuint> indices;
+        for (GLuint j = 0; j < mesh->mNumFaces; ++j)
+            indices.insert(indices.end(), mesh->mFaces[j].mIndices, mesh->mFaces[j].mIndices + mesh->mFaces[j].mNumIndices);
+
+        statistics_.vertices_before += mesh->mNumVertices;
+        num_indices += indices.size();
+        cache_misses += countCacheMisses(indices.data(), indices.size(), mesh->mNumVertices);
+    }
+    statistics_.acmr_before = num_indices > 0 ? 3.0f * cache_misses / num_indices : 0.0f;
+
+    /* Weld vertices and reorder triangles for vertex cache locality. */
+    unsigned int post_processing = 0;
+    if (profile_.weld_vertices)
+        post_processing |= aiProcess_JoinIdenticalVertices;
+    if (profile_.optimize_vertex_cache)
+        post_processing |= aiProcess_ImproveCacheLocality;
+
+    if (post_processing != 0)
+    {
+        import.SetPropertyInteger(AI_CONFIG_PP_ICL_PTCACHE_SIZE, profile_.vertex_cache_size);
+
+        scene = import.ApplyPostProcessing(post_processing);
+        if (!scene)
+        {
+            std::cerr << "ERROR::ASSIMP::" << import.GetErrorString() << std::endl;
+            files_ = nullptr;
+            return;
+        }
+    }
+
     size_t foundpos = path.find_last_of('/');
     if (foundpos == std::string::npos)
     {
@@ -60,29 +454,66 @@ void Model::loadModel(std::string path)
        directory_ = path.substr(0, foundpos);
     }
 
-    processNode(scene->mRootNode, scene);
+    /* Submeshes sharing the same textures are packed in the same mesh, so that they are drawn with a single draw call. */
+    std::vector<MeshBatch> batches;
+    processNode(scene->mRootNode, scene, batches);
+
+    for (const MeshBatch& batch : batches)
+        meshes_.push_back(Mesh(batch.vertices, batch.indices, batch.textures, batch.submeshes));
+
+    /* Bounding sphere centered in the axis-aligned bounding box. */
+    sphere_center_ = (aabb_min_ + aabb_max_) / 2.0f;
+    for (const MeshBatch& batch : batches)
+    {
+        for (const Mesh::Vertex& vertex : batch.vertices)
+            sphere_radius_ = std::max(sphere_radius_, glm::length(vertex.Position - sphere_center_));
+    }
+
+    if (!profile_.lod_ratios.empty())
+        buildLevelsOfDetail(batches);
+
+    /* Statistics of the meshes as uploaded to the GPU. */
+    num_indices = 0;
+    cache_misses = 0;
+    for (const MeshBatch& batch : batches)
+    {
+        for (const Mesh::Submesh& submesh : batch.submeshes)
+        {
+            statistics_.vertices_after += submesh.vertex_count;
+            num_indices += submesh.index_count;
+            cache_misses += countCacheMisses(batch.indices.data() + submesh.first_index, submesh.index_count, submesh.vertex_count);
+        }
+    }
+    statistics_.acmr_after = num_indices > 0 ? 3.0f * cache_misses / num_indices : 0.0f;
+
+    files_ = nullptr;
+
+    loaded_ = true;
 }
 
 
-void Model::processNode(aiNode* node, const aiScene* scene)
+void Model::processNode(aiNode* node, const aiScene* scene, std::vector<MeshBatch>& batches)
 {
     /* Process all the node's meshes (if any). */
     for (GLuint i = 0; i < node->mNumMeshes; ++i)
     {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes_.push_back(processMesh(mesh, scene));
+        processMesh(mesh, scene, batches);
     }
 
     /* Then do the same for each of its children. */
     for (GLuint i = 0; i < node->mNumChildren; ++i)
     {
-        processNode(node->mChildren[i], scene);
+        processNode(node->mChildren[i], scene, batches);
     }
 }
 
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
+void Model::processMesh(aiMesh* mesh, const aiScene* scene, std::vector<MeshBatch>& batches)
 {
+    if (mesh->mNumVertices == 0 || mesh->mNumFaces == 0)
+        return;
+
     std::vector<Mesh::Vertex> vertices;
     std::vector<GLuint> indices;
     std::vector<Mesh::Texture> textures;
@@ -96,6 +527,18 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
         vertex.Position = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
         vertex.Normal = glm::vec3(mesh->mNormals[i].x,  mesh->mNormals[i].y,  mesh->mNormals[i].z);
 
+        /* Grow the model axis-aligned bounding box. */
+        if (batches.empty() && i == 0)
+        {
+            aabb_min_ = vertex.Position;
+            aabb_max_ = vertex.Position;
+        }
+        else
+        {
+            aabb_min_ = glm::min(aabb_min_, vertex.Position);
+            aabb_max_ = glm::max(aabb_max_, vertex.Position);
+        }
+
         /* Does the mesh contain texture coordinates? */
         if (mesh->mTextureCoords[0])
         {
@@ -125,18 +568,530 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
     {
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 
-        std::vector<Mesh::Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
+        std::vector<Mesh::Texture> diffuseMaps = loadMaterialTextures(material, scene, aiTextureType_DIFFUSE, "texture_diffuse");
         textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
 
-        std::vector<Mesh::Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
+        std::vector<Mesh::Texture> specularMaps = loadMaterialTextures(material, scene, aiTextureType_SPECULAR, "texture_specular");
         textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
     }
 
-    return Mesh(vertices, indices, textures);
+    /* Reduce overdraw. */
+    if (profile_.optimize_overdraw)
+        optimizeOverdraw(vertices, indices);
+
+    /* Append the submesh to the batch having the same textures, if any. */
+    auto same_textures = [&textures](const MeshBatch& batch)
+    {
+        if (batch.textures.size() != textures.size())
+            return false;
+
+        for (size_t i = 0; i < textures.size(); ++i)
+        {
+            if (batch.textures[i].id != textures[i].id || batch.textures[i].type != textures[i].type)
+                return false;
+        }
+
+        return true;
+    };
+
+    auto batch = std::find_if(batches.begin(), batches.end(), same_textures);
+    if (batch == batches.end())
+    {
+        batches.push_back(MeshBatch());
+        batch = batches.end() - 1;
+        batch->textures = textures;
+    }
+
+    Mesh::Submesh submesh;
+    submesh.first_index = batch->indices.size();
+    submesh.index_count = indices.size();
+    submesh.base_vertex = batch->vertices.size();
+    submesh.vertex_count = vertices.size();
+
+    batch->vertices.insert(batch->vertices.end(), vertices.begin(), vertices.end());
+    batch->indices.insert(batch->indices.end(), indices.begin(), indices.end());
+    batch->submeshes.push_back(submesh);
+}
+
+
+void Model::optimizeOverdraw(const std::vector<Mesh::Vertex>& vertices, std::vector<GLuint>& indices)
+{
+    struct Cluster
+    {
+        size_t first_index;
+        size_t index_count;
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        GLfloat area;
+        GLfloat sort_key;
+    };
+
+    /* Minimum number of triangles per cluster, so that sorting does not break vertex cache locality too often. */
+    const size_t min_cluster_triangles = profile_.vertex_cache_size;
+
+    std::vector<Cluster> clusters;
+    std::vector<size_t> cache_timestamp(vertices.size(), 0);
+    size_t misses = 0;
+
+    glm::vec3 mesh_centroid(0.0f);
+    GLfloat mesh_area = 0.0f;
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        /* Simulate a FIFO vertex cache: a cluster starts whenever a triangle misses all of its vertices. */
+        size_t triangle_misses = 0;
+        for (size_t j = 0; j < 3; ++j)
+        {
+            GLuint v = indices[i + j];
+            if (cache_timestamp[v] == 0 || misses - cache_timestamp[v] >= profile_.vertex_cache_size)
+            {
+                ++misses;
+                cache_timestamp[v] = misses;
+                ++triangle_misses;
+            }
+        }
+
+        if (clusters.empty() || (triangle_misses == 3 && clusters.back().index_count >= 3 * min_cluster_triangles))
+        {
+            Cluster cluster;
+            cluster.first_index = i;
+            cluster.index_count = 0;
+            cluster.centroid = glm::vec3(0.0f);
+            cluster.normal = glm::vec3(0.0f);
+            cluster.area = 0.0f;
+            cluster.sort_key = 0.0f;
+
+            clusters.push_back(cluster);
+        }
+
+        const glm::vec3& p0 = vertices[indices[i]].Position;
+        const glm::vec3& p1 = vertices[indices[i + 1]].Position;
+        const glm::vec3& p2 = vertices[indices[i + 2]].Position;
+
+        /* The cross product norm is twice the triangle area. */
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        GLfloat area = glm::length(normal);
+        glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+        Cluster& cluster = clusters.back();
+        cluster.index_count += 3;
+        cluster.centroid += centroid * area;
+        cluster.normal += normal;
+        cluster.area += area;
+
+        mesh_centroid += centroid * area;
+        mesh_area += area;
+    }
+
+    if (clusters.size() < 2 || mesh_area <= 0.0f)
+        return;
+
+    mesh_centroid /= mesh_area;
+
+    /* Clusters far from the mesh centroid and facing outwards are likely to occlude the others, hence are drawn first. */
+    for (Cluster& cluster : clusters)
+    {
+        if (cluster.area > 0.0f)
+            cluster.sort_key = glm::dot(cluster.centroid / cluster.area - mesh_centroid, cluster.normal / cluster.area);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sort_key > b.sort_key; });
+
+    std::vector<GLuint> sorted_indices;
+    sorted_indices.reserve(indices.size());
+    for (const Cluster& cluster : clusters)
+        sorted_indices.insert(sorted_indices.end(), indices.begin() + cluster.first_index, indices.begin() + cluster.first_index + cluster.index_count);
+
+    /* Trailing indices not forming a triangle, if any. */
+    sorted_indices.insert(sorted_indices.end(), indices.begin() + sorted_indices.size(), indices.end());
+
+    indices.swap(sorted_indices);
+}
+
+
+size_t Model::countCacheMisses(const GLuint* indices, const size_t num_indices, const size_t num_vertices)
+{
+    /* A vertex is in a FIFO cache if less than cache size vertices were inserted after it. */
+    std::vector<size_t> cache_timestamp(num_vertices, 0);
+    size_t misses = 0;
+
+    for (size_t i = 0; i < num_indices; ++i)
+    {
+        GLuint v = indices[i];
+        if (v >= num_vertices)
+            continue;
+
+        if (cache_timestamp[v] == 0 || misses - cache_timestamp[v] >= profile_.vertex_cache_size)
+        {
+            ++misses;
+            cache_timestamp[v] = misses;
+        }
+    }
+
+    return misses;
+}
+
+
+void Model::buildLevelsOfDetail(const std::vector<MeshBatch>& batches)
+{
+    std::vector<GLfloat> ratios;
+    for (const GLfloat ratio : profile_.lod_ratios)
+    {
+        if (ratio > 0.0f && ratio < 1.0f)
+            ratios.push_back(ratio);
+    }
+    std::sort(ratios.begin(), ratios.end(), std::greater<GLfloat>());
+
+    lod_errors_.assign(ratios.size() + 1, 0.0f);
+
+    for (size_t b = 0; b < batches.size(); ++b)
+    {
+        const MeshBatch& batch = batches[b];
+
+        std::vector<std::vector<GLuint>> lod_indices(ratios.size());
+        std::vector<std::vector<Mesh::Submesh>> lod_submeshes(ratios.size());
+
+        for (const Mesh::Submesh& submesh : batch.submeshes)
+        {
+            std::vector<size_t> target_triangles;
+            for (const GLfloat ratio : ratios)
+                target_triangles.push_back(static_cast<size_t>(std::ceil(ratio * submesh.index_count / 3)));
+
+            std::vector<GLfloat> errors;
+            std::vector<std::vector<GLuint>> simplified = simplifyMesh(batch.vertices.data() + submesh.base_vertex, submesh.vertex_count,
+                                                                       batch.indices.data() + submesh.first_index, submesh.index_count,
+                                                                       target_triangles, errors);
+
+            for (size_t l = 0; l < ratios.size(); ++l)
+            {
+                Mesh::Submesh lod_submesh = submesh;
+                lod_submesh.first_index = lod_indices[l].size();
+                lod_submesh.index_count = simplified[l].size();
+
+                lod_indices[l].insert(lod_indices[l].end(), simplified[l].begin(), simplified[l].end());
+                lod_submeshes[l].push_back(lod_submesh);
+
+                lod_errors_[l + 1] = std::max(lod_errors_[l + 1], errors[l]);
+            }
+        }
+
+        for (size_t l = 0; l < ratios.size(); ++l)
+            meshes_[b].addLevelOfDetail(lod_indices[l], lod_submeshes[l]);
+    }
+
+    /* A coarser level of detail cannot be more accurate than a finer one. */
+    for (size_t l = 1; l < lod_errors_.size(); ++l)
+        lod_errors_[l] = std::max(lod_errors_[l], lod_errors_[l - 1]);
+}
+
+
+std::vector<std::vector<GLuint>> Model::simplifyMesh
+(
+    const Mesh::Vertex* vertices,
+    const size_t num_vertices,
+    const GLuint* indices,
+    const size_t num_indices,
+    const std::vector<size_t>& target_triangles,
+    std::vector<GLfloat>& errors
+)
+{
+    /* Symmetric 4x4 quadric matrix, storing the upper triangle only. */
+    typedef std::array<double, 10> Quadric;
+
+    auto add_plane = [](Quadric& q, const glm::vec3& n, const double d)
+    {
+        q[0] += n.x * n.x; q[1] += n.x * n.y; q[2] += n.x * n.z; q[3] += n.x * d;
+                           q[4] += n.y * n.y; q[5] += n.y * n.z; q[6] += n.y * d;
+                                              q[7] += n.z * n.z; q[8] += n.z * d;
+                                                                 q[9] += d * d;
+    };
+
+    auto evaluate = [](const Quadric& q, const glm::vec3& v)
+    {
+        return         q[0] * v.x * v.x + 2.0 * q[1] * v.x * v.y + 2.0 * q[2] * v.x * v.z + 2.0 * q[3] * v.x
+                     + q[4] * v.y * v.y + 2.0 * q[5] * v.y * v.z + 2.0 * q[6] * v.y
+                     + q[7] * v.z * v.z + 2.0 * q[8] * v.z
+                     + q[9];
+    };
+
+    /* Weld vertices by position, so that triangles having different normals or texture coordinates are still connected.
+       Positions shared by vertices whose normals or texture coordinates differ lie on a seam, e.g. of the texture atlas, and are never removed,
+       since the triangles on either side of the seam would be stretched over attributes of the other side. */
+    const GLfloat attribute_tolerance = 1e-4f;
+
+    std::vector<glm::vec3> positions;
+    std::vector<GLuint> representative;
+    std::vector<bool> seam;
+    std::vector<GLuint> position_id(num_vertices);
+    std::map<std::tuple<GLfloat, GLfloat, GLfloat>, GLuint> position_lookup;
+    for (GLuint v = 0; v < num_vertices; ++v)
+    {
+        const glm::vec3& p = vertices[v].Position;
+
+        auto inserted = position_lookup.insert(std::make_pair(std::make_tuple(p.x, p.y, p.z), static_cast<GLuint>(positions.size())));
+        if (inserted.second)
+        {
+            positions.push_back(p);
+            representative.push_back(v);
+            seam.push_back(false);
+        }
+        else
+        {
+            const Mesh::Vertex& other = vertices[representative[inserted.first->second]];
+            if (glm::length(vertices[v].Normal - other.Normal) > attribute_tolerance ||
+                glm::length(vertices[v].TexCoords - other.TexCoords) > attribute_tolerance)
+                seam[inserted.first->second] = true;
+        }
+
+        position_id[v] = inserted.first->second;
+    }
+
+    /* Triangles store both position ids, used by the simplification, and vertex indices, used for the output. */
+    struct Triangle
+    {
+        GLuint p[3];
+        GLuint v[3];
+        bool removed;
+    };
+
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<GLuint>> position_triangles(positions.size());
+    std::vector<Quadric> quadrics(positions.size(), Quadric());
+    std::map<std::pair<GLuint, GLuint>, GLuint> edge_count;
+
+    for (size_t i = 0; i + 2 < num_indices; i += 3)
+    {
+        Triangle triangle;
+        triangle.removed = false;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            triangle.v[k] = indices[i + k];
+            triangle.p[k] = position_id[indices[i + k]];
+        }
+
+        /* Degenerate triangles are not visible. */
+        if (triangle.p[0] == triangle.p[1] || triangle.p[1] == triangle.p[2] || triangle.p[0] == triangle.p[2])
+            continue;
+
+        glm::vec3 normal = glm::cross(positions[triangle.p[1]] - positions[triangle.p[0]], positions[triangle.p[2]] - positions[triangle.p[0]]);
+        GLfloat length = glm::length(normal);
+        if (length > 0.0f)
+        {
+            normal /= length;
+            for (size_t k = 0; k < 3; ++k)
+                add_plane(quadrics[triangle.p[k]], normal, -glm::dot(normal, positions[triangle.p[0]]));
+        }
+
+        for (size_t k = 0; k < 3; ++k)
+        {
+            GLuint a = triangle.p[k];
+            GLuint b = triangle.p[(k + 1) % 3];
+            ++edge_count[std::make_pair(std::min(a, b), std::max(a, b))];
+
+            position_triangles[a].push_back(triangles.size());
+        }
+
+        triangles.push_back(triangle);
+    }
+
+    /* Border edges are constrained by planes orthogonal to their triangle, so that open borders are preserved. */
+    for (const Triangle& triangle : triangles)
+    {
+        glm::vec3 normal = glm::cross(positions[triangle.p[1]] - positions[triangle.p[0]], positions[triangle.p[2]] - positions[triangle.p[0]]);
+
+        for (size_t k = 0; k < 3; ++k)
+        {
+            GLuint a = triangle.p[k];
+            GLuint b = triangle.p[(k + 1) % 3];
+            if (edge_count[std::make_pair(std::min(a, b), std::max(a, b))] != 1)
+                continue;
+
+            glm::vec3 border_normal = glm::cross(positions[b] - positions[a], normal);
+            GLfloat length = glm::length(border_normal);
+            if (length > 0.0f)
+            {
+                border_normal /= length;
+                add_plane(quadrics[a], border_normal, -glm::dot(border_normal, positions[a]));
+                add_plane(quadrics[b], border_normal, -glm::dot(border_normal, positions[a]));
+            }
+        }
+    }
+
+    /* Candidate collapses are sorted by cost. Entries are invalidated by increasing the version of their vertices. */
+    struct Collapse
+    {
+        double cost;
+        GLuint keep;
+        GLuint remove;
+        GLuint keep_version;
+        GLuint remove_version;
+
+        bool operator>(const Collapse& other) const { return cost > other.cost; }
+    };
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+    std::vector<GLuint> version(positions.size(), 0);
+    std::vector<bool> alive(positions.size(), true);
+
+    auto push_collapse = [&](const GLuint a, const GLuint b)
+    {
+        /* Seam vertices are only collapsed onto. */
+        if (seam[a] && seam[b])
+            return;
+
+        Quadric q;
+        for (size_t i = 0; i < q.size(); ++i)
+            q[i] = quadrics[a][i] + quadrics[b][i];
+
+        double cost_a = evaluate(q, positions[a]);
+        double cost_b = evaluate(q, positions[b]);
+
+        const bool keep_a = seam[a] || (!seam[b] && cost_a <= cost_b);
+
+        Collapse collapse;
+        collapse.keep = keep_a ? a : b;
+        collapse.remove = keep_a ? b : a;
+        collapse.cost = std::max(keep_a ? cost_a : cost_b, 0.0);
+        collapse.keep_version = version[collapse.keep];
+        collapse.remove_version = version[collapse.remove];
+
+        collapses.push(collapse);
+    };
+
+    for (const auto& edge : edge_count)
+        push_collapse(edge.first.first, edge.first.second);
+
+    size_t live_triangles = triangles.size();
+    double max_cost = 0.0;
+
+    std::vector<std::vector<GLuint>> lods;
+    errors.clear();
+
+    for (const size_t target : target_triangles)
+    {
+        while (live_triangles > target && !collapses.empty())
+        {
+            Collapse collapse = collapses.top();
+            collapses.pop();
+
+            if (!alive[collapse.keep] || !alive[collapse.remove] ||
+                version[collapse.keep] != collapse.keep_version || version[collapse.remove] != collapse.remove_version)
+                continue;
+
+            /* Reject collapses flipping the orientation of any triangle. */
+            bool flips = false;
+            for (const GLuint t : position_triangles[collapse.remove])
+            {
+                const Triangle& triangle = triangles[t];
+                if (triangle.removed ||
+                    triangle.p[0] == collapse.keep || triangle.p[1] == collapse.keep || triangle.p[2] == collapse.keep)
+                    continue;
+
+                glm::vec3 p[3];
+                glm::vec3 q[3];
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    p[k] = positions[triangle.p[k]];
+                    q[k] = triangle.p[k] == collapse.remove ? positions[collapse.keep] : p[k];
+                }
+
+                if (glm::dot(glm::cross(p[1] - p[0], p[2] - p[0]), glm::cross(q[1] - q[0], q[2] - q[0])) <= 0.0f)
+                {
+                    flips = true;
+                    break;
+                }
+            }
+            if (flips)
+                continue;
+
+            /* The removed vertex has the same attributes in all its triangles, hence the triangles around it share a single vertex of the kept position,
+               possibly one of the vertices of a seam, whose attributes are continuous with the ones of the removed vertex. */
+            GLuint keep_vertex = representative[collapse.keep];
+            for (const GLuint t : position_triangles[collapse.remove])
+            {
+                const Triangle& triangle = triangles[t];
+                if (triangle.removed)
+                    continue;
+
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    if (triangle.p[k] == collapse.keep)
+                        keep_vertex = triangle.v[k];
+                }
+            }
+
+            /* Collapse the removed vertex onto the kept one. */
+            for (const GLuint t : position_triangles[collapse.remove])
+            {
+                Triangle& triangle = triangles[t];
+                if (triangle.removed)
+                    continue;
+
+                if (triangle.p[0] == collapse.keep || triangle.p[1] == collapse.keep || triangle.p[2] == collapse.keep)
+                {
+                    triangle.removed = true;
+                    --live_triangles;
+                    continue;
+                }
+
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    if (triangle.p[k] == collapse.remove)
+                    {
+                        triangle.p[k] = collapse.keep;
+                        triangle.v[k] = keep_vertex;
+                    }
+                }
+
+                position_triangles[collapse.keep].push_back(t);
+            }
+
+            for (size_t i = 0; i < quadrics[collapse.keep].size(); ++i)
+                quadrics[collapse.keep][i] += quadrics[collapse.remove][i];
+
+            alive[collapse.remove] = false;
+            position_triangles[collapse.remove].clear();
+            ++version[collapse.keep];
+
+            max_cost = std::max(max_cost, collapse.cost);
+
+            /* Update the candidate collapses around the kept vertex. */
+            std::vector<GLuint>& kept_triangles = position_triangles[collapse.keep];
+            kept_triangles.erase(std::remove_if(kept_triangles.begin(), kept_triangles.end(), [&triangles](const GLuint t) { return triangles[t].removed; }),
+                                 kept_triangles.end());
+
+            std::vector<GLuint> neighbours;
+            for (const GLuint t : kept_triangles)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    GLuint n = triangles[t].p[k];
+                    if (n != collapse.keep && std::find(neighbours.begin(), neighbours.end(), n) == neighbours.end())
+                        neighbours.push_back(n);
+                }
+            }
+
+            for (const GLuint n : neighbours)
+                push_collapse(collapse.keep, n);
+        }
+
+        std::vector<GLuint> lod;
+        lod.reserve(3 * live_triangles);
+        for (const Triangle& triangle : triangles)
+        {
+            if (!triangle.removed)
+                lod.insert(lod.end(), triangle.v, triangle.v + 3);
+        }
+
+        lods.push_back(lod);
+        errors.push_back(static_cast<GLfloat>(std::sqrt(max_cost)));
+    }
+
+    return lods;
 }
 
 
-std::vector<Mesh::Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName)
+std::vector<Mesh::Texture> Model::loadMaterialTextures(aiMaterial* mat, const aiScene* scene, aiTextureType type, std::string typeName)
 {
     std::vector<Mesh::Texture> textures;
     for (GLuint i = 0; i < mat->GetTextureCount(type); ++i)
@@ -159,13 +1114,22 @@ std::vector<Mesh::Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextur
         {
             Mesh::Texture texture;
 
-            texture.id = TextureFromFile(str.C_Str(), directory_);
+            /* Texture objects are created when the model is uploaded. */
+            texture.id = 0;
             texture.type = typeName;
             texture.path = str;
             textures.push_back(texture);
 
             /* Add to loaded textures. */
             textures_loaded_.push_back(texture);
+            /* Embedded textures are referenced as "*<index>". */
+            if (str.C_Str()[0] == '*')
+            {
+                unsigned int index = std::strtoul(str.C_Str() + 1, nullptr, 10);
+                texture_sources_.push_back(index < scene->mNumTextures ? TextureFromEmbedded(scene->mTextures[index]) : TextureSource());
+            }
+            else
+                texture_sources_.push_back(TextureFromFile(str.C_Str(), directory_));
         }
     }
 
@@ -173,26 +1137,86 @@ std::vector<Mesh::Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextur
 }
 
 
-GLint Model::TextureFromFile(const char* path, std::string directory)
+Model::TextureSource Model::TextureFromFile(const char* path, std::string directory)
 {
     std::string filename = directory + "/" + std::string(path);
-    cv::Mat image = cv::imread(filename, cv::IMREAD_ANYCOLOR);
 
-    /* Generate texture ID and load texture data. */
-    GLuint textureID;
-    glGenTextures(1, &textureID);
+    TextureCache& texture_cache = TextureCache::getInstance();
+
+    TextureSource source;
+
+    const MemoryFile* memory_file = nullptr;
+    if (files_ != nullptr)
+    {
+        auto iter_file = files_->find(normalizePath(filename));
+        if (iter_file != files_->end())
+            memory_file = &(iter_file->second);
+    }
+
+    if (memory_file != nullptr)
+    {
+        source.encoded.assign(memory_file->data, memory_file->data + memory_file->size);
+        source.key = TextureCache::getKey(source.encoded.data(), source.encoded.size());
+    }
+    else
+    {
+        source.path = filename;
+
+        /* Files already cached are not read again. */
+        std::string canonical_path = TextureCache::getCanonicalPath(filename);
+        if (!canonical_path.empty() && texture_cache.findPath(canonical_path, source.key) && texture_cache.contains(source.key))
+            return source;
+
+        std::ifstream file(filename, std::ios::binary);
+        source.encoded.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        source.key = TextureCache::getKey(source.encoded.data(), source.encoded.size());
+
+        if (!canonical_path.empty())
+            texture_cache.addPath(canonical_path, source.key);
+    }
+
+    /* Decode now, i.e. possibly on a separate thread, unless already cached. Files can be read again if needed at upload. */
+    if (!texture_cache.contains(source.key))
+        source.image = decodeTexture(source);
+
+    if (!source.image.empty() || !source.path.empty())
+        source.encoded.clear();
+
+    return source;
+}
+
+
+Model::TextureSource Model::TextureFromEmbedded(const aiTexture* texture)
+{
+    TextureSource source;
+
+    /* Compressed textures, e.g. PNG or JPEG, are stored as mWidth bytes. */
+    if (texture->mHeight == 0)
+    {
+        source.key = TextureCache::getKey(reinterpret_cast<const char*>(texture->pcData), texture->mWidth);
+        source.image = cv::imdecode(cv::Mat(1, static_cast<int>(texture->mWidth), CV_8UC1, texture->pcData), cv::IMREAD_ANYCOLOR);
+
+        return source;
+    }
+
+    /* Uncompressed textures are stored as BGRA texels. */
+    source.key = TextureCache::getKey(reinterpret_cast<const char*>(texture->pcData), texture->mWidth * texture->mHeight * sizeof(aiTexel));
+    cv::cvtColor(cv::Mat(texture->mHeight, texture->mWidth, CV_8UC4, texture->pcData), source.image, cv::COLOR_BGRA2BGR);
+
+    return source;
+}
+
+
+cv::Mat Model::decodeTexture(const TextureSource& source)
+{
+    if (!source.image.empty())
+        return source.image;
 
-    /* Assign texture to ID. */
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.cols, image.rows, 0, GL_RGB, GL_UNSIGNED_BYTE, image.ptr());
-    glGenerateMipmap(GL_TEXTURE_2D);
+    if (!source.encoded.empty())
+        return cv::imdecode(cv::Mat(1, static_cast<int>(source.encoded.size()), CV_8UC1, const_cast<char*>(source.encoded.data())), cv::IMREAD_ANYCOLOR);
 
-    /* Parameters. */
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if (!source.path.empty())
+        return cv::imread(source.path, cv::IMREAD_ANYCOLOR);
 
-    return textureID;
+    return cv::Mat();
 }
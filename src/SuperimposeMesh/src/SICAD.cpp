@@ -7,9 +7,17 @@
 
 #include "SuperimposeMesh/SICAD.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <iostream>
+#include <sstream>
 #include <exception>
 #include <string>
+#include <unordered_map>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -22,7 +30,10 @@
 
 
 int SICAD::class_counter_ = 0;
+
+GLFWwindow* SICAD::shared_window_ = nullptr;
 GLsizei SICAD::renderbuffer_size_ = 0;
+std::string SICAD::calibration_file_;
 
 
 SICAD::SICAD
@@ -82,7 +93,45 @@ SICAD::SICAD
     const GLint num_images,
     const std::string& shader_folder,
     const std::vector<float>& ogl_to_cam
-)
+) :
+    SICAD(objfile_map, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, num_images, shader_folder, ogl_to_cam, Model::ImportProfile())
+{ }
+
+
+SICAD::SICAD
+(
+    const ModelPathContainer& objfile_map,
+    const GLsizei cam_width,
+    const GLsizei cam_height,
+    const GLfloat cam_fx,
+    const GLfloat cam_fy,
+    const GLfloat cam_cx,
+    const GLfloat cam_cy,
+    const GLint num_images,
+    const std::string& shader_folder,
+    const std::vector<float>& ogl_to_cam,
+    const Model::ImportProfile& import_profile
+) :
+    SICAD(objfile_map, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, num_images, shader_folder, ogl_to_cam, import_profile, Model::MemoryFileContainer())
+{ }
+
+
+SICAD::SICAD
+(
+    const ModelPathContainer& objfile_map,
+    const GLsizei cam_width,
+    const GLsizei cam_height,
+    const GLfloat cam_fx,
+    const GLfloat cam_fy,
+    const GLfloat cam_cx,
+    const GLfloat cam_cy,
+    const GLint num_images,
+    const std::string& shader_folder,
+    const std::vector<float>& ogl_to_cam,
+    const Model::ImportProfile& import_profile,
+    const Model::MemoryFileContainer& model_files
+) :
+    import_profile_(import_profile)
 {
     if (ogl_to_cam.size() != 4)
         throw std::runtime_error("ERROR::SICAD::CTOR\nERROR:\n\tWrong size provided for ogl_to_cam.\n\tShould be 4, was given " + std::to_string(ogl_to_cam.size()) + ".");
@@ -110,13 +159,25 @@ SICAD::SICAD
 
 
     /* Create window to create context and enquire OpenGL for the maximum size of the renderbuffer */
-    window_ = glfwCreateWindow(1, 1, "OpenGL window", nullptr, nullptr);
+    /* Contexts share their objects, so that textures are shared by the models of all the SICAD objects. */
+    window_ = glfwCreateWindow(1, 1, "OpenGL window", nullptr, shared_window_);
     if (window_ == nullptr)
     {
         glfwTerminate();
         throw std::runtime_error("ERROR::SICAD::CTOR\nERROR:\n\tFailed to create GLFW window.");
     }
 
+    /* Models updated at runtime are uploaded by the import threads on a hidden context sharing its objects with the rendering one. */
+    upload_window_ = glfwCreateWindow(1, 1, "OpenGL upload window", nullptr, window_);
+    if (upload_window_ == nullptr)
+    {
+        glfwDestroyWindow(window_);
+        throw std::runtime_error("ERROR::SICAD::CTOR\nERROR:\n\tFailed to create GLFW upload window.");
+    }
+
+    if (shared_window_ == nullptr)
+        shared_window_ = window_;
+
     /* Make the OpenGL context of window the current one handled by this thread. */
     glfwMakeContextCurrent(window_);
 
@@ -126,26 +187,8 @@ SICAD::SICAD
     std::cout << log_ID_ << "Max renderbuffer size is " + std::to_string(renderbuffer_size_) + "x" + std::to_string(renderbuffer_size_) + " size." << std::endl;
 
 
-    /* Given image size */
-    image_width_ = cam_width;
-    image_height_ = cam_height;
-    std::cout << log_ID_ << "Given image size " + std::to_string(image_width_) + "x" + std::to_string(image_height_) + "." << std::endl;
-
-
-    /* Compute the maximum number of images that can be rendered conditioned on the maximum renderbuffer size */
-    factorize_int(num_images, std::floor(renderbuffer_size_ / image_width_), std::floor(renderbuffer_size_ / image_height_), tiles_cols_, tiles_rows_);
-    tiles_num_ = tiles_rows_ * tiles_cols_;
-    std::cout << log_ID_ << "Required to render " + std::to_string(num_images) + " image(s)." << std::endl;
-    std::cout << log_ID_ << "Allowed number or rendered images is " + std::to_string(tiles_num_) + " (" + std::to_string(tiles_rows_) + "x" + std::to_string(tiles_cols_) + " grid)." << std::endl;
-
-    /* Set framebuffer size. */
-    framebuffer_width_ = image_width_ * tiles_cols_;
-    framebuffer_height_ = image_height_ * tiles_rows_;
-
-    /* Set rendered image size. May vary in HDPI monitors. */
-    tile_img_width_ = framebuffer_width_ / tiles_cols_;
-    tile_img_height_ = framebuffer_height_ / tiles_rows_;
-    std::cout << log_ID_ << "The rendered image size is " + std::to_string(tile_img_width_) + "x" + std::to_string(tile_img_height_) + "." << std::endl;
+    /* Lay out the render grid. */
+    setUpTiles(num_images, cam_width, cam_height);
 
 
     /* Initialize GLEW to use the OpenGL implementation provided by the videocard manufacturer. */
@@ -154,6 +197,12 @@ SICAD::SICAD
         throw std::runtime_error("ERROR::SICAD::CTOR\nERROR:\n\tFailed to initialize GLEW.");
 
 
+    /* Use the render configuration found by a previous calibration on this machine, if any. */
+    if (readCalibration(calibration_))
+        std::cout << log_ID_ << "Using the calibrated render configuration." << std::endl;
+    applyCalibration();
+
+
     /* Set GL property. */
     glfwPollEvents();
     main_thread_id_ = std::this_thread::get_id();
@@ -196,6 +245,9 @@ SICAD::SICAD
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         throw std::runtime_error("ERROR::SICAD::CTOR::\nERROR:\n\tCustom framebuffer could not be created.");
 
+    attachment_width_ = framebuffer_width_;
+    attachment_height_ = framebuffer_height_;
+
 
     /* Enable depth and scissor test. */
     glEnable(GL_DEPTH_TEST);
@@ -271,15 +323,7 @@ SICAD::SICAD
 
     /* Crate the Pixel Buffer Objects for reading rendered images and manipulate data directly on GPU. */
     glGenBuffers(2, pbo_);
-    unsigned int number_of_channel = 3;
-
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[0]);
-    glBufferData(GL_PIXEL_PACK_BUFFER, framebuffer_width_ * framebuffer_height_ * number_of_channel, 0, GL_STREAM_READ);
-
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[1]);
-    glBufferData(GL_PIXEL_PACK_BUFFER, framebuffer_width_ * framebuffer_height_ * number_of_channel, 0, GL_STREAM_READ);
-
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    allocatePBOs();
 
     /* FIXME
      * Delete std::nothrow and change try-catch logic.
@@ -288,6 +332,8 @@ SICAD::SICAD
      * Add std::make_unique in an utility header.
      */
     /* Crate background shader program. */
+    std::chrono::steady_clock::time_point shaders_start = std::chrono::steady_clock::now();
+
     std::cout << log_ID_ << "Setting up background shader." << std::endl;
 
     try
@@ -352,6 +398,10 @@ SICAD::SICAD
 
     std::cout << log_ID_ << "Axis frame shader succesfully set up!" << std::endl;
 
+    std::chrono::duration<double, std::milli> shaders_time = std::chrono::steady_clock::now() - shaders_start;
+    std::cout << log_ID_ << "Shaders set up in " << shaders_time.count() << " ms"
+                         << (shader_cad_->is_cached() && shader_mesh_texture_->is_cached() ? " from the program binary cache." : ".") << std::endl;
+
 
     /* Load models. */
     for (const ModelPathElement& pair : objfile_map)
@@ -361,10 +411,17 @@ SICAD::SICAD
         {
             std::cout << log_ID_ << "Loading " + pair.first + " model for OpenGL rendering from " << pair.second << "." << std::endl;
 
-            model_obj_[pair.first] = new (std::nothrow) Model(pair.second.c_str());
+            model_obj_[pair.first] = new (std::nothrow) Model(pair.second.c_str(), model_files, import_profile_);
 
             if (model_obj_[pair.first] == nullptr)
                 throw std::runtime_error("ERROR::SICAD::CTOR\nERROR:\n\t" + pair.first + " model file from " + pair.second + " not found!");
+
+            const Model::ImportStatistics& statistics = model_obj_[pair.first]->getImportStatistics();
+            std::cout << log_ID_ << "Imported " + pair.first + " model with " + std::to_string(statistics.vertices_after) + " vertices (were " + std::to_string(statistics.vertices_before) + ") "
+                                 << "and vertex cache ACMR " << statistics.acmr_after << " (was " << statistics.acmr_before << ")." << std::endl;
+
+            for (size_t lod = 1; lod < model_obj_[pair.first]->getLevelsOfDetail(); ++lod)
+                std::cout << log_ID_ << "Level of detail " << lod << " of " + pair.first + " model has silhouette error " << model_obj_[pair.first]->getLevelOfDetailError(lod) << "." << std::endl;
         }
         else
         {
@@ -373,6 +430,12 @@ SICAD::SICAD
         }
     }
 
+    /* Upload only the vertex attributes read by the shaders. */
+    updateVertexLayouts();
+
+    for (const ModelElement& pair : model_obj_)
+        (pair.second)->upload();
+
     back_proj_ = glm::ortho(-1.001f, 1.001f, -1.001f, 1.001f, 0.0f, far_*100.f);
 
     glfwMakeContextCurrent(nullptr);
@@ -401,18 +464,47 @@ SICAD::~SICAD()
     std::cout << log_ID_ << "Deallocating OpenGL resources..." << std::endl;
 
 
+    /* Wait for the models being imported, then delete the ones never swapped in. */
+    {
+        std::unique_lock<std::mutex> lock(model_mutex_);
+        model_imported_.wait(lock, [this] { return models_importing_ == 0; });
+    }
+
+
     glfwMakeContextCurrent(window_);
 
 
+    for (const ModelElement& pair : pending_models_)
+    {
+        if (pair.second != nullptr)
+        {
+            glDeleteSync(pending_fences_[pair.first]);
+            (pair.second)->release();
+            delete pair.second;
+        }
+    }
+
+    for (const std::pair<Model*, GLsync>& discarded : discarded_models_)
+    {
+        glDeleteSync(discarded.second);
+        (discarded.first)->release();
+        delete discarded.first;
+    }
+
+
     for (const ModelElement& pair : model_obj_)
     {
         std::cout << log_ID_ << "Deleting OpenGL "+ pair.first+" model." << std::endl;
+        (pair.second)->release();
         delete pair.second;
     }
 
 
     glDeleteTextures(1, &texture_color_buffer_);
     glDeleteTextures(1, &texture_depth_buffer_);
+    glDeleteTextures(1, &texture_instance_id_);
+    glDeleteTextures(1, &texture_correspondence_);
+    glDeleteTextures(1, &texture_point_cloud_);
     glDeleteFramebuffers(1, &fbo_);
     glDeleteVertexArrays(1, &vao_background_);
     glDeleteBuffers(1, &ebo_background_);
@@ -421,17 +513,43 @@ SICAD::~SICAD()
     glDeleteBuffers(1, &vbo_frame_);
     glDeleteTextures(1, &texture_background_);
     glDeleteBuffers(2, pbo_);
+    glDeleteBuffers(static_cast<GLsizei>(batch_pbo_.size()), batch_pbo_.data());
+    glDeleteFramebuffers(1, &static_fbo_);
+    glDeleteTextures(1, &texture_static_color_);
+    glDeleteTextures(1, &texture_static_depth_);
+    glDeleteFramebuffers(1, &render_cache_fbo_);
+    glDeleteTextures(1, &texture_render_cache_color_);
+    glDeleteTextures(1, &texture_render_cache_depth_);
+    for (std::pair<const GLfloat, ScaleLayers>& layers : scale_layers_)
+    {
+        glDeleteFramebuffers(1, &layers.second.static_fbo);
+        glDeleteTextures(1, &layers.second.texture_static_color);
+        glDeleteTextures(1, &layers.second.texture_static_depth);
+        glDeleteFramebuffers(1, &layers.second.render_cache_fbo);
+        glDeleteTextures(1, &layers.second.texture_render_cache_color);
+        glDeleteTextures(1, &layers.second.texture_render_cache_depth);
+    }
+    glDeleteFramebuffers(1, &tensor_fbo_);
+    glDeleteTextures(1, &texture_tensor_);
+    glDeleteVertexArrays(1, &vao_tensor_);
+    glDeleteFramebuffers(1, &statistics_fbo_);
+    glDeleteTextures(2, texture_statistics_);
+    glDeleteVertexArrays(1, &vao_statistics_);
+    glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
 
 
     std::cout << log_ID_ << "Deleting OpenGL shaders." << std::endl;
     delete shader_background_;
     delete shader_cad_;
     delete shader_frame_;
+    tensor_shader_.reset();
+    statistics_shader_.reset();
 
 
     std::cout << log_ID_ << "Closing OpenGL window/context." << std::endl;
     glfwSetWindowShouldClose(window_, GL_TRUE);
     glfwMakeContextCurrent(nullptr);
+    glfwDestroyWindow(upload_window_);
 
 
     class_counter_--;
@@ -439,6 +557,8 @@ SICAD::~SICAD()
     {
         std::cout << log_ID_ << "Terminating GLFW." << std::endl;
         glfwTerminate();
+
+        shared_window_ = nullptr;
     }
 
 
@@ -468,26 +588,18 @@ bool SICAD::superimpose
     cv::Mat& img
 )
 {
+    if (roi_ && (instance_id_ || correspondence_ || point_cloud_))
+    {
+        std::cerr << "ERROR::SICAD::SUPERIMPOSE\nERROR:\n\tROIs are not available with instance IDs, correspondences and point clouds." << std::endl;
+        return false;
+    }
+
     glfwMakeContextCurrent(window_);
 
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
 
-    /* Render in the upper-left-most tile of the render grid */
-    glViewport(0,               framebuffer_height_ - tile_img_height_,
-               tile_img_width_, tile_img_height_                       );
-    glScissor (0,               framebuffer_height_ - tile_img_height_,
-               tile_img_width_, tile_img_height_                       );
-
-    /* Clear the colorbuffer. */
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    /* Draw the background picture. */
-    if (getBackgroundOpt())
-        renderBackground(img);
-
-    /* View mesh filled or as wireframe. */
-    setWireframe(getWireframeOpt());
+    /* Swap in the models updated since the last frame. */
+    swapModels();
 
     /* View transformation matrix. */
     glm::mat4 view = getViewTransformationMatrix(cam_x, cam_o);
@@ -505,59 +617,50 @@ bool SICAD::superimpose
     glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
     shader_frame_->uninstall();
 
-    /* Model transformation matrix. */
-    for (const ModelPoseContainerElement& pair : objpos_map)
+    /* Render the static scene, unless cached. */
+    updateStaticScene(view);
+
+    /* Render in the upper-left-most tile of the render grid */
+    glViewport(0,               framebuffer_height_ - tile_img_height_,
+               tile_img_width_, tile_img_height_                       );
+    glScissor (0,               framebuffer_height_ - tile_img_height_,
+               tile_img_width_, tile_img_height_                       );
+
+    /* Clear, draw and read back only the ROI, if enabled. */
+    rois_.assign(roi_ ? 1 : 0, cv::Rect());
+    roi_atlas_.clear();
+    roi_images_.clear();
+    if (roi_)
     {
-        const double* pose = pair.second.data();
+        rois_[0] = getTileRoi(objpos_map, view);
+        scissorRoi(0, rois_[0]);
+    }
 
-        glm::mat4 model = glm::rotate(glm::mat4(1.0f), static_cast<float>(pose[6]), glm::vec3(static_cast<float>(pose[3]), static_cast<float>(pose[4]), static_cast<float>(pose[5])));
-        model[3][0] = pose[0];
-        model[3][1] = pose[1];
-        model[3][2] = pose[2];
+    /* Clear the colorbuffer, unless masked, and the depthbuffer. */
+    clearBuffers();
 
-        auto iter_model = model_obj_.find(pair.first);
-        if (iter_model != model_obj_.end())
-        {
-            if ((iter_model->second)->has_texture())
-            {
-                shader_mesh_texture_->install();
-                glUniformMatrix4fv(glGetUniformLocation(shader_mesh_texture_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+    /* Draw the background picture. */
+    if (getBackgroundOpt() && render_mode_ == RenderMode::color)
+        renderBackground(img);
 
-                (iter_model->second)->Draw(*shader_mesh_texture_);
+    /* View mesh filled or as wireframe. */
+    setWireframe(getWireframeOpt());
 
-                shader_mesh_texture_->uninstall();
-            }
-            else
-            {
-                shader_cad_->install();
-                glUniformMatrix4fv(glGetUniformLocation(shader_cad_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+    /* Draw the mesh models. */
+    drawStaticScene(view, 0);
 
-                (iter_model->second)->Draw(*shader_cad_);
+    empty_tiles_.assign(tiles_num_, true);
+    object_statistics_.assign(statistics_ ? tiles_num_ : 0, std::vector<ObjectStatistics>());
+    empty_tiles_[0] = !renderModels(objpos_map, view);
 
-                shader_cad_->uninstall();
-            }
-        }
-        else if (pair.first == "frame")
-        {
-            shader_frame_->install();
-            glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(vao_frame_);
-            glDrawArrays(GL_LINES, 0, 6);
-            glBindVertexArray(0);
-            shader_frame_->uninstall();
-        }
-    }
+    if (statistics_)
+        queueStatistics(objpos_map, view, 0, 0, roi_);
 
     /* Read before swap. glReadPixels read the current framebuffer, i.e. the back one. */
-    /* See: http://stackoverflow.com/questions/16809833/opencv-image-loading-for-opengl-texture#16812529
-       and http://stackoverflow.com/questions/9097756/converting-data-from-glreadpixels-to-opencvmat#9098883 */
-    cv::Mat ogl_pixel(framebuffer_height_ / tiles_rows_, framebuffer_width_ / tiles_cols_, CV_8UC3);
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
-    glPixelStorei(GL_PACK_ALIGNMENT, (ogl_pixel.step & 3) ? 1 : 4);
-    glPixelStorei(GL_PACK_ROW_LENGTH, ogl_pixel.step/ogl_pixel.elemSize());
-    glReadPixels(0, framebuffer_height_ - tile_img_height_, tile_img_width_, tile_img_height_, GL_BGR, GL_UNSIGNED_BYTE, ogl_pixel.data);
-
-    cv::flip(ogl_pixel, img, 0);
+    if (roi_)
+        readRois(1, tile_img_width_, img);
+    else
+        readPixels(0, framebuffer_height_ - tile_img_height_, tile_img_width_, tile_img_height_, img);
 
     /* Swap the buffers. */
     glfwSwapBuffers(window_);
@@ -580,14 +683,30 @@ bool SICAD::superimpose
     cv::Mat& img
 )
 {
-    /* Model transformation matrix. */
-    const int objpos_num = objpos_multimap.size();
-    if (objpos_num != tiles_num_) return false;
+    const size_t objpos_num = objpos_multimap.size();
+    if (objpos_num == 0)
+        return false;
+
+    const size_t tiles_num = static_cast<size_t>(tiles_num_);
+    if (objpos_num > tiles_num && (instance_id_ || correspondence_ || point_cloud_))
+    {
+        std::cerr << "ERROR::SICAD::SUPERIMPOSE\nERROR:\n\tInstance IDs, correspondences and point clouds are available only for batches fitting the render grid." << std::endl;
+        return false;
+    }
+
+    if (roi_ && (objpos_num > tiles_num || instance_id_ || correspondence_ || point_cloud_))
+    {
+        std::cerr << "ERROR::SICAD::SUPERIMPOSE\nERROR:\n\tROIs are available only for batches fitting the render grid, without instance IDs, correspondences and point clouds." << std::endl;
+        return false;
+    }
 
     glfwMakeContextCurrent(window_);
 
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
 
+    /* Swap in the models updated since the last frame. */
+    swapModels();
+
     /* View transformation matrix. */
     glm::mat4 view = getViewTransformationMatrix(cam_x, cam_o);
 
@@ -604,85 +723,73 @@ bool SICAD::superimpose
     glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
     shader_frame_->uninstall();
 
-    for (unsigned int i = 0; i < tiles_rows_; ++i)
-    {
-        for (unsigned int j = 0; j < tiles_cols_; ++j)
-        {
-            /* Multimap index */
-            int idx = i * tiles_cols_ + j;
+    empty_tiles_.assign(objpos_num, true);
+    object_statistics_.assign(statistics_ ? objpos_num : 0, std::vector<ObjectStatistics>());
 
-            /* Render starting by the upper-left-most tile of the render grid, proceding by columns and rows. */
-            glViewport(tile_img_width_ * j, framebuffer_height_ - (tile_img_height_ * (i + 1)),
-                       tile_img_width_    , tile_img_height_                                   );
-            glScissor (tile_img_width_ * j, framebuffer_height_ - (tile_img_height_ * (i + 1)),
-                       tile_img_width_    , tile_img_height_                                   );
+    /* Render the static scene, unless cached. */
+    updateStaticScene(view);
 
-            /* Clear the colorbuffer. */
-            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    rois_.assign(roi_ ? objpos_num : 0, cv::Rect());
+    roi_atlas_.clear();
+    roi_images_.clear();
 
-            /* Draw the background picture. */
-            if (getBackgroundOpt())
-                renderBackground(img);
-
-            /* View mesh filled or as wireframe. */
-            setWireframe(getWireframeOpt());
+    const size_t batch_tiles = getBatchTiles();
+    if (objpos_num <= batch_tiles)
+    {
+        /* Read before swap. glReadPixels read the current framebuffer, i.e. the back one. Only the rows of tiles in use are read.
+           Tiles are rendered without cache if it is not in use or its layer cannot be created. */
+        if (!useRenderCache() || !renderCachedTiles(objpos_multimap, cam_x, cam_o, view, img))
+        {
+            renderTiles(objpos_multimap, 0, objpos_num, view, &img, roi_);
+            rendered_tiles_number_ = objpos_num;
 
-            /* Install/Use the program specified by the shader. */
-            for (const ModelPoseContainerElement& pair : objpos_multimap[idx])
+            if (roi_)
+                readRois(objpos_num, framebuffer_width_, img);
+            else
             {
-                const double* pose = pair.second.data();
+                const GLsizei used_height = getTilesHeight(objpos_num);
+                readPixels(0, framebuffer_height_ - used_height, framebuffer_width_, used_height, img);
+            }
+        }
+    }
+    else
+    {
+        /* The batch is split in passes filling the render grid, or the calibrated batch size. The readback of each pass is issued
+           to the ring of batch PBOs and copied to img while the next passes render, so that the CPU never waits for the GPU it is feeding. */
+        const cv::Mat background = getBackgroundOpt() ? img.clone() : cv::Mat();
 
-                glm::mat4 model = glm::rotate(glm::mat4(1.0f), static_cast<float>(pose[6]), glm::vec3(static_cast<float>(pose[3]), static_cast<float>(pose[4]), static_cast<float>(pose[5])));
-                model[3][0] = static_cast<float>(pose[0]);
-                model[3][1] = static_cast<float>(pose[1]);
-                model[3][2] = static_cast<float>(pose[2]);
+        if (readback_)
+            img.create(getTilesHeight(objpos_num), framebuffer_width_, render_mode_ == RenderMode::depth ? CV_32FC1 : CV_8UC3);
 
-                auto iter_model = model_obj_.find(pair.first);
-                if (iter_model != model_obj_.end())
-                {
-                    if ((iter_model->second)->has_texture())
-                    {
-                        shader_mesh_texture_->install();
-                        glUniformMatrix4fv(glGetUniformLocation(shader_mesh_texture_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+        const size_t passes = (objpos_num + batch_tiles - 1) / batch_tiles;
+        const size_t depth = batch_pbo_.size();
+        rendered_tiles_number_ = objpos_num;
 
-                        (iter_model->second)->Draw(*shader_mesh_texture_);
+        for (size_t pass = 0; pass < passes; ++pass)
+        {
+            const size_t first = pass * batch_tiles;
 
-                        shader_mesh_texture_->uninstall();
-                    }
-                    else
-                    {
-                        shader_cad_->install();
-                        glUniformMatrix4fv(glGetUniformLocation(shader_cad_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+            renderTiles(objpos_multimap, first, std::min(objpos_num - first, batch_tiles), view, &background, false);
 
-                        (iter_model->second)->Draw(*shader_cad_);
+            if (!readback_)
+                continue;
 
-                        shader_cad_->uninstall();
-                    }
-                }
-                else if (pair.first == "frame")
-                {
-                    shader_frame_->install();
-                    glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-                    glBindVertexArray(vao_frame_);
-                    glDrawArrays(GL_LINES, 0, 6);
-                    glBindVertexArray(0);
-                    shader_frame_->uninstall();
-                }
-            }
+            readBatchPass(pass, std::min(objpos_num - first, batch_tiles));
+
+            /* The oldest pass in the ring is copied before its PBO is reused. */
+            if (pass + 1 >= depth)
+                copyBatchPass(pass + 1 - depth, (pass + 1 - depth) * batch_tiles, batch_tiles, img);
         }
-    }
 
-    /* Read before swap. glReadPixels read the current framebuffer, i.e. the back one. */
-    /* See: http://stackoverflow.com/questions/16809833/opencv-image-loading-for-opengl-texture#16812529
-       and http://stackoverflow.com/questions/9097756/converting-data-from-glreadpixels-to-opencvmat#9098883 */
-    cv::Mat ogl_pixel(framebuffer_height_, framebuffer_width_, CV_8UC3);
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
-    glPixelStorei(GL_PACK_ALIGNMENT, (ogl_pixel.step & 3) ? 1 : 4);
-    glPixelStorei(GL_PACK_ROW_LENGTH, ogl_pixel.step/ogl_pixel.elemSize());
-    glReadPixels(0, 0, framebuffer_width_, framebuffer_height_, GL_BGR, GL_UNSIGNED_BYTE, ogl_pixel.data);
+        if (readback_)
+        {
+            for (size_t pass = passes + 1 > depth ? passes + 1 - depth : 0; pass < passes; ++pass)
+                copyBatchPass(pass, pass * batch_tiles, std::min(objpos_num - pass * batch_tiles, batch_tiles), img);
+        }
 
-    cv::flip(ogl_pixel, img, 0);
+        if (statistics_)
+            readStatistics();
+    }
 
     /* Swap the buffers. */
     glfwSwapBuffers(window_);
@@ -758,18 +865,8 @@ bool SICAD::superimpose
 
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
 
-    /* Render in the upper-left-most tile of the render grid */
-    glViewport(0,               framebuffer_height_ - tile_img_height_,
-               tile_img_width_, tile_img_height_                       );
-    glScissor (0,               framebuffer_height_ - tile_img_height_,
-               tile_img_width_, tile_img_height_                       );
-
-    /* Clear the colorbuffer. */
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    /* View mesh filled or as wireframe. */
-    setWireframe(getWireframeOpt());
+    /* Swap in the models updated since the last frame. */
+    swapModels();
 
     /* View transformation matrix. */
     glm::mat4 view = getViewTransformationMatrix(cam_x, cam_o);
@@ -787,52 +884,32 @@ bool SICAD::superimpose
     glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
     shader_frame_->uninstall();
 
-    /* Model transformation matrix. */
-    for (const ModelPoseContainerElement& pair : objpos_map)
-    {
-        const double* pose = pair.second.data();
+    /* Render the static scene, unless cached. */
+    updateStaticScene(view);
 
-        glm::mat4 model = glm::rotate(glm::mat4(1.0f), static_cast<float>(pose[6]), glm::vec3(static_cast<float>(pose[3]), static_cast<float>(pose[4]), static_cast<float>(pose[5])));
-        model[3][0] = pose[0];
-        model[3][1] = pose[1];
-        model[3][2] = pose[2];
+    /* Render in the upper-left-most tile of the render grid */
+    glViewport(0,               framebuffer_height_ - tile_img_height_,
+               tile_img_width_, tile_img_height_                       );
+    glScissor (0,               framebuffer_height_ - tile_img_height_,
+               tile_img_width_, tile_img_height_                       );
 
-        auto iter_model = model_obj_.find(pair.first);
-        if (iter_model != model_obj_.end())
-        {
-            if ((iter_model->second)->has_texture())
-            {
-                shader_mesh_texture_->install();
-                glUniformMatrix4fv(glGetUniformLocation(shader_mesh_texture_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+    /* Clear the colorbuffer, unless masked, and the depthbuffer. */
+    clearBuffers();
 
-                (iter_model->second)->Draw(*shader_mesh_texture_);
+    /* View mesh filled or as wireframe. */
+    setWireframe(getWireframeOpt());
 
-                shader_mesh_texture_->uninstall();
-            }
-            else
-            {
-                shader_cad_->install();
-                glUniformMatrix4fv(glGetUniformLocation(shader_cad_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+    /* Draw the mesh models. */
+    drawStaticScene(view, 0);
 
-                (iter_model->second)->Draw(*shader_cad_);
+    empty_tiles_.assign(tiles_num_, true);
+    object_statistics_.assign(statistics_ ? tiles_num_ : 0, std::vector<ObjectStatistics>());
+    empty_tiles_[0] = !renderModels(objpos_map, view);
 
-                shader_cad_->uninstall();
-            }
-        }
-        else if (pair.first == "frame")
-        {
-            shader_frame_->install();
-            glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(vao_frame_);
-            glDrawArrays(GL_LINES, 0, 6);
-            glBindVertexArray(0);
-            shader_frame_->uninstall();
-        }
-    }
+    if (statistics_)
+        queueStatistics(objpos_map, view, 0, 0, false);
 
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[pbo_index]);
-    glReadPixels(0, framebuffer_height_ - tile_img_height_, tile_img_width_, tile_img_height_, GL_BGR, GL_UNSIGNED_BYTE, 0);
+    readPixels(0, framebuffer_height_ - tile_img_height_, tile_img_width_, tile_img_height_, pbo_index);
 
     /* Swap the buffers. */
     glfwSwapBuffers(window_);
@@ -866,22 +943,8 @@ bool SICAD::superimpose
 
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
 
-    /* Render in the upper-left-most tile of the render grid */
-    glViewport(0,               framebuffer_height_ - tile_img_height_,
-               tile_img_width_, tile_img_height_                       );
-    glScissor (0,               framebuffer_height_ - tile_img_height_,
-               tile_img_width_, tile_img_height_                       );
-
-    /* Clear the colorbuffer. */
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    /* Draw the background picture. */
-    if (getBackgroundOpt())
-        renderBackground(img);
-
-    /* View mesh filled or as wireframe. */
-    setWireframe(getWireframeOpt());
+    /* Swap in the models updated since the last frame. */
+    swapModels();
 
     /* View transformation matrix. */
     glm::mat4 view = getViewTransformationMatrix(cam_x, cam_o);
@@ -899,52 +962,36 @@ bool SICAD::superimpose
     glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
     shader_frame_->uninstall();
 
-    /* Model transformation matrix. */
-    for (const ModelPoseContainerElement& pair : objpos_map)
-    {
-        const double* pose = pair.second.data();
+    /* Render the static scene, unless cached. */
+    updateStaticScene(view);
+
+    /* Render in the upper-left-most tile of the render grid */
+    glViewport(0,               framebuffer_height_ - tile_img_height_,
+               tile_img_width_, tile_img_height_                       );
+    glScissor (0,               framebuffer_height_ - tile_img_height_,
+               tile_img_width_, tile_img_height_                       );
 
-        glm::mat4 model = glm::rotate(glm::mat4(1.0f), static_cast<float>(pose[6]), glm::vec3(static_cast<float>(pose[3]), static_cast<float>(pose[4]), static_cast<float>(pose[5])));
-        model[3][0] = pose[0];
-        model[3][1] = pose[1];
-        model[3][2] = pose[2];
+    /* Clear the colorbuffer, unless masked, and the depthbuffer. */
+    clearBuffers();
 
-        auto iter_model = model_obj_.find(pair.first);
-        if (iter_model != model_obj_.end())
-        {
-            if ((iter_model->second)->has_texture())
-            {
-                shader_mesh_texture_->install();
-                glUniformMatrix4fv(glGetUniformLocation(shader_mesh_texture_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+    /* Draw the background picture. */
+    if (getBackgroundOpt() && render_mode_ == RenderMode::color)
+        renderBackground(img);
 
-                (iter_model->second)->Draw(*shader_mesh_texture_);
+    /* View mesh filled or as wireframe. */
+    setWireframe(getWireframeOpt());
 
-                shader_mesh_texture_->uninstall();
-            }
-            else
-            {
-                shader_cad_->install();
-                glUniformMatrix4fv(glGetUniformLocation(shader_cad_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+    /* Draw the mesh models. */
+    drawStaticScene(view, 0);
 
-                (iter_model->second)->Draw(*shader_cad_);
+    empty_tiles_.assign(tiles_num_, true);
+    object_statistics_.assign(statistics_ ? tiles_num_ : 0, std::vector<ObjectStatistics>());
+    empty_tiles_[0] = !renderModels(objpos_map, view);
 
-                shader_cad_->uninstall();
-            }
-        }
-        else if (pair.first == "frame")
-        {
-            shader_frame_->install();
-            glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(vao_frame_);
-            glDrawArrays(GL_LINES, 0, 6);
-            glBindVertexArray(0);
-            shader_frame_->uninstall();
-        }
-    }
+    if (statistics_)
+        queueStatistics(objpos_map, view, 0, 0, false);
 
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[pbo_index]);
-    glReadPixels(0, framebuffer_height_ - tile_img_height_, tile_img_width_, tile_img_height_, GL_BGR, GL_UNSIGNED_BYTE, 0);
+    readPixels(0, framebuffer_height_ - tile_img_height_, tile_img_width_, tile_img_height_, pbo_index);
 
     /* Swap the buffers. */
     glfwSwapBuffers(window_);
@@ -972,15 +1019,23 @@ bool SICAD::superimpose
         return false;
     }
 
+    const size_t objpos_num = objpos_multimap.size();
+    if (objpos_num == 0)
+        return false;
 
-    /* Model transformation matrix. */
-    const int objpos_num = objpos_multimap.size();
-    if (objpos_num != tiles_num_) return false;
-
-    glfwMakeContextCurrent(window_);
+    if (objpos_num > static_cast<size_t>(tiles_num_))
+    {
+        std::cerr << "ERROR::SICAD::SUPERIMPOSE\nERROR:\n\tA PBO can store at most as many tiles as the render grid." << std::endl;
+        return false;
+    }
+
+    glfwMakeContextCurrent(window_);
 
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
 
+    /* Swap in the models updated since the last frame. */
+    swapModels();
+
     /* View transformation matrix. */
     glm::mat4 view = getViewTransformationMatrix(cam_x, cam_o);
 
@@ -997,74 +1052,17 @@ bool SICAD::superimpose
     glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
     shader_frame_->uninstall();
 
-    for (unsigned int i = 0; i < tiles_rows_; ++i)
-    {
-        for (unsigned int j = 0; j < tiles_cols_; ++j)
-        {
-            /* Multimap index */
-            int idx = i * tiles_cols_ + j;
-
-            /* Render starting by the upper-left-most tile of the render grid, proceding by columns and rows. */
-            glViewport(tile_img_width_ * j, framebuffer_height_ - (tile_img_height_ * (i + 1)),
-                       tile_img_width_,     tile_img_height_                                   );
-            glScissor (tile_img_width_ * j, framebuffer_height_ - (tile_img_height_ * (i + 1)),
-                       tile_img_width_,     tile_img_height_                                   );
-
-            /* Clear the colorbuffer. */
-            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-            /* View mesh filled or as wireframe. */
-            setWireframe(getWireframeOpt());
-
-            /* Install/Use the program specified by the shader. */
-            for (const ModelPoseContainerElement& pair : objpos_multimap[idx])
-            {
-                const double* pose = pair.second.data();
-
-                glm::mat4 model = glm::rotate(glm::mat4(1.0f), static_cast<float>(pose[6]), glm::vec3(static_cast<float>(pose[3]), static_cast<float>(pose[4]), static_cast<float>(pose[5])));
-                model[3][0] = static_cast<float>(pose[0]);
-                model[3][1] = static_cast<float>(pose[1]);
-                model[3][2] = static_cast<float>(pose[2]);
-
-                auto iter_model = model_obj_.find(pair.first);
-                if (iter_model != model_obj_.end())
-                {
-                    if ((iter_model->second)->has_texture())
-                    {
-                        shader_mesh_texture_->install();
-                        glUniformMatrix4fv(glGetUniformLocation(shader_mesh_texture_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-
-                        (iter_model->second)->Draw(*shader_mesh_texture_);
-
-                        shader_mesh_texture_->uninstall();
-                    }
-                    else
-                    {
-                        shader_cad_->install();
-                        glUniformMatrix4fv(glGetUniformLocation(shader_cad_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+    empty_tiles_.assign(objpos_num, true);
+    object_statistics_.assign(statistics_ ? objpos_num : 0, std::vector<ObjectStatistics>());
 
-                        (iter_model->second)->Draw(*shader_cad_);
+    /* Render the static scene, unless cached. */
+    updateStaticScene(view);
 
-                        shader_cad_->uninstall();
-                    }
-                }
-                else if (pair.first == "frame")
-                {
-                    shader_frame_->install();
-                    glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-                    glBindVertexArray(vao_frame_);
-                    glDrawArrays(GL_LINES, 0, 6);
-                    glBindVertexArray(0);
-                    shader_frame_->uninstall();
-                }
-            }
-        }
-    }
+    renderTiles(objpos_multimap, 0, objpos_num, view, nullptr, false);
 
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[pbo_index]);
-    glReadPixels(0, 0, framebuffer_width_, framebuffer_height_, GL_BGR, GL_UNSIGNED_BYTE, 0);
+    /* Only the rows of tiles in use are read. */
+    const GLsizei used_height = getTilesHeight(objpos_num);
+    readPixels(0, framebuffer_height_ - used_height, framebuffer_width_, used_height, pbo_index);
 
     /* Swap the buffers. */
     glfwSwapBuffers(window_);
@@ -1093,15 +1091,23 @@ bool SICAD::superimpose
         return false;
     }
 
+    const size_t objpos_num = objpos_multimap.size();
+    if (objpos_num == 0)
+        return false;
 
-    /* Model transformation matrix. */
-    const int objpos_num = objpos_multimap.size();
-    if (objpos_num != tiles_num_) return false;
+    if (objpos_num > static_cast<size_t>(tiles_num_))
+    {
+        std::cerr << "ERROR::SICAD::SUPERIMPOSE\nERROR:\n\tA PBO can store at most as many tiles as the render grid." << std::endl;
+        return false;
+    }
 
     glfwMakeContextCurrent(window_);
 
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
 
+    /* Swap in the models updated since the last frame. */
+    swapModels();
+
     /* View transformation matrix. */
     glm::mat4 view = getViewTransformationMatrix(cam_x, cam_o);
 
@@ -1118,78 +1124,17 @@ bool SICAD::superimpose
     glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
     shader_frame_->uninstall();
 
-    for (unsigned int i = 0; i < tiles_rows_; ++i)
-    {
-        for (unsigned int j = 0; j < tiles_cols_; ++j)
-        {
-            /* Multimap index */
-            int idx = i * tiles_cols_ + j;
-
-            /* Render starting by the upper-left-most tile of the render grid, proceding by columns and rows. */
-            glViewport(tile_img_width_ * j, framebuffer_height_ - (tile_img_height_ * (i + 1)),
-                       tile_img_width_,     tile_img_height_                                   );
-            glScissor (tile_img_width_ * j, framebuffer_height_ - (tile_img_height_ * (i + 1)),
-                       tile_img_width_,     tile_img_height_                                   );
-
-            /* Clear the colorbuffer. */
-            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-            /* Draw the background picture. */
-            if (getBackgroundOpt())
-                renderBackground(img);
-
-            /* View mesh filled or as wireframe. */
-            setWireframe(getWireframeOpt());
-
-            /* Install/Use the program specified by the shader. */
-            for (const ModelPoseContainerElement& pair : objpos_multimap[idx])
-            {
-                const double* pose = pair.second.data();
-
-                glm::mat4 model = glm::rotate(glm::mat4(1.0f), static_cast<float>(pose[6]), glm::vec3(static_cast<float>(pose[3]), static_cast<float>(pose[4]), static_cast<float>(pose[5])));
-                model[3][0] = static_cast<float>(pose[0]);
-                model[3][1] = static_cast<float>(pose[1]);
-                model[3][2] = static_cast<float>(pose[2]);
-
-                auto iter_model = model_obj_.find(pair.first);
-                if (iter_model != model_obj_.end())
-                {
-                    if ((iter_model->second)->has_texture())
-                    {
-                        shader_mesh_texture_->install();
-                        glUniformMatrix4fv(glGetUniformLocation(shader_mesh_texture_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-
-                        (iter_model->second)->Draw(*shader_mesh_texture_);
-
-                        shader_mesh_texture_->uninstall();
-                    }
-                    else
-                    {
-                        shader_cad_->install();
-                        glUniformMatrix4fv(glGetUniformLocation(shader_cad_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+    empty_tiles_.assign(objpos_num, true);
+    object_statistics_.assign(statistics_ ? objpos_num : 0, std::vector<ObjectStatistics>());
 
-                        (iter_model->second)->Draw(*shader_cad_);
+    /* Render the static scene, unless cached. */
+    updateStaticScene(view);
 
-                        shader_cad_->uninstall();
-                    }
-                }
-                else if (pair.first == "frame")
-                {
-                    shader_frame_->install();
-                    glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-                    glBindVertexArray(vao_frame_);
-                    glDrawArrays(GL_LINES, 0, 6);
-                    glBindVertexArray(0);
-                    shader_frame_->uninstall();
-                }
-            }
-        }
-    }
+    renderTiles(objpos_multimap, 0, objpos_num, view, &img, false);
 
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[pbo_index]);
-    glReadPixels(0, 0, framebuffer_width_, framebuffer_height_, GL_BGR, GL_UNSIGNED_BYTE, 0);
+    /* Only the rows of tiles in use are read. */
+    const GLsizei used_height = getTilesHeight(objpos_num);
+    readPixels(0, framebuffer_height_ - used_height, framebuffer_width_, used_height, pbo_index);
 
     /* Swap the buffers. */
     glfwSwapBuffers(window_);
@@ -1230,6 +1175,196 @@ std::pair<bool, GLuint> SICAD::getPBO(const size_t pbo_index) const
 }
 
 
+bool SICAD::resize
+(
+    const GLint num_images,
+    const GLsizei cam_width,
+    const GLsizei cam_height
+)
+{
+    if (num_images < 1 || cam_width < 1 || cam_height < 1 || cam_width > renderbuffer_size_ || cam_height > renderbuffer_size_)
+    {
+        std::cerr << "ERROR::SICAD::RESIZE\nERROR:\n\tInvalid number of images or image size." << std::endl;
+        return false;
+    }
+
+    glfwMakeContextCurrent(window_);
+
+    setUpTiles(num_images, cam_width, cam_height);
+
+    /* Use the configuration calibrated for the new one, if any. */
+    if (!readCalibration(calibration_))
+        calibration_ = Calibration();
+    applyCalibration();
+
+    clearRenderCache();
+
+    if (!resizeAttachments())
+    {
+        glfwMakeContextCurrent(nullptr);
+
+        return false;
+    }
+
+    allocatePBOs();
+
+    empty_tiles_.clear();
+    object_statistics_.clear();
+
+    glfwMakeContextCurrent(nullptr);
+
+    return true;
+}
+
+
+void SICAD::setCalibrationFile(const std::string& calibration_file)
+{
+    calibration_file_ = calibration_file;
+}
+
+
+bool SICAD::calibrate
+(
+    const ModelPoseContainer& objpos_map,
+    const double* cam_x,
+    const double* cam_o
+)
+{
+    /* Candidate grids have at least as many tiles as the requested images, so that the PBO superimpose() methods and the auxiliary
+       outputs keep working on a single pass. Grids wasting a whole row, or with a framebuffer more elongated than 4:1, are skipped. */
+    std::vector<std::pair<GLsizei, GLsizei>> grids;
+    for (GLsizei cols = 1; cols <= requested_images_; ++cols)
+    {
+        const GLsizei rows = (requested_images_ + cols - 1) / cols;
+        const double aspect_ratio = static_cast<double>(cols * image_width_) / (rows * image_height_);
+
+        if ((rows - 1) * cols >= requested_images_ || aspect_ratio > 4.0 || aspect_ratio < 0.25 ||
+            cols * image_width_ > renderbuffer_size_ || rows * image_height_ > renderbuffer_size_)
+            continue;
+
+        grids.emplace_back(cols, rows);
+    }
+
+    if (grids.empty())
+    {
+        std::cerr << "ERROR::SICAD::CALIBRATE\nERROR:\n\tNo render grid fits the maximum renderbuffer size." << std::endl;
+        return false;
+    }
+
+    const GLsizei previous_tiles_cols = tiles_cols_;
+    const GLsizei previous_tiles_rows = tiles_rows_;
+    const GLsizei previous_batch_rows = batch_rows_;
+    const size_t previous_pbo_depth = batch_pbo_.size();
+
+    /* Cached tiles and ROIs would measure the options rather than the configuration. */
+    const bool previous_render_cache = render_cache_;
+    const bool previous_roi = roi_;
+    render_cache_ = false;
+    roi_ = false;
+
+    /* Batches smaller than the render grid hold the rendered images only. */
+    const bool small_batches = !(instance_id_ || correspondence_ || point_cloud_);
+
+    Calibration best;
+    for (const std::pair<GLsizei, GLsizei>& grid : grids)
+    {
+        glfwMakeContextCurrent(window_);
+        setUpGrid(grid.first, grid.second);
+        const bool resized = resizeAttachments();
+        allocatePBOs();
+        glfwMakeContextCurrent(nullptr);
+
+        if (!resized)
+            continue;
+
+        /* Batches of a whole, a half and a quarter of the rows of the grid. As grids waste no row, smaller batches take multiple passes. */
+        std::vector<GLsizei> batches_rows;
+        for (const GLsizei batch_rows : { tiles_rows_, (tiles_rows_ + 1) / 2, (tiles_rows_ + 3) / 4 })
+        {
+            if ((batch_rows == tiles_rows_ || small_batches) && std::find(batches_rows.begin(), batches_rows.end(), batch_rows) == batches_rows.end())
+                batches_rows.push_back(batch_rows);
+        }
+
+        for (const GLsizei batch_rows : batches_rows)
+        {
+            /* PBOs store a single pass, i.e. the whole grid. Single-pass readback to cv::Mat uses no PBO. */
+            for (const bool pbo_readback : { false, true })
+            {
+                std::vector<size_t> pbo_depths;
+                if (pbo_readback && batch_rows == tiles_rows_)
+                    pbo_depths = { 1, pbo_number_ };
+                else if (!pbo_readback && batch_rows < tiles_rows_)
+                    pbo_depths = { 1, 2, 3 };
+                else if (!pbo_readback)
+                    pbo_depths = { 2 };
+
+                for (const size_t pbo_depth : pbo_depths)
+                {
+                    batch_rows_ = batch_rows;
+
+                    glfwMakeContextCurrent(window_);
+                    setUpBatchPBOs(pbo_readback ? previous_pbo_depth : pbo_depth);
+                    glfwMakeContextCurrent(nullptr);
+
+                    const double images_per_second = benchmarkGrid(objpos_map, cam_x, cam_o, pbo_readback, pbo_depth);
+                    std::cout << log_ID_ << "Calibration of the " + std::to_string(tiles_rows_) + "x" + std::to_string(tiles_cols_) + " grid"
+                                         << " with batches of " + std::to_string(batch_rows * tiles_cols_) + " tiles and " + (pbo_readback ? "PBO" : "cv::Mat") + " readback"
+                                         << " through " + std::to_string(pbo_depth) + " PBOs: " + std::to_string(images_per_second) + " images/s." << std::endl;
+
+                    if (images_per_second > best.images_per_second)
+                    {
+                        best.tiles_cols = tiles_cols_;
+                        best.tiles_rows = tiles_rows_;
+                        best.batch_rows = batch_rows;
+                        best.pbo_readback = pbo_readback;
+                        best.pbo_depth = pbo_depth;
+                        best.images_per_second = images_per_second;
+                    }
+                }
+            }
+        }
+    }
+
+    render_cache_ = previous_render_cache;
+    roi_ = previous_roi;
+    clearRenderCache();
+
+    const bool calibrated = best.images_per_second > 0.0;
+    if (calibrated)
+        calibration_ = best;
+    else
+        std::cerr << "ERROR::SICAD::CALIBRATE\nERROR:\n\tNo render configuration could be benchmarked." << std::endl;
+
+    /* Install the fastest configuration, or restore the previous one, together with attachments and PBOs of matching size. */
+    glfwMakeContextCurrent(window_);
+    if (calibrated)
+        applyCalibration();
+    else
+    {
+        setUpGrid(previous_tiles_cols, previous_tiles_rows);
+        batch_rows_ = previous_batch_rows;
+        setUpBatchPBOs(previous_pbo_depth);
+    }
+    const bool resized = resizeAttachments();
+    allocatePBOs();
+    glfwMakeContextCurrent(nullptr);
+
+    empty_tiles_.clear();
+    object_statistics_.clear();
+
+    if (!calibrated || !resized)
+        return false;
+
+    return writeCalibration();
+}
+
+
+const SICAD::Calibration& SICAD::getCalibration() const
+{
+    return calibration_;
+}
+
+
 bool SICAD::setProjectionMatrix
 (
     const GLsizei cam_width,
@@ -1291,6 +1426,7 @@ bool SICAD::setProjectionMatrix
 void SICAD::setBackgroundOpt(bool show_background)
 {
     show_background_ = show_background;
+    clearRenderCache();
 }
 
 
@@ -1304,12 +1440,15 @@ void SICAD::setWireframeOpt(bool show_mesh_wires)
 {
     if  (show_mesh_wires) show_mesh_mode_ = GL_LINE;
     else                  show_mesh_mode_ = GL_FILL;
+
+    clearRenderCache();
 }
 
 
 void SICAD::setMipmapsOpt(const MIPMaps& mipmaps)
 {
     mesh_mmaps_ = mipmaps;
+    clearRenderCache();
 }
 
 
@@ -1325,86 +1464,3174 @@ SICAD::MIPMaps SICAD::getMipmapsOpt() const
 }
 
 
-int SICAD::getTilesNumber() const
+void SICAD::setVertexQuantizationOpt(bool quantize_vertices)
 {
-    return tiles_rows_ * tiles_cols_;
+    vertex_quantization_ = quantize_vertices;
+    clearRenderCache();
+
+    /* Vertex buffers are re-uploaded with the context of SICAD, then the context of the caller, e.g. the one reading PBOs, is made current again. */
+    GLFWwindow* previous_context = glfwGetCurrentContext();
+
+    glfwMakeContextCurrent(window_);
+
+    updateVertexLayouts();
+
+    glfwMakeContextCurrent(previous_context);
 }
 
 
-int SICAD::getTilesRows() const
+bool SICAD::getVertexQuantizationOpt() const
 {
-    return tiles_rows_;
+    return vertex_quantization_;
 }
 
 
-int SICAD::getTilesCols() const
+void SICAD::setLevelOfDetailErrorOpt(const GLfloat max_pixel_error)
 {
-    return tiles_cols_;
+    lod_error_threshold_ = max_pixel_error;
+    clearRenderCache();
 }
 
 
-glm::mat4 SICAD::getViewTransformationMatrix(const double* cam_x, const double* cam_o)
+GLfloat SICAD::getLevelOfDetailErrorOpt() const
 {
-    glm::mat4 root_cam_t  = glm::translate(glm::mat4(1.0f),
-                                           glm::vec3(static_cast<float>(cam_x[0]), static_cast<float>(cam_x[1]), static_cast<float>(cam_x[2])));
-    glm::mat4 cam_to_root = glm::rotate(glm::mat4(1.0f),
-                                        static_cast<float>(cam_o[3]), glm::vec3(static_cast<float>(cam_o[0]), static_cast<float>(cam_o[1]), static_cast<float>(cam_o[2])));
+    return lod_error_threshold_;
+}
 
-    glm::mat4 view = glm::lookAt(glm::vec3(root_cam_t[3].x, root_cam_t[3].y, root_cam_t[3].z),
-                                 glm::vec3(root_cam_t[3].x, root_cam_t[3].y, root_cam_t[3].z) + glm::mat3(cam_to_root) * ogl_to_cam_ * glm::vec3(0.0f, 0.0f, -1.0f),
-                                 glm::mat3(cam_to_root) * ogl_to_cam_ * glm::vec3(0.0f, 1.0f, 0.0f));
 
-    return view;
+bool SICAD::setRenderModeOpt(const RenderMode& render_mode)
+{
+    glfwMakeContextCurrent(window_);
+
+    const RenderMode previous_render_mode = render_mode_;
+    render_mode_ = render_mode;
+
+    if (!setUpMeshShaders())
+    {
+        render_mode_ = previous_render_mode;
+        setUpMeshShaders();
+
+        glfwMakeContextCurrent(nullptr);
+
+        return false;
+    }
+
+    setUpFramebuffer();
+
+    clearRenderCache();
+
+    allocatePBOs();
+
+    updateVertexLayouts();
+
+    glfwMakeContextCurrent(nullptr);
+
+    return true;
 }
 
 
-void SICAD::pollOrPostEvent()
+SICAD::RenderMode SICAD::getRenderModeOpt() const
 {
-    if(main_thread_id_ == std::this_thread::get_id())
-        glfwPollEvents();
-    else
-        glfwPostEmptyEvent();
+    return render_mode_;
 }
 
 
-void SICAD::renderBackground(const cv::Mat& img) const
+bool SICAD::setInstanceIdOpt(const bool write_instance_id)
 {
-    /* Load and generate the texture. */
-    glBindTexture(GL_TEXTURE_2D, texture_background_);
+    glfwMakeContextCurrent(window_);
 
-    /* Set the texture wrapping/filtering options (on the currently bound texture object). */
-    if (getMipmapsOpt() == MIPMaps::nearest)
+    const bool previous_instance_id = instance_id_;
+    instance_id_ = write_instance_id;
+
+    if (!setUpMeshShaders())
     {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        instance_id_ = previous_instance_id;
+        setUpMeshShaders();
+
+        glfwMakeContextCurrent(nullptr);
+
+        return false;
     }
-    else if (getMipmapsOpt() == MIPMaps::linear)
+
+    /* Create the instance ID attachment on first use. */
+    if (useInstanceIds() && texture_instance_id_ == 0)
+        createColorAttachment(texture_instance_id_, GL_COLOR_ATTACHMENT1, GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT);
+
+    setUpFramebuffer();
+
+    clearRenderCache();
+
+    if (!instance_id_)
     {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        instance_ids_.release();
+        instance_pixel_counts_.clear();
     }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, img.cols, img.rows, 0, GL_BGR, GL_UNSIGNED_BYTE, img.data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    glfwMakeContextCurrent(nullptr);
 
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    return true;
+}
 
-    /* Install/Use the program specified by the shader. */
-    shader_background_->install();
-    glUniformMatrix4fv(glGetUniformLocation(shader_background_->get_program(), "projection"), 1, GL_FALSE, glm::value_ptr(back_proj_));
 
-    glBindVertexArray(vao_background_);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+bool SICAD::getInstanceIdOpt() const
+{
+    return instance_id_;
+}
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    shader_background_->uninstall();
+
+const cv::Mat& SICAD::getInstanceIdImage() const
+{
+    return instance_ids_;
 }
 
 
-void SICAD::setWireframe(GLenum mode)
+const std::vector<std::vector<size_t>>& SICAD::getInstancePixelCounts() const
 {
-    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    return instance_pixel_counts_;
+}
+
+
+bool SICAD::setCorrespondenceOpt(const bool write_correspondences)
+{
+    glfwMakeContextCurrent(window_);
+
+    const bool previous_correspondence = correspondence_;
+    correspondence_ = write_correspondences;
+
+    if (!setUpMeshShaders())
+    {
+        correspondence_ = previous_correspondence;
+        setUpMeshShaders();
+
+        glfwMakeContextCurrent(nullptr);
+
+        return false;
+    }
+
+    /* Create the correspondence attachment on first use. */
+    if (correspondence_ && texture_correspondence_ == 0)
+        createColorAttachment(texture_correspondence_, GL_COLOR_ATTACHMENT2, GL_RGBA32UI, GL_RGBA_INTEGER, GL_UNSIGNED_INT);
+
+    setUpFramebuffer();
+
+    clearRenderCache();
+
+    if (!correspondence_)
+        correspondences_.clear();
+
+    glfwMakeContextCurrent(nullptr);
+
+    return true;
+}
+
+
+bool SICAD::getCorrespondenceOpt() const
+{
+    return correspondence_;
+}
+
+
+const std::vector<SICAD::Correspondence>& SICAD::getCorrespondences() const
+{
+    return correspondences_;
+}
+
+
+bool SICAD::setPointCloudOpt(const bool write_point_cloud, const PointCloudFrame& frame, const PointCloudFormat& format)
+{
+    glfwMakeContextCurrent(window_);
+
+    const bool previous_point_cloud = point_cloud_;
+    point_cloud_ = write_point_cloud;
+
+    if (!setUpMeshShaders())
+    {
+        point_cloud_ = previous_point_cloud;
+        setUpMeshShaders();
+
+        glfwMakeContextCurrent(nullptr);
+
+        return false;
+    }
+
+    point_cloud_frame_ = frame;
+
+    /* Create the point cloud attachment on first use, or when the format changes. */
+    if (point_cloud_ && (texture_point_cloud_ == 0 || point_cloud_format_ != format))
+    {
+        glDeleteTextures(1, &texture_point_cloud_);
+
+        if (format == PointCloudFormat::float16)
+            createColorAttachment(texture_point_cloud_, GL_COLOR_ATTACHMENT3, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+        else
+            createColorAttachment(texture_point_cloud_, GL_COLOR_ATTACHMENT3, GL_RGBA32F, GL_RGBA, GL_FLOAT);
+    }
+
+    point_cloud_format_ = format;
+
+    setUpFramebuffer();
+
+    clearRenderCache();
+
+    glfwMakeContextCurrent(nullptr);
+
+    return true;
+}
+
+
+bool SICAD::getPointCloudOpt() const
+{
+    return point_cloud_;
+}
+
+
+SICAD::PointCloudFrame SICAD::getPointCloudFrameOpt() const
+{
+    return point_cloud_frame_;
+}
+
+
+SICAD::PointCloudFormat SICAD::getPointCloudFormatOpt() const
+{
+    return point_cloud_format_;
+}
+
+
+bool SICAD::setStatisticsOpt(const bool measure_statistics)
+{
+    glfwMakeContextCurrent(window_);
+
+    const bool previous_statistics = statistics_;
+    statistics_ = measure_statistics;
+
+    /* Statistics are reduced from the instance IDs, written by the mesh model shader. */
+    if (!setUpMeshShaders())
+    {
+        statistics_ = previous_statistics;
+        setUpMeshShaders();
+
+        glfwMakeContextCurrent(nullptr);
+
+        return false;
+    }
+
+    /* Create the instance ID attachment on first use. */
+    if (useInstanceIds() && texture_instance_id_ == 0)
+        createColorAttachment(texture_instance_id_, GL_COLOR_ATTACHMENT1, GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT);
+
+    setUpFramebuffer();
+
+    if (!statistics_)
+    {
+        object_statistics_.clear();
+        statistics_tiles_.clear();
+        statistics_tiles_reduced_ = 0;
+        statistics_entries_ = 0;
+        queries_used_ = 0;
+    }
+
+    glfwMakeContextCurrent(nullptr);
+
+    return true;
+}
+
+
+bool SICAD::getStatisticsOpt() const
+{
+    return statistics_;
+}
+
+
+const std::vector<std::vector<SICAD::ObjectStatistics>>& SICAD::getStatistics() const
+{
+    return object_statistics_;
+}
+
+
+void SICAD::setReadbackOpt(const bool read_back)
+{
+    readback_ = read_back;
+}
+
+
+bool SICAD::getReadbackOpt() const
+{
+    return readback_;
+}
+
+
+void SICAD::setRenderCacheOpt
+(
+    const bool cache,
+    const double resolution
+)
+{
+    render_cache_ = cache;
+
+    if (resolution > 0.0 && resolution != render_cache_resolution_)
+    {
+        render_cache_resolution_ = resolution;
+        clearRenderCache();
+    }
+
+    if (!render_cache_)
+        clearRenderCache();
+}
+
+
+bool SICAD::getRenderCacheOpt() const
+{
+    return render_cache_;
+}
+
+
+double SICAD::getRenderCacheResolutionOpt() const
+{
+    return render_cache_resolution_;
+}
+
+
+void SICAD::clearRenderCache()
+{
+    /* The layers keep their storage, for the next calls. */
+    render_cache_keys_.clear();
+    render_cache_empty_tiles_.clear();
+
+    for (std::pair<const GLfloat, ScaleLayers>& layers : scale_layers_)
+    {
+        layers.second.render_cache_keys.clear();
+        layers.second.render_cache_empty_tiles.clear();
+    }
+}
+
+
+size_t SICAD::getRenderedTilesNumber() const
+{
+    return rendered_tiles_number_;
+}
+
+
+void SICAD::setStaticModels(const ModelPoseContainer& objpos_map)
+{
+    if (objpos_map == static_objpos_map_)
+        return;
+
+    static_objpos_map_ = objpos_map;
+    invalidateStaticScene();
+    clearRenderCache();
+}
+
+
+const Superimpose::ModelPoseContainer& SICAD::getStaticModels() const
+{
+    return static_objpos_map_;
+}
+
+
+void SICAD::setRoiOpt(const bool roi)
+{
+    roi_ = roi;
+}
+
+
+bool SICAD::getRoiOpt() const
+{
+    return roi_;
+}
+
+
+const std::vector<cv::Rect>& SICAD::getRois() const
+{
+    return rois_;
+}
+
+
+const std::vector<cv::Rect>& SICAD::getRoiAtlas() const
+{
+    return roi_atlas_;
+}
+
+
+void SICAD::setRoiPackingOpt(const bool pack)
+{
+    roi_packing_ = pack;
+}
+
+
+bool SICAD::getRoiPackingOpt() const
+{
+    return roi_packing_;
+}
+
+
+const std::vector<cv::Mat>& SICAD::getRoiImages() const
+{
+    return roi_images_;
+}
+
+
+bool SICAD::setResolutionScaleOpt(const GLfloat scale)
+{
+    if (!(scale > 0.0f && scale <= 1.0f))
+    {
+        std::cerr << "ERROR::SICAD::SETRESOLUTIONSCALEOPT\nERROR:\n\tResolution scale must be in (0, 1]." << std::endl;
+        return false;
+    }
+
+    glfwMakeContextCurrent(window_);
+
+    const bool switched = switchResolutionScale(scale);
+
+    glfwMakeContextCurrent(nullptr);
+
+    if (!switched)
+        return false;
+
+    empty_tiles_.clear();
+    object_statistics_.clear();
+
+    return true;
+}
+
+
+GLfloat SICAD::getResolutionScaleOpt() const
+{
+    return resolution_scale_;
+}
+
+
+bool SICAD::superimposeCascade
+(
+    const std::vector<ModelPoseContainer>& objpos_multimap,
+    const double* cam_x,
+    const double* cam_o,
+    const GLfloat scale,
+    const std::function<std::vector<size_t>(const cv::Mat&)>& select,
+    cv::Mat& img,
+    std::vector<size_t>& selected
+)
+{
+    selected.clear();
+
+    if (!(scale > 0.0f && scale < resolution_scale_))
+    {
+        std::cerr << "ERROR::SICAD::SUPERIMPOSECASCADE\nERROR:\n\tThe coarse resolution scale must be in (0, " << resolution_scale_ << ")." << std::endl;
+        return false;
+    }
+
+    /* Each level keeps its own static layer and render cache, see switchResolutionScale(). */
+    const GLfloat previous_scale = resolution_scale_;
+
+    glfwMakeContextCurrent(window_);
+    const bool switched = switchResolutionScale(scale);
+    glfwMakeContextCurrent(nullptr);
+
+    if (!switched)
+        return false;
+
+    /* The background, if any, is shared by both levels. */
+    cv::Mat coarse_img = getBackgroundOpt() ? img.clone() : cv::Mat();
+    const bool coarse_rendered = superimpose(objpos_multimap, cam_x, cam_o, coarse_img);
+
+    /* The selection runs at the coarse level, so that it can also use getStatistics() and getEmptyTiles(). */
+    if (coarse_rendered)
+        selected = select(coarse_img);
+
+    glfwMakeContextCurrent(window_);
+    switchResolutionScale(previous_scale);
+    glfwMakeContextCurrent(nullptr);
+
+    if (!coarse_rendered)
+        return false;
+
+    std::vector<ModelPoseContainer> fine_objpos_multimap;
+    fine_objpos_multimap.reserve(selected.size());
+
+    for (const size_t idx : selected)
+    {
+        if (!(idx < objpos_multimap.size()))
+        {
+            std::cerr << "ERROR::SICAD::SUPERIMPOSECASCADE\nERROR:\n\tSelected tile index out of bound." << std::endl;
+            selected.clear();
+
+            return false;
+        }
+
+        fine_objpos_multimap.push_back(objpos_multimap[idx]);
+    }
+
+    if (fine_objpos_multimap.empty())
+    {
+        img.release();
+
+        return true;
+    }
+
+    return superimpose(fine_objpos_multimap, cam_x, cam_o, img);
+}
+
+
+bool SICAD::setTensorOpt
+(
+    const TensorLayout& layout,
+    const TensorFormat& format,
+    const std::array<GLfloat, 3>& mean,
+    const std::array<GLfloat, 3>& std_dev
+)
+{
+    if (std_dev[0] == 0 || std_dev[1] == 0 || std_dev[2] == 0)
+    {
+        std::cerr << "ERROR::SICAD::SETTENSOROPT\nERROR:\n\tStandard deviations must not be 0." << std::endl;
+        return false;
+    }
+
+    tensor_layout_ = layout;
+    tensor_format_ = format;
+    tensor_mean_ = mean;
+    tensor_std_ = std_dev;
+
+    return true;
+}
+
+
+SICAD::TensorLayout SICAD::getTensorLayoutOpt() const
+{
+    return tensor_layout_;
+}
+
+
+SICAD::TensorFormat SICAD::getTensorFormatOpt() const
+{
+    return tensor_format_;
+}
+
+
+const std::array<GLfloat, 3>& SICAD::getTensorMeanOpt() const
+{
+    return tensor_mean_;
+}
+
+
+const std::array<GLfloat, 3>& SICAD::getTensorStdOpt() const
+{
+    return tensor_std_;
+}
+
+
+bool SICAD::superimposeTensor
+(
+    const std::vector<ModelPoseContainer>& objpos_multimap,
+    const double* cam_x,
+    const double* cam_o,
+    Tensor& tensor
+)
+{
+    const size_t objpos_num = objpos_multimap.size();
+    if (objpos_num == 0)
+        return false;
+
+    if (render_mode_ != RenderMode::color)
+    {
+        std::cerr << "ERROR::SICAD::SUPERIMPOSETENSOR\nERROR:\n\tTensors are available only in RenderMode::color." << std::endl;
+        return false;
+    }
+
+    glfwMakeContextCurrent(window_);
+
+    if (!setUpTensor())
+    {
+        glfwMakeContextCurrent(nullptr);
+
+        return false;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+    /* Swap in the models updated since the last frame. */
+    swapModels();
+
+    /* View transformation matrix. */
+    glm::mat4 view = getViewTransformationMatrix(cam_x, cam_o);
+
+    /* Install/Use the program specified by the shader. */
+    shader_cad_->install();
+    glUniformMatrix4fv(glGetUniformLocation(shader_cad_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
+    shader_cad_->uninstall();
+
+    shader_mesh_texture_->install();
+    glUniformMatrix4fv(glGetUniformLocation(shader_mesh_texture_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
+    shader_mesh_texture_->uninstall();
+
+    shader_frame_->install();
+    glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
+    shader_frame_->uninstall();
+
+    empty_tiles_.assign(objpos_num, true);
+    object_statistics_.assign(statistics_ ? objpos_num : 0, std::vector<ObjectStatistics>());
+
+    /* Render the static scene, unless cached. */
+    updateStaticScene(view);
+
+    rois_.clear();
+    roi_atlas_.clear();
+    roi_images_.clear();
+
+    /* The readback of a pass may run over its last texel row by up to one row, that the next pass overwrites. */
+    const size_t tiles_num = static_cast<size_t>(tiles_num_);
+    const size_t tile_elements = 3 * static_cast<size_t>(tile_img_width_) * tile_img_height_;
+    const size_t element_size = tensor_format_ == TensorFormat::float16 ? sizeof(GLushort) : sizeof(GLfloat);
+    tensor_data_.resize((objpos_num * tile_elements + 4 * static_cast<size_t>(tensor_width_)) * element_size);
+
+    for (size_t first = 0; first < objpos_num; first += tiles_num)
+    {
+        const size_t count = std::min(objpos_num - first, tiles_num);
+
+        renderTiles(objpos_multimap, first, count, view, nullptr, false);
+
+        writeTensorPass(first, count);
+    }
+
+    if (statistics_)
+        readStatistics();
+
+    rendered_tiles_number_ = objpos_num;
+
+    /* Swap the buffers. */
+    glfwSwapBuffers(window_);
+
+    pollOrPostEvent();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glfwMakeContextCurrent(nullptr);
+
+    const size_t height = static_cast<size_t>(tile_img_height_);
+    const size_t width = static_cast<size_t>(tile_img_width_);
+
+    tensor.data = tensor_data_.data();
+    tensor.layout = tensor_layout_;
+    tensor.format = tensor_format_;
+    tensor.element_size = element_size;
+
+    if (tensor_layout_ == TensorLayout::nchw)
+    {
+        tensor.shape = { { objpos_num, 3, height, width } };
+        tensor.strides = { { tile_elements, height * width, width, 1 } };
+    }
+    else
+    {
+        tensor.shape = { { objpos_num, height, width, 3 } };
+        tensor.strides = { { tile_elements, width * 3, 3, 1 } };
+    }
+
+    return true;
+}
+
+
+bool SICAD::getPointCloud
+(
+    const size_t tile,
+    void* points,
+    const size_t point_stride,
+    const bool compact,
+    size_t& points_number
+)
+{
+    points_number = 0;
+
+    if (!point_cloud_)
+    {
+        std::cerr << "ERROR::SICAD::GETPOINTCLOUD\nERROR:\n\tPoint cloud output is disabled." << std::endl;
+        return false;
+    }
+
+    if (!(tile < static_cast<size_t>(tiles_num_)))
+    {
+        std::cerr << "ERROR::SICAD::GETPOINTCLOUD\nERROR:\n\tSICAD tile index out of bound." << std::endl;
+        return false;
+    }
+
+    const bool half = point_cloud_format_ == PointCloudFormat::float16;
+    const size_t component_size = half ? sizeof(GLushort) : sizeof(GLfloat);
+    const size_t pixel_size = 4 * component_size;
+    const size_t point_size = 3 * component_size;
+
+    if (point_stride < point_size)
+    {
+        std::cerr << "ERROR::SICAD::GETPOINTCLOUD\nERROR:\n\tPoint stride is smaller than a point." << std::endl;
+        return false;
+    }
+
+
+    glfwMakeContextCurrent(window_);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+    /* Read the tile as the last superimpose() has left it in the framebuffer. */
+    std::vector<unsigned char> ogl_points(tile_img_width_ * tile_img_height_ * pixel_size);
+    glReadBuffer(GL_COLOR_ATTACHMENT3);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glReadPixels(tile_img_width_ * (tile % tiles_cols_), framebuffer_height_ - tile_img_height_ * (tile / tiles_cols_ + 1),
+                 tile_img_width_,                         tile_img_height_,
+                 GL_RGBA, half ? GL_HALF_FLOAT : GL_FLOAT, ogl_points.data());
+    glReadBuffer(render_mode_ == RenderMode::color ? GL_COLOR_ATTACHMENT0 : GL_NONE);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glfwMakeContextCurrent(nullptr);
+
+
+    /* Invalid points of organized point clouds are NaN. */
+    unsigned char invalid_point[3 * sizeof(GLfloat)];
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (half)
+        {
+            const GLushort half_nan = 0x7E00;
+            std::memcpy(invalid_point + i * component_size, &half_nan, component_size);
+        }
+        else
+        {
+            const GLfloat float_nan = std::numeric_limits<GLfloat>::quiet_NaN();
+            std::memcpy(invalid_point + i * component_size, &float_nan, component_size);
+        }
+    }
+
+    /* Points are stored row by row from the upper-left corner, while OpenGL rows are stored bottom-up.
+       Valid points have a non-zero fourth component. */
+    unsigned char* destination = static_cast<unsigned char*>(points);
+
+    for (GLsizei i = 0; i < tile_img_height_; ++i)
+    {
+        const unsigned char* row = ogl_points.data() + (tile_img_height_ - 1 - i) * tile_img_width_ * pixel_size;
+
+        for (GLsizei j = 0; j < tile_img_width_; ++j)
+        {
+            const unsigned char* pixel = row + j * pixel_size;
+
+            bool valid = false;
+            for (size_t k = point_size; k < pixel_size; ++k)
+                valid |= pixel[k] != 0;
+
+            if (valid)
+                std::memcpy(destination, pixel, point_size);
+            else if (!compact)
+                std::memcpy(destination, invalid_point, point_size);
+            else
+                continue;
+
+            destination += point_stride;
+            ++points_number;
+        }
+    }
+
+    return true;
+}
+
+
+std::vector<GLfloat> SICAD::getLevelOfDetailErrors(const std::string& mesh_id) const
+{
+    std::vector<GLfloat> errors;
+
+    auto iter_model = model_obj_.find(mesh_id);
+    if (iter_model != model_obj_.end())
+    {
+        for (size_t lod = 0; lod < (iter_model->second)->getLevelsOfDetail(); ++lod)
+            errors.push_back((iter_model->second)->getLevelOfDetailError(lod));
+    }
+
+    return errors;
+}
+
+
+std::shared_future<bool> SICAD::updateModel(const std::string& mesh_id, const std::string& path)
+{
+    return updateModel(mesh_id, path, Model::MemoryFileContainer());
+}
+
+
+std::shared_future<bool> SICAD::updateModel(const std::string& mesh_id, const std::string& path, const Model::MemoryFileContainer& files)
+{
+    size_t request;
+    {
+        std::lock_guard<std::mutex> lock(model_mutex_);
+
+        request = ++model_requests_[mesh_id];
+        ++models_importing_;
+    }
+
+    /* The future returned by std::async would block on destruction, hence a detached thread setting a promise. */
+    std::shared_ptr<std::promise<bool>> imported = std::make_shared<std::promise<bool>>();
+    std::shared_future<bool> future = imported->get_future().share();
+
+    std::thread([this, mesh_id, path, files, request, imported]()
+                {
+                    imported->set_value(importModel(mesh_id, path, files, request));
+
+                    std::lock_guard<std::mutex> lock(model_mutex_);
+                    --models_importing_;
+                    model_imported_.notify_all();
+                }).detach();
+
+    return future;
+}
+
+
+void SICAD::removeModel(const std::string& mesh_id)
+{
+    std::lock_guard<std::mutex> lock(model_mutex_);
+
+    ++model_requests_[mesh_id];
+
+    /* Pending models own OpenGL objects, deleted by the next swap on the rendering context. */
+    auto iter_pending = pending_models_.find(mesh_id);
+    if (iter_pending != pending_models_.end() && iter_pending->second != nullptr)
+        discarded_models_.push_back(std::make_pair(iter_pending->second, pending_fences_[mesh_id]));
+
+    pending_models_[mesh_id] = nullptr;
+    pending_fences_[mesh_id] = nullptr;
+}
+
+
+bool SICAD::hasModel(const std::string& mesh_id)
+{
+    std::lock_guard<std::mutex> lock(model_mutex_);
+
+    return model_obj_.find(mesh_id) != model_obj_.end();
+}
+
+
+const std::vector<bool>& SICAD::getEmptyTiles() const
+{
+    return empty_tiles_;
+}
+
+
+int SICAD::getTilesNumber() const
+{
+    return tiles_rows_ * tiles_cols_;
+}
+
+
+int SICAD::getTilesRows() const
+{
+    return tiles_rows_;
+}
+
+
+int SICAD::getTilesCols() const
+{
+    return tiles_cols_;
+}
+
+
+cv::Size SICAD::getTileSize() const
+{
+    return cv::Size(tile_img_width_, tile_img_height_);
+}
+
+
+glm::mat4 SICAD::getViewTransformationMatrix(const double* cam_x, const double* cam_o)
+{
+    glm::mat4 root_cam_t  = glm::translate(glm::mat4(1.0f),
+                                           glm::vec3(static_cast<float>(cam_x[0]), static_cast<float>(cam_x[1]), static_cast<float>(cam_x[2])));
+    glm::mat4 cam_to_root = glm::rotate(glm::mat4(1.0f),
+                                        static_cast<float>(cam_o[3]), glm::vec3(static_cast<float>(cam_o[0]), static_cast<float>(cam_o[1]), static_cast<float>(cam_o[2])));
+
+    glm::mat4 view = glm::lookAt(glm::vec3(root_cam_t[3].x, root_cam_t[3].y, root_cam_t[3].z),
+                                 glm::vec3(root_cam_t[3].x, root_cam_t[3].y, root_cam_t[3].z) + glm::mat3(cam_to_root) * ogl_to_cam_ * glm::vec3(0.0f, 0.0f, -1.0f),
+                                 glm::mat3(cam_to_root) * ogl_to_cam_ * glm::vec3(0.0f, 1.0f, 0.0f));
+
+    return view;
+}
+
+
+glm::mat4 SICAD::getModelTransformationMatrix(const double* pose)
+{
+    glm::mat4 model = glm::rotate(glm::mat4(1.0f), static_cast<float>(pose[6]), glm::vec3(static_cast<float>(pose[3]), static_cast<float>(pose[4]), static_cast<float>(pose[5])));
+    model[3][0] = static_cast<float>(pose[0]);
+    model[3][1] = static_cast<float>(pose[1]);
+    model[3][2] = static_cast<float>(pose[2]);
+
+    return model;
+}
+
+
+void SICAD::pollOrPostEvent()
+{
+    if(main_thread_id_ == std::this_thread::get_id())
+        glfwPollEvents();
+    else
+        glfwPostEmptyEvent();
+}
+
+
+std::vector<std::string> SICAD::getMeshShaderDefines(const bool textured) const
+{
+    std::vector<std::string> defines;
+
+    if (render_mode_ == RenderMode::depth)
+        defines.push_back("DEPTH_ONLY");
+    else if (textured)
+        defines.push_back("TEXTURED");
+
+    if (useInstanceIds())
+        defines.push_back("INSTANCE_ID");
+
+    if (correspondence_)
+        defines.push_back("CORRESPONDENCE");
+
+    if (point_cloud_)
+        defines.push_back("POINT_CLOUD");
+
+    return defines;
+}
+
+
+bool SICAD::setUpMeshShaders()
+{
+    mesh_shader_ = nullptr;
+    mesh_texture_shader_ = nullptr;
+
+    if (!useMeshShaders())
+        return true;
+
+    /* Compile the variants of the built-in mesh model shader on first use. */
+    try
+    {
+        if (!mesh_shaders_)
+            mesh_shaders_ = std::unique_ptr<ShaderVariants>(new ShaderVariants("__prc/shader/shader_mesh.vert", "__prc/shader/shader_mesh.frag"));
+
+        mesh_shader_ = &(mesh_shaders_->get(getMeshShaderDefines(false)));
+        mesh_texture_shader_ = &(mesh_shaders_->get(getMeshShaderDefines(true)));
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "ERROR::SICAD::SETUPMESHSHADERS\nERROR:\n\tFailed to create the mesh model shader programs.\n" << e.what() << std::endl;
+
+        return false;
+    }
+
+    return true;
+}
+
+
+bool SICAD::useMeshShaders() const
+{
+    /* The depth-only and the additional outputs are written by the variants of the built-in mesh model shader. */
+    return render_mode_ == RenderMode::depth || useInstanceIds() || correspondence_ || point_cloud_;
+}
+
+
+bool SICAD::useInstanceIds() const
+{
+    /* Statistics are reduced from the instance IDs. */
+    return instance_id_ || statistics_;
+}
+
+
+void SICAD::createColorAttachment
+(
+    GLuint& texture,
+    const GLenum attachment,
+    const GLint internal_format,
+    const GLenum format,
+    const GLenum type
+)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, attachment_width_, attachment_height_, 0, format, type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+
+bool SICAD::resizeAttachments()
+{
+    /* Attachments only grow, so that smaller grids and image sizes reuse their storage. */
+    if (framebuffer_width_ <= attachment_width_ && framebuffer_height_ <= attachment_height_)
+        return true;
+
+    attachment_width_ = std::max(attachment_width_, framebuffer_width_);
+    attachment_height_ = std::max(attachment_height_, framebuffer_height_);
+
+    /* Respecified storage is undefined. */
+    ++framebuffer_generation_;
+
+    /* Storage is respecified in place, so that textures stay attached to the framebuffer. */
+    const auto resize_texture = [this](const GLuint texture, const GLint internal_format, const GLenum format, const GLenum type)
+    {
+        if (texture == 0)
+            return;
+
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, attachment_width_, attachment_height_, 0, format, type, NULL);
+    };
+
+    resize_texture(texture_color_buffer_, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE);
+    resize_texture(texture_depth_buffer_, GL_DEPTH_COMPONENT, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE);
+    resize_texture(texture_instance_id_, GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT);
+    resize_texture(texture_correspondence_, GL_RGBA32UI, GL_RGBA_INTEGER, GL_UNSIGNED_INT);
+
+    if (point_cloud_format_ == PointCloudFormat::float16)
+        resize_texture(texture_point_cloud_, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+    else
+        resize_texture(texture_point_cloud_, GL_RGBA32F, GL_RGBA, GL_FLOAT);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete)
+    {
+        std::cerr << "ERROR::SICAD::RESIZEATTACHMENTS\nERROR:\n\tCustom framebuffer could not be resized." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+std::string SICAD::getCalibrationKey() const
+{
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+
+    return std::string(renderer != nullptr ? reinterpret_cast<const char*>(renderer) : "") + "\t" +
+           std::to_string(image_width_) + "\t" + std::to_string(image_height_) + "\t" + std::to_string(requested_images_);
+}
+
+
+bool SICAD::readCalibration(Calibration& calibration) const
+{
+    if (calibration_file_.empty())
+        return false;
+
+    std::ifstream file(calibration_file_);
+    if (!file.is_open())
+        return false;
+
+    /* Each line is: renderer, image width, image height, requested images, tiles columns, tiles rows, batch rows, PBO readback,
+       PBO depth, images per second. */
+    const std::string key = getCalibrationKey() + "\t";
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, key.size(), key) != 0)
+            continue;
+
+        std::istringstream values(line.substr(key.size()));
+
+        Calibration read;
+        if (!(values >> read.tiles_cols >> read.tiles_rows >> read.batch_rows >> read.pbo_readback >> read.pbo_depth >> read.images_per_second) ||
+            read.tiles_cols < 1 || read.tiles_rows < 1 || read.tiles_cols * read.tiles_rows < requested_images_ ||
+            read.tiles_cols * image_width_ > renderbuffer_size_ || read.tiles_rows * image_height_ > renderbuffer_size_ ||
+            read.batch_rows < 1 || read.batch_rows > read.tiles_rows || read.pbo_depth < 1 || read.pbo_depth > 3)
+            return false;
+
+        calibration = read;
+
+        return true;
+    }
+
+    return false;
+}
+
+
+bool SICAD::writeCalibration() const
+{
+    if (calibration_file_.empty())
+        return true;
+
+    /* Keep the entries of the other configurations and replace the one of the current configuration. */
+    glfwMakeContextCurrent(window_);
+    const std::string key = getCalibrationKey() + "\t";
+    glfwMakeContextCurrent(nullptr);
+
+    std::vector<std::string> lines;
+    {
+        std::ifstream file(calibration_file_);
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (!line.empty() && line.compare(0, key.size(), key) != 0)
+                lines.push_back(line);
+        }
+    }
+
+    std::ofstream file(calibration_file_, std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "ERROR::SICAD::WRITECALIBRATION\nERROR:\n\tCannot write the calibration file " << calibration_file_ << "." << std::endl;
+        return false;
+    }
+
+    for (const std::string& line : lines)
+        file << line << "\n";
+
+    file << key << calibration_.tiles_cols << "\t" << calibration_.tiles_rows << "\t" << calibration_.batch_rows << "\t"
+         << calibration_.pbo_readback << "\t" << calibration_.pbo_depth << "\t" << calibration_.images_per_second << "\n";
+
+    return static_cast<bool>(file);
+}
+
+
+void SICAD::applyCalibration()
+{
+    /* Without calibration, the default grid set up by setUpTiles() is kept. */
+    if (calibration_.tiles_cols > 0)
+        setUpGrid(calibration_.tiles_cols, calibration_.tiles_rows);
+
+    batch_rows_ = calibration_.batch_rows;
+
+    /* The number of PBOs to cycle with PBO readback is up to the caller, the multi-pass readback then uses the default ring. */
+    setUpBatchPBOs(calibration_.pbo_depth > 0 && !calibration_.pbo_readback ? calibration_.pbo_depth : 2);
+}
+
+
+double SICAD::benchmarkGrid
+(
+    const ModelPoseContainer& objpos_map,
+    const double* cam_x,
+    const double* cam_o,
+    const bool pbo_readback,
+    const size_t pbo_depth
+)
+{
+    const std::vector<ModelPoseContainer> objposes(requested_images_, objpos_map);
+    const int repetitions = 10;
+
+    cv::Mat img;
+
+    /* The first passes warm up the driver and fill the ring of PBOs, and are not measured. */
+    const int warm_up = pbo_readback ? static_cast<int>(pbo_depth) : 1;
+
+    std::chrono::steady_clock::time_point start;
+    for (int i = 0; i < warm_up + repetitions; ++i)
+    {
+        if (i == warm_up)
+            start = std::chrono::steady_clock::now();
+
+        if (pbo_readback)
+        {
+            if (!superimpose(objposes, cam_x, cam_o, i % pbo_depth))
+                return 0.0;
+
+            /* Mapping waits for the readback of the oldest PBO of the ring, as any consumer of the PBOs would. */
+            if (i + 1 >= static_cast<int>(pbo_depth))
+            {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[(i + 1) % pbo_depth]);
+                glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, pbo_size_, GL_MAP_READ_BIT);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            }
+
+            releaseContext();
+        }
+        else if (!superimpose(objposes, cam_x, cam_o, img))
+            return 0.0;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return seconds > 0.0 ? repetitions * requested_images_ / seconds : 0.0;
+}
+
+
+void SICAD::setUpFramebuffer()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+    /* Color is neither drawn nor read in depth mode. Instance IDs, correspondences and point clouds are drawn to the second, third and fourth color attachments. */
+    GLenum draw_buffers[] = { GL_COLOR_ATTACHMENT0, GL_NONE, GL_NONE, GL_NONE };
+    GLsizei draw_buffers_number = 1;
+    if (render_mode_ == RenderMode::depth)
+        draw_buffers[0] = GL_NONE;
+    if (useInstanceIds())
+    {
+        draw_buffers[1] = GL_COLOR_ATTACHMENT1;
+        draw_buffers_number = 2;
+    }
+    if (correspondence_)
+    {
+        draw_buffers[2] = GL_COLOR_ATTACHMENT2;
+        draw_buffers_number = 3;
+    }
+    if (point_cloud_)
+    {
+        draw_buffers[3] = GL_COLOR_ATTACHMENT3;
+        draw_buffers_number = 4;
+    }
+
+    glDrawBuffers(draw_buffers_number, draw_buffers);
+
+    glReadBuffer(render_mode_ == RenderMode::color ? GL_COLOR_ATTACHMENT0 : GL_NONE);
+
+    color_writes_ = !(render_mode_ == RenderMode::depth && draw_buffers_number == 1);
+
+    if (color_writes_)
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    else
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+
+void SICAD::maskAuxiliaryOutputs(const bool mask) const
+{
+    /* Shaders other than the built-in mesh model one write color only, leaving the other color attachments undefined. */
+    const GLboolean write = mask ? GL_FALSE : GL_TRUE;
+
+    if (useInstanceIds())
+        glColorMaski(1, write, write, write, write);
+
+    if (correspondence_)
+        glColorMaski(2, write, write, write, write);
+
+    if (point_cloud_)
+        glColorMaski(3, write, write, write, write);
+}
+
+
+void SICAD::allocatePBOs()
+{
+    /* Color is read back as 3 bytes per pixel, depth as 1 float per pixel. */
+    const size_t pixel_size = render_mode_ == RenderMode::depth ? sizeof(GLfloat) : 3;
+
+    /* PBOs only grow, so that smaller grids and image sizes reuse their storage. */
+    const size_t pbo_size = framebuffer_width_ * framebuffer_height_ * pixel_size;
+    if (pbo_size <= pbo_size_)
+        return;
+
+    pbo_size_ = pbo_size;
+
+    for (size_t i = 0; i < pbo_number_; ++i)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, pbo_size_, 0, GL_STREAM_READ);
+    }
+
+    for (const GLuint batch_pbo : batch_pbo_)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, batch_pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, pbo_size_, 0, GL_STREAM_READ);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+
+void SICAD::setUpBatchPBOs(const size_t depth)
+{
+    const size_t previous_depth = batch_pbo_.size();
+    if (depth == previous_depth)
+        return;
+
+    if (depth < previous_depth)
+    {
+        glDeleteBuffers(static_cast<GLsizei>(previous_depth - depth), batch_pbo_.data() + depth);
+        batch_pbo_.resize(depth);
+
+        return;
+    }
+
+    batch_pbo_.resize(depth);
+    glGenBuffers(static_cast<GLsizei>(depth - previous_depth), batch_pbo_.data() + previous_depth);
+
+    /* New PBOs match the size of the others, unless they are allocated later by allocatePBOs(). */
+    if (pbo_size_ > 0)
+    {
+        for (size_t i = previous_depth; i < depth; ++i)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, batch_pbo_[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, pbo_size_, 0, GL_STREAM_READ);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+}
+
+
+size_t SICAD::getBatchTiles() const
+{
+    /* Batches smaller than the render grid hold the rendered images only, and are not cached. */
+    if (batch_rows_ < 1 || batch_rows_ >= tiles_rows_ || roi_ || instance_id_ || correspondence_ || point_cloud_ || useRenderCache())
+        return static_cast<size_t>(tiles_num_);
+
+    return static_cast<size_t>(batch_rows_) * tiles_cols_;
+}
+
+
+void SICAD::clearBuffers()
+{
+    ++framebuffer_generation_;
+
+    /* glClear() is undefined on integer color buffers, hence color buffers are cleared one by one. */
+    if (render_mode_ == RenderMode::color)
+    {
+        const GLfloat background_color[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        glClearBufferfv(GL_COLOR, 0, background_color);
+    }
+
+    if (useInstanceIds())
+    {
+        const GLuint background_id[] = { 0, 0, 0, 0 };
+        glClearBufferuiv(GL_COLOR, 1, background_id);
+    }
+
+    if (correspondence_)
+    {
+        const GLuint background_correspondence[] = { 0, 0, 0, 0 };
+        glClearBufferuiv(GL_COLOR, 2, background_correspondence);
+    }
+
+    if (point_cloud_)
+    {
+        const GLfloat background_point[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        glClearBufferfv(GL_COLOR, 3, background_point);
+    }
+
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+
+void SICAD::readPixels
+(
+    const GLint x,
+    const GLint y,
+    const GLsizei width,
+    const GLsizei height,
+    cv::Mat& img
+)
+{
+    if (statistics_)
+        readStatistics();
+
+    if (!readback_)
+        return;
+
+    if (instance_id_)
+        readInstanceIds(x, y, width, height);
+
+    if (correspondence_)
+        readCorrespondences(x, y, width, height);
+
+    readImage(x, y, width, height, img);
+}
+
+
+void SICAD::readImage
+(
+    const GLint x,
+    const GLint y,
+    const GLsizei width,
+    const GLsizei height,
+    cv::Mat& img
+)
+{
+    /* See: http://stackoverflow.com/questions/16809833/opencv-image-loading-for-opengl-texture#16812529
+       and http://stackoverflow.com/questions/9097756/converting-data-from-glreadpixels-to-opencvmat#9098883 */
+    if (render_mode_ == RenderMode::depth)
+    {
+        cv::Mat ogl_depth(height, width, CV_32FC1);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glPixelStorei(GL_PACK_ROW_LENGTH, ogl_depth.step/ogl_depth.elemSize());
+        glReadPixels(x, y, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, ogl_depth.data);
+
+        cv::flip(ogl_depth, img, 0);
+
+        linearizeDepth(img);
+    }
+    else
+    {
+        cv::Mat ogl_pixel(height, width, CV_8UC3);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glPixelStorei(GL_PACK_ALIGNMENT, (ogl_pixel.step & 3) ? 1 : 4);
+        glPixelStorei(GL_PACK_ROW_LENGTH, ogl_pixel.step/ogl_pixel.elemSize());
+        glReadPixels(x, y, width, height, GL_BGR, GL_UNSIGNED_BYTE, ogl_pixel.data);
+
+        cv::flip(ogl_pixel, img, 0);
+    }
+}
+
+
+void SICAD::readPixels
+(
+    const GLint x,
+    const GLint y,
+    const GLsizei width,
+    const GLsizei height,
+    const size_t pbo_index
+)
+{
+    if (statistics_)
+        readStatistics();
+
+    if (!readback_)
+        return;
+
+    /* Instance IDs and correspondences are read to memory, hence before binding the PBO. */
+    if (instance_id_)
+        readInstanceIds(x, y, width, height);
+
+    if (correspondence_)
+        readCorrespondences(x, y, width, height);
+
+    /* Pixels are tightly packed in the PBO. */
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_[pbo_index]);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+    if (render_mode_ == RenderMode::depth)
+    {
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(x, y, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, 0);
+    }
+    else
+    {
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(x, y, width, height, GL_BGR, GL_UNSIGNED_BYTE, 0);
+    }
+}
+
+
+GLsizei SICAD::getTilesHeight(const size_t tiles) const
+{
+    return static_cast<GLsizei>((tiles + tiles_cols_ - 1) / tiles_cols_) * tile_img_height_;
+}
+
+
+void SICAD::renderTiles
+(
+    const std::vector<ModelPoseContainer>& objpos_multimap,
+    const size_t first,
+    const size_t count,
+    const glm::mat4& view,
+    const cv::Mat* background,
+    const bool use_rois
+)
+{
+    /* Tiles left over in the last row of the pass are cleared only, so that stale pixels are not read back. */
+    const size_t rows = (count + tiles_cols_ - 1) / tiles_cols_;
+
+    for (size_t k = 0; k < rows * tiles_cols_; ++k)
+    {
+        if (k < count)
+            renderTile(objpos_multimap[first + k], k, first + k, view, background, use_rois);
+        else
+        {
+            setTileViewport(k);
+            clearBuffers();
+        }
+    }
+
+    /* Statistics are reduced before the next pass overwrites the render grid. */
+    if (statistics_)
+        reduceStatistics();
+}
+
+
+void SICAD::setTileViewport(const size_t tile) const
+{
+    const GLsizei i = tile / tiles_cols_;
+    const GLsizei j = tile % tiles_cols_;
+
+    /* Render starting by the upper-left-most tile of the render grid, proceding by columns and rows. */
+    glViewport(tile_img_width_ * j, framebuffer_height_ - (tile_img_height_ * (i + 1)),
+               tile_img_width_,     tile_img_height_                                   );
+    glScissor (tile_img_width_ * j, framebuffer_height_ - (tile_img_height_ * (i + 1)),
+               tile_img_width_,     tile_img_height_                                   );
+}
+
+
+void SICAD::renderTile
+(
+    const ModelPoseContainer& objpos_map,
+    const size_t tile,
+    const size_t index,
+    const glm::mat4& view,
+    const cv::Mat* background,
+    const bool use_roi
+)
+{
+    setTileViewport(tile);
+
+    /* Clear, draw and read back only the ROI, if enabled. */
+    if (use_roi)
+    {
+        rois_[index] = getTileRoi(objpos_map, view);
+        scissorRoi(tile, rois_[index]);
+    }
+
+    /* Clear the colorbuffer, unless masked, and the depthbuffer. */
+    clearBuffers();
+
+    /* Draw the background picture. */
+    if (background != nullptr && getBackgroundOpt() && render_mode_ == RenderMode::color)
+        renderBackground(*background);
+
+    /* View mesh filled or as wireframe. */
+    setWireframe(getWireframeOpt());
+
+    /* Draw the mesh models. */
+    drawStaticScene(view, tile);
+    empty_tiles_[index] = !renderModels(objpos_map, view);
+
+    if (statistics_)
+        queueStatistics(objpos_map, view, tile, index, use_roi);
+}
+
+
+bool SICAD::setUpRenderCacheLayer()
+{
+    const cv::Size size(framebuffer_width_, framebuffer_height_);
+    if (render_cache_fbo_ != 0 && render_cache_size_ == size)
+        return true;
+
+    if (render_cache_fbo_ == 0)
+        glGenFramebuffers(1, &render_cache_fbo_);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, render_cache_fbo_);
+
+    /* The layer is as large as the framebuffer and has the same formats, as required to blit it. */
+    glDeleteTextures(1, &texture_render_cache_color_);
+    glDeleteTextures(1, &texture_render_cache_depth_);
+
+    glGenTextures(1, &texture_render_cache_color_);
+    glBindTexture(GL_TEXTURE_2D, texture_render_cache_color_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, framebuffer_width_, framebuffer_height_, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_render_cache_color_, 0);
+
+    glGenTextures(1, &texture_render_cache_depth_);
+    glBindTexture(GL_TEXTURE_2D, texture_render_cache_depth_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, framebuffer_width_, framebuffer_height_, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture_render_cache_depth_, 0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+    if (!complete)
+    {
+        std::cerr << "ERROR::SICAD::SETUPRENDERCACHELAYER\nERROR:\n\tRender cache framebuffer could not be created." << std::endl;
+
+        render_cache_size_ = cv::Size();
+
+        return false;
+    }
+
+    render_cache_size_ = size;
+
+    return true;
+}
+
+
+bool SICAD::renderCachedTiles
+(
+    const std::vector<ModelPoseContainer>& objpos_multimap,
+    const double* cam_x,
+    const double* cam_o,
+    const glm::mat4& view,
+    cv::Mat& img
+)
+{
+    /* Changes of the projection, of the render mode, of the framebuffer and of the tile size invalidate all the cached tiles. */
+    if (render_cache_projection_ != projection_ || render_cache_mode_ != render_mode_ || render_cache_mesh_mode_ != show_mesh_mode_ ||
+        render_cache_size_ != cv::Size(framebuffer_width_, framebuffer_height_) || render_cache_tile_size_ != cv::Size(tile_img_width_, tile_img_height_))
+    {
+        clearRenderCache();
+
+        /* Tiles are rendered without cache if the layer cannot be created. */
+        if (!setUpRenderCacheLayer())
+            return false;
+
+        render_cache_projection_ = projection_;
+        render_cache_mode_ = render_mode_;
+        render_cache_mesh_mode_ = show_mesh_mode_;
+        render_cache_tile_size_ = cv::Size(tile_img_width_, tile_img_height_);
+    }
+
+    /* Tiles of the previous call are still in the framebuffer, unless it has been drawn or resized since then. */
+    const bool in_framebuffer = render_cache_generation_ == framebuffer_generation_;
+
+    const size_t count = objpos_multimap.size();
+
+    std::unordered_map<RenderCacheKey, size_t, RenderCacheKeyHash> cached_tiles;
+    for (size_t j = 0; j < render_cache_keys_.size(); ++j)
+        cached_tiles.emplace(render_cache_keys_[j], j);
+
+    /* Each tile is kept in the framebuffer, copied from the layer of the previous call, copied from an earlier duplicate in the batch, or rendered. */
+    std::vector<RenderCacheKey> keys(count);
+    std::unordered_map<RenderCacheKey, size_t, RenderCacheKeyHash> batch_tiles;
+    std::vector<std::pair<size_t, size_t>> duplicates;
+    std::vector<std::pair<size_t, size_t>> copies;
+    std::vector<bool> changed(count, true);
+    size_t rendered = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+        keys[k] = getRenderCacheKey(objpos_multimap[k], cam_x, cam_o);
+
+        auto iter_batch = batch_tiles.find(keys[k]);
+        if (iter_batch != batch_tiles.end())
+        {
+            duplicates.emplace_back(k, iter_batch->second);
+            empty_tiles_[k] = empty_tiles_[iter_batch->second];
+            continue;
+        }
+
+        batch_tiles.emplace(keys[k], k);
+
+        auto iter_cached = cached_tiles.find(keys[k]);
+        if (iter_cached != cached_tiles.end())
+        {
+            const size_t j = iter_cached->second;
+            empty_tiles_[k] = render_cache_empty_tiles_[j];
+
+            /* The layer already holds the tiles that do not move. */
+            changed[k] = j != k;
+
+            if (j != k || !in_framebuffer)
+                copies.emplace_back(k, j);
+
+            continue;
+        }
+
+        renderTile(objpos_multimap[k], k, k, view, nullptr, false);
+        ++rendered;
+    }
+
+    /* The layer is read, hence not overwritten, before it is updated below. */
+    for (const std::pair<size_t, size_t>& copy : copies)
+        blitTile(render_cache_fbo_, copy.second, fbo_, copy.first);
+
+    /* Tiles of the same framebuffer can be blitted as they never overlap. */
+    for (const std::pair<size_t, size_t>& duplicate : duplicates)
+        blitTile(fbo_, duplicate.second, fbo_, duplicate.first);
+
+    /* Tiles left over in the last row are cleared only, so that stale pixels are not read back. */
+    const size_t rows = (count + tiles_cols_ - 1) / tiles_cols_;
+    for (size_t k = count; k < rows * tiles_cols_; ++k)
+    {
+        setTileViewport(k);
+        clearBuffers();
+    }
+
+    /* Read before swap. glReadPixels read the current framebuffer, i.e. the back one. The rows of tiles in use are read at once. */
+    const GLsizei used_height = getTilesHeight(count);
+    readImage(0, framebuffer_height_ - used_height, framebuffer_width_, used_height, img);
+
+    for (size_t k = 0; k < count; ++k)
+    {
+        if (changed[k])
+            blitTile(fbo_, k, render_cache_fbo_, k);
+    }
+
+    rendered_tiles_number_ = rendered;
+
+    render_cache_keys_ = keys;
+    render_cache_empty_tiles_ = empty_tiles_;
+    render_cache_generation_ = ++framebuffer_generation_;
+
+    return true;
+}
+
+
+void SICAD::blitTile(const GLuint read_fbo, const size_t read_tile, const GLuint draw_fbo, const size_t draw_tile)
+{
+    const GLint read_x = tile_img_width_ * (read_tile % tiles_cols_);
+    const GLint read_y = framebuffer_height_ - tile_img_height_ * (read_tile / tiles_cols_ + 1);
+    const GLint draw_x = tile_img_width_ * (draw_tile % tiles_cols_);
+    const GLint draw_y = framebuffer_height_ - tile_img_height_ * (draw_tile / tiles_cols_ + 1);
+
+    /* Blitting is subject to the scissor test. */
+    glScissor(draw_x, draw_y, tile_img_width_, tile_img_height_);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read_fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_fbo);
+    glBlitFramebuffer(read_x, read_y, read_x + tile_img_width_, read_y + tile_img_height_,
+                      draw_x, draw_y, draw_x + tile_img_width_, draw_y + tile_img_height_,
+                      (render_mode_ == RenderMode::color ? GL_COLOR_BUFFER_BIT : 0) | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+}
+
+
+SICAD::RenderCacheKey SICAD::getRenderCacheKey
+(
+    const ModelPoseContainer& objpos_map,
+    const double* cam_x,
+    const double* cam_o
+) const
+{
+    RenderCacheKey key;
+    key.values.reserve(7 + 7 * objpos_map.size());
+
+    const double resolution = render_cache_resolution_;
+    const auto quantize = [resolution](const double value)
+    {
+        return static_cast<long long>(std::llround(value / resolution));
+    };
+
+    for (int i = 0; i < 3; ++i)
+        key.values.push_back(quantize(cam_x[i]));
+
+    for (int i = 0; i < 4; ++i)
+        key.values.push_back(quantize(cam_o[i]));
+
+    for (const ModelPoseContainer::value_type& pair : objpos_map)
+    {
+        key.tags.push_back(pair.first);
+
+        /* The number of values separates the poses of different models. */
+        key.values.push_back(static_cast<long long>(pair.second.size()));
+        for (const double value : pair.second)
+            key.values.push_back(quantize(value));
+    }
+
+    /* Hashes are combined as boost::hash_combine() does. Quantized values are mixed first, as std::hash<long long>
+       may be the identity, which would make nearby poses collide. */
+    const auto combine = [&key](const size_t hash)
+    {
+        key.hash ^= hash + 0x9e3779b9 + (key.hash << 6) + (key.hash >> 2);
+    };
+
+    for (const std::string& tag : key.tags)
+        combine(std::hash<std::string>()(tag));
+
+    for (const long long value : key.values)
+    {
+        unsigned long long mixed = static_cast<unsigned long long>(value);
+        mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebULL;
+        mixed ^= mixed >> 31;
+
+        combine(static_cast<size_t>(mixed));
+    }
+
+    return key;
+}
+
+
+bool SICAD::useRenderCache() const
+{
+    /* Cached tiles hold the rendered images only. */
+    return render_cache_ && readback_ && !roi_ && !statistics_ && !instance_id_ && !correspondence_ && !point_cloud_ && !getBackgroundOpt();
+}
+
+
+void SICAD::readBatchPass(const size_t pass, const size_t count)
+{
+    const GLsizei height = getTilesHeight(count);
+
+    /* Pixels are tightly packed in the PBO. */
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, batch_pbo_[pass % batch_pbo_.size()]);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+    if (render_mode_ == RenderMode::depth)
+    {
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, framebuffer_height_ - height, framebuffer_width_, height, GL_DEPTH_COMPONENT, GL_FLOAT, 0);
+    }
+    else
+    {
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, framebuffer_height_ - height, framebuffer_width_, height, GL_BGR, GL_UNSIGNED_BYTE, 0);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+
+void SICAD::copyBatchPass
+(
+    const size_t pass,
+    const size_t first,
+    const size_t count,
+    cv::Mat& img
+)
+{
+    /* Passes hold whole rows of tiles, hence the first tile of a pass starts a row of img. */
+    const GLsizei height = getTilesHeight(count);
+    const int row_offset = static_cast<int>(first / tiles_cols_) * tile_img_height_;
+    const size_t row_size = framebuffer_width_ * img.elemSize();
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, batch_pbo_[pass % batch_pbo_.size()]);
+
+    const unsigned char* pixels = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, row_size * height, GL_MAP_READ_BIT));
+    if (pixels != nullptr)
+    {
+        /* OpenGL rows are stored bottom-up. */
+        for (GLsizei r = 0; r < height; ++r)
+            std::memcpy(img.ptr(row_offset + height - 1 - r), pixels + r * row_size, row_size);
+
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (render_mode_ == RenderMode::depth)
+    {
+        cv::Mat pass_depth = img.rowRange(row_offset, row_offset + height);
+        linearizeDepth(pass_depth);
+    }
+}
+
+
+bool SICAD::setUpTensor()
+{
+    /* Compile the tensor shader on first use. */
+    if (!tensor_shader_)
+    {
+        try
+        {
+            tensor_shader_ = std::unique_ptr<Shader>(new Shader("__prc/shader/shader_tensor.vert", "__prc/shader/shader_tensor.frag"));
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << "ERROR::SICAD::SETUPTENSOR\nERROR:\n\tFailed to create the tensor shader program.\n" << e.what() << std::endl;
+
+            return false;
+        }
+
+        /* The shader draws a single triangle from the vertex IDs, with no vertex attribute. */
+        glGenVertexArrays(1, &vao_tensor_);
+
+        /* The color attachment is sampled with no mipmaps. */
+        glBindTexture(GL_TEXTURE_2D, texture_color_buffer_);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    /* The texture fits the tensor of a full render grid, 4 elements per texel, in rows as long as 4096 texels at most. */
+    const size_t texels = (static_cast<size_t>(tiles_num_) * 3 * tile_img_width_ * tile_img_height_ + 3) / 4;
+    const GLsizei width = static_cast<GLsizei>(std::min<size_t>(std::min<GLsizei>(renderbuffer_size_, 4096), texels));
+    const GLsizei height = static_cast<GLsizei>((texels + width - 1) / width);
+    if (height > renderbuffer_size_)
+    {
+        std::cerr << "ERROR::SICAD::SETUPTENSOR\nERROR:\n\tThe tensor of the render grid exceeds the maximum texture size." << std::endl;
+        return false;
+    }
+
+    const GLint internal_format = tensor_format_ == TensorFormat::float16 ? GL_RGBA16F : GL_RGBA32F;
+    if (width == tensor_width_ && height == tensor_height_ && internal_format == tensor_internal_format_)
+        return true;
+
+    if (tensor_fbo_ == 0)
+        glGenFramebuffers(1, &tensor_fbo_);
+
+    if (texture_tensor_ == 0)
+        glGenTextures(1, &texture_tensor_);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, tensor_fbo_);
+
+    glBindTexture(GL_TEXTURE_2D, texture_tensor_);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, GL_RGBA, tensor_format_ == TensorFormat::float16 ? GL_HALF_FLOAT : GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_tensor_, 0);
+
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete)
+    {
+        std::cerr << "ERROR::SICAD::SETUPTENSOR\nERROR:\n\tTensor framebuffer could not be created." << std::endl;
+
+        tensor_width_ = 0;
+        tensor_height_ = 0;
+        tensor_internal_format_ = 0;
+
+        return false;
+    }
+
+    tensor_width_ = width;
+    tensor_height_ = height;
+    tensor_internal_format_ = internal_format;
+
+    return true;
+}
+
+
+void SICAD::writeTensorPass(const size_t first, const size_t count)
+{
+    const size_t tile_elements = 3 * static_cast<size_t>(tile_img_width_) * tile_img_height_;
+    const size_t texels = (count * tile_elements + 3) / 4;
+    const GLsizei rows = static_cast<GLsizei>((texels + tensor_width_ - 1) / tensor_width_);
+
+    /* Each fragment of the tensor texture computes 4 consecutive elements of the tensor from the color attachment. */
+    glBindFramebuffer(GL_FRAMEBUFFER, tensor_fbo_);
+
+    glViewport(0, 0, tensor_width_, rows);
+    glScissor (0, 0, tensor_width_, rows);
+
+    glDisable(GL_DEPTH_TEST);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    const GLuint program = tensor_shader_->get_program();
+    tensor_shader_->install();
+    glUniform1i(glGetUniformLocation(program, "color"), 0);
+    glUniform2i(glGetUniformLocation(program, "tile_size"), tile_img_width_, tile_img_height_);
+    glUniform1i(glGetUniformLocation(program, "tiles_cols"), tiles_cols_);
+    glUniform1i(glGetUniformLocation(program, "tiles_count"), static_cast<GLint>(count));
+    glUniform1i(glGetUniformLocation(program, "framebuffer_height"), framebuffer_height_);
+    glUniform1i(glGetUniformLocation(program, "tensor_width"), tensor_width_);
+    glUniform1i(glGetUniformLocation(program, "channels_first"), tensor_layout_ == TensorLayout::nchw);
+    glUniform3f(glGetUniformLocation(program, "mean"), tensor_mean_[0], tensor_mean_[1], tensor_mean_[2]);
+    glUniform3f(glGetUniformLocation(program, "inverse_std"), 1.0f / tensor_std_[0], 1.0f / tensor_std_[1], 1.0f / tensor_std_[2]);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture_color_buffer_);
+
+    glBindVertexArray(vao_tensor_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    tensor_shader_->uninstall();
+
+    glEnable(GL_DEPTH_TEST);
+
+    /* Texel rows are stored in order, so that the elements of the pass are contiguous. */
+    const bool half = tensor_format_ == TensorFormat::float16;
+    const size_t element_size = half ? sizeof(GLushort) : sizeof(GLfloat);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, tensor_width_, rows, GL_RGBA, half ? GL_HALF_FLOAT : GL_FLOAT, tensor_data_.data() + first * tile_elements * element_size);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+}
+
+
+void SICAD::readRois(const size_t count, const GLsizei width, cv::Mat& img)
+{
+    if (statistics_)
+        readStatistics();
+
+    if (!readback_)
+        return;
+
+    const bool depth = render_mode_ == RenderMode::depth;
+    const int type = depth ? CV_32FC1 : CV_8UC3;
+
+    roi_atlas_.assign(count, cv::Rect());
+    roi_images_.assign(count, cv::Mat());
+
+    if (roi_packing_)
+    {
+        /* Pack the ROIs in an atlas as wide as the framebuffer, left to right on shelves as high as their highest ROI. */
+        int atlas_width = 0;
+        int shelf_x = 0;
+        int shelf_y = 0;
+        int shelf_height = 0;
+        for (size_t k = 0; k < count; ++k)
+        {
+            const cv::Rect& roi = rois_[k];
+            if (roi.area() == 0)
+                continue;
+
+            if (shelf_x > 0 && shelf_x + roi.width > framebuffer_width_)
+            {
+                shelf_y += shelf_height;
+                shelf_x = 0;
+                shelf_height = 0;
+            }
+
+            roi_atlas_[k] = cv::Rect(shelf_x, shelf_y, roi.width, roi.height);
+
+            shelf_x += roi.width;
+            shelf_height = std::max(shelf_height, roi.height);
+            atlas_width = std::max(atlas_width, shelf_x);
+        }
+
+        if (atlas_width == 0)
+        {
+            img.release();
+            return;
+        }
+
+        img = cv::Mat::zeros(shelf_y + shelf_height, atlas_width, type);
+    }
+    else
+    {
+        /* The ROIs stay in their tiles. */
+        for (size_t k = 0; k < count; ++k)
+        {
+            if (rois_[k].area() > 0)
+                roi_atlas_[k] = rois_[k] + cv::Point(tile_img_width_ * (k % tiles_cols_), tile_img_height_ * (k / tiles_cols_));
+        }
+
+        img = cv::Mat::zeros(getTilesHeight(count), width, type);
+    }
+
+    /* The ROIs are read back to back to a PBO, whose storage holds the whole framebuffer, and copied once all of them are read. */
+    const size_t pixel_size = img.elemSize();
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, batch_pbo_[0]);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, depth ? 4 : 1);
+    if (!depth)
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    std::vector<size_t> offsets(count, 0);
+    size_t size = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+        const cv::Rect& roi = rois_[k];
+        if (roi.area() == 0)
+            continue;
+
+        offsets[k] = size;
+        glReadPixels(tile_img_width_ * (k % tiles_cols_) + roi.x, framebuffer_height_ - tile_img_height_ * (k / tiles_cols_) - roi.y - roi.height,
+                     roi.width, roi.height, depth ? GL_DEPTH_COMPONENT : GL_BGR, depth ? GL_FLOAT : GL_UNSIGNED_BYTE, reinterpret_cast<void*>(size));
+
+        size += roi.area() * pixel_size;
+    }
+
+    const unsigned char* pixels = size > 0 ? static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT)) : nullptr;
+    if (pixels != nullptr)
+    {
+        for (size_t k = 0; k < count; ++k)
+        {
+            const cv::Rect& roi = rois_[k];
+            if (roi.area() == 0)
+                continue;
+
+            cv::Mat roi_img = img(roi_atlas_[k]);
+            const size_t row_size = roi.width * pixel_size;
+
+            /* OpenGL rows are stored bottom-up. */
+            for (int r = 0; r < roi.height; ++r)
+                std::memcpy(roi_img.ptr(roi.height - 1 - r), pixels + offsets[k] + r * row_size, row_size);
+
+            if (depth)
+                linearizeDepth(roi_img);
+
+            roi_images_[k] = roi_img;
+        }
+
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+
+cv::Rect SICAD::getTileRoi(const ModelPoseContainer& objpos_map, const glm::mat4& view)
+{
+    cv::Rect roi;
+
+    for (const ModelPoseContainer::value_type& pair : objpos_map)
+    {
+        /* Reference frames have no bounding box, hence they take the whole tile. */
+        if (pair.first == "frame")
+            return cv::Rect(0, 0, tile_img_width_, tile_img_height_);
+
+        auto iter_model = model_obj_.find(pair.first);
+        if (iter_model == model_obj_.end())
+            continue;
+
+        const glm::mat4 model_view = view * getModelTransformationMatrix(pair.second.data());
+        if (!isInsideFrustum(*(iter_model->second), model_view))
+            continue;
+
+        ObjectStatistics bounds;
+        projectBoundingBox(*(iter_model->second), model_view, bounds);
+
+        roi = roi.area() == 0 ? bounds.bounding_box : (roi | bounds.bounding_box);
+    }
+
+    return roi;
+}
+
+
+void SICAD::scissorRoi(const size_t tile, const cv::Rect& roi) const
+{
+    /* ROIs are in image coordinates, from the upper-left corner of the tile. */
+    glScissor(tile_img_width_ * (tile % tiles_cols_) + roi.x, framebuffer_height_ - tile_img_height_ * (tile / tiles_cols_) - roi.y - roi.height,
+              roi.width,                                     roi.height);
+}
+
+
+void SICAD::readInstanceIds
+(
+    const GLint x,
+    const GLint y,
+    const GLsizei width,
+    const GLsizei height
+)
+{
+    cv::Mat ogl_ids(height, width, CV_16UC1);
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    glPixelStorei(GL_PACK_ALIGNMENT, (ogl_ids.step & 3) ? 2 : 4);
+    glPixelStorei(GL_PACK_ROW_LENGTH, ogl_ids.step/ogl_ids.elemSize());
+    glReadPixels(x, y, width, height, GL_RED_INTEGER, GL_UNSIGNED_SHORT, ogl_ids.data);
+
+    cv::flip(ogl_ids, instance_ids_, 0);
+
+    /* Count the pixels of each instance in each tile. The read area starts from the upper-left-most tile. */
+    instance_pixel_counts_.assign(tiles_num_, std::vector<size_t>(1, 0));
+
+    for (int i = 0; i < instance_ids_.rows; ++i)
+    {
+        const GLushort* row = instance_ids_.ptr<GLushort>(i);
+        const int tile_row = i / tile_img_height_;
+
+        for (int j = 0; j < instance_ids_.cols; ++j)
+        {
+            std::vector<size_t>& counts = instance_pixel_counts_[tile_row * tiles_cols_ + j / tile_img_width_];
+
+            if (row[j] >= counts.size())
+                counts.resize(row[j] + 1, 0);
+
+            ++counts[row[j]];
+        }
+    }
+}
+
+
+void SICAD::readCorrespondences
+(
+    const GLint x,
+    const GLint y,
+    const GLsizei width,
+    const GLsizei height
+)
+{
+    std::vector<GLuint> ogl_correspondences(width * height * 4);
+    glReadBuffer(GL_COLOR_ATTACHMENT2);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glReadPixels(x, y, width, height, GL_RGBA_INTEGER, GL_UNSIGNED_INT, ogl_correspondences.data());
+
+    /* Keep the foreground pixels only, i.e. the ones with a triangle, in image order. The read area starts from the upper-left-most tile. */
+    correspondences_.clear();
+
+    for (GLsizei i = 0; i < height; ++i)
+    {
+        /* OpenGL rows are stored bottom-up. */
+        const GLuint* row = ogl_correspondences.data() + (height - 1 - i) * width * 4;
+
+        for (GLsizei j = 0; j < width; ++j)
+        {
+            const GLuint* pixel = row + j * 4;
+            if (pixel[0] == 0)
+                continue;
+
+            Correspondence correspondence;
+            correspondence.tile = (i / tile_img_height_) * tiles_cols_ + j / tile_img_width_;
+            correspondence.u = j % tile_img_width_;
+            correspondence.v = i % tile_img_height_;
+            correspondence.instance_id = instance_id_ ? instance_ids_.at<GLushort>(i, j) : 0;
+            correspondence.triangle = pixel[0] - 1;
+            std::memcpy(&correspondence.point[0], pixel + 1, 3 * sizeof(GLfloat));
+
+            correspondences_.push_back(correspondence);
+        }
+    }
+}
+
+
+void SICAD::linearizeDepth(cv::Mat& depth) const
+{
+    /* Invert the perspective division of the projection matrix, mapping window depth in [0, 1] to the distance from the camera plane.
+       The far plane, i.e. the cleared depth, is mapped to 0. */
+    const double z_near = near_;
+    const double z_far  = far_;
+
+    for (int i = 0; i < depth.rows; ++i)
+    {
+        float* row = depth.ptr<float>(i);
+
+        for (int j = 0; j < depth.cols; ++j)
+        {
+            if (row[j] >= 1.0f)
+                row[j] = 0.0f;
+            else
+                row[j] = static_cast<float>(2.0 * z_near * z_far / (z_far + z_near - (2.0 * row[j] - 1.0) * (z_far - z_near)));
+        }
+    }
+}
+
+
+void SICAD::renderBackground(const cv::Mat& img) const
+{
+    /* Load and generate the texture. */
+    glBindTexture(GL_TEXTURE_2D, texture_background_);
+
+    /* Set the texture wrapping/filtering options (on the currently bound texture object). */
+    if (getMipmapsOpt() == MIPMaps::nearest)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    else if (getMipmapsOpt() == MIPMaps::linear)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, img.cols, img.rows, 0, GL_BGR, GL_UNSIGNED_BYTE, img.data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    /* The background has no instance ID nor correspondences. */
+    maskAuxiliaryOutputs(true);
+
+    /* Install/Use the program specified by the shader. */
+    shader_background_->install();
+    glUniformMatrix4fv(glGetUniformLocation(shader_background_->get_program(), "projection"), 1, GL_FALSE, glm::value_ptr(back_proj_));
+
+    glBindVertexArray(vao_background_);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    shader_background_->uninstall();
+
+    maskAuxiliaryOutputs(false);
+}
+
+
+bool SICAD::updateStaticScene(const glm::mat4& view)
+{
+    /* The cached layer holds colors and depths only, and would hide the background. */
+    static_scene_in_use_ = !static_objpos_map_.empty() && !getBackgroundOpt() && !useInstanceIds() && !correspondence_ && !point_cloud_;
+    if (!static_scene_in_use_)
+        return false;
+
+    if (static_scene_valid_ && static_view_ == view && static_projection_ == projection_ && static_render_mode_ == render_mode_ &&
+        static_mesh_mode_ == show_mesh_mode_ && static_width_ == tile_img_width_ && static_height_ == tile_img_height_)
+        return true;
+
+    if (static_fbo_ == 0)
+        glGenFramebuffers(1, &static_fbo_);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_fbo_);
+
+    /* The layer is as large as a tile and has the same formats of the framebuffer, as required to blit it. */
+    if (static_width_ != tile_img_width_ || static_height_ != tile_img_height_)
+    {
+        glDeleteTextures(1, &texture_static_color_);
+        glDeleteTextures(1, &texture_static_depth_);
+
+        glGenTextures(1, &texture_static_color_);
+        glBindTexture(GL_TEXTURE_2D, texture_static_color_);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, tile_img_width_, tile_img_height_, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_static_color_, 0);
+
+        glGenTextures(1, &texture_static_depth_);
+        glBindTexture(GL_TEXTURE_2D, texture_static_depth_);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, tile_img_width_, tile_img_height_, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture_static_depth_, 0);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        static_width_ = tile_img_width_;
+        static_height_ = tile_img_height_;
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "ERROR::SICAD::UPDATESTATICSCENE\nERROR:\n\tStatic scene framebuffer could not be created." << std::endl;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+        static_scene_in_use_ = false;
+
+        return false;
+    }
+
+    glViewport(0, 0, tile_img_width_, tile_img_height_);
+    glScissor (0, 0, tile_img_width_, tile_img_height_);
+
+    clearBuffers();
+    setWireframe(getWireframeOpt());
+    drawStaticModels(view);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+    static_view_ = view;
+    static_projection_ = projection_;
+    static_render_mode_ = render_mode_;
+    static_mesh_mode_ = show_mesh_mode_;
+    static_scene_valid_ = true;
+
+    return true;
+}
+
+
+void SICAD::invalidateStaticScene()
+{
+    static_scene_valid_ = false;
+
+    for (std::pair<const GLfloat, ScaleLayers>& layers : scale_layers_)
+        layers.second.static_scene_valid = false;
+}
+
+
+void SICAD::drawStaticScene(const glm::mat4& view, const size_t tile)
+{
+    if (!static_scene_in_use_)
+    {
+        drawStaticModels(view);
+        return;
+    }
+
+    /* Copy the cached layer in the tile. Blitting is subject to the scissor test, hence to ROIs. */
+    const GLint x = tile_img_width_ * (tile % tiles_cols_);
+    const GLint y = framebuffer_height_ - tile_img_height_ * (tile / tiles_cols_ + 1);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, static_fbo_);
+    glBlitFramebuffer(0, 0, tile_img_width_,     tile_img_height_,
+                      x, y, x + tile_img_width_, y + tile_img_height_,
+                      (render_mode_ == RenderMode::color ? GL_COLOR_BUFFER_BIT : 0) | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_);
+}
+
+
+void SICAD::drawStaticModels(const glm::mat4& view)
+{
+    /* Static mesh models have no instance ID. */
+    for (const ModelPoseContainer::value_type& pair : static_objpos_map_)
+    {
+        auto iter_model = model_obj_.find(pair.first);
+        if (iter_model == model_obj_.end())
+            continue;
+
+        const glm::mat4 model = getModelTransformationMatrix(pair.second.data());
+        if (!isInsideFrustum(*(iter_model->second), view * model))
+            continue;
+
+        drawModel(*(iter_model->second), model, view, 0);
+    }
+}
+
+
+bool SICAD::renderModels(const ModelPoseContainer& objpos_map, const glm::mat4& view)
+{
+    bool rendered = false;
+
+    /* Instance IDs are the 1-based positions of the poses in the container, 0 being the background. */
+    GLuint object_id = 0;
+
+    /* Iterate over the container value type to avoid copying tags and poses. */
+    for (const ModelPoseContainer::value_type& pair : objpos_map)
+    {
+        ++object_id;
+
+        /* Model transformation matrix. */
+        glm::mat4 model = getModelTransformationMatrix(pair.second.data());
+
+        auto iter_model = model_obj_.find(pair.first);
+        if (iter_model != model_obj_.end())
+        {
+            /* Skip the models lying outside the view frustum. */
+            if (!isInsideFrustum(*(iter_model->second), view * model))
+                continue;
+
+            rendered = true;
+
+            drawModel(*(iter_model->second), model, view, object_id);
+        }
+        else if (pair.first == "frame")
+        {
+            /* Reference frames have no instance ID nor correspondences. */
+            maskAuxiliaryOutputs(true);
+
+            shader_frame_->install();
+            glUniformMatrix4fv(glGetUniformLocation(shader_frame_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model));
+            glBindVertexArray(vao_frame_);
+            glDrawArrays(GL_LINES, 0, 6);
+            glBindVertexArray(0);
+            shader_frame_->uninstall();
+
+            maskAuxiliaryOutputs(false);
+
+            rendered = true;
+        }
+    }
+
+    return rendered;
+}
+
+
+void SICAD::drawModel(Model& model_obj, const glm::mat4& model, const glm::mat4& view, const GLuint object_id)
+{
+    const size_t lod = selectLevelOfDetail(model_obj, view * model);
+
+    /* Map the vertices stored on the GPU, possibly quantized, to model coordinates. */
+    const glm::mat4 model_vertex = model * model_obj.getVertexTransform();
+
+    if (useMeshShaders())
+    {
+        Shader& shader = model_obj.has_texture() ? *mesh_texture_shader_ : *mesh_shader_;
+
+        /* Points are written in the root frame or in the camera frame, i.e. the OpenGL camera frame rotated by ogl_to_cam. */
+        glm::mat4 point_transform(1.0f);
+        if (point_cloud_frame_ == PointCloudFrame::camera)
+            point_transform = glm::mat4(ogl_to_cam_) * view;
+
+        shader.install();
+        glUniformMatrix4fv(glGetUniformLocation(shader.get_program(), "projection"), 1, GL_FALSE, glm::value_ptr(projection_));
+        glUniformMatrix4fv(glGetUniformLocation(shader.get_program(), "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(shader.get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model_vertex));
+        glUniformMatrix4fv(glGetUniformLocation(shader.get_program(), "vertex_transform"), 1, GL_FALSE, glm::value_ptr(model_obj.getVertexTransform()));
+        glUniform1ui(glGetUniformLocation(shader.get_program(), "object_id"), object_id);
+        glUniformMatrix4fv(glGetUniformLocation(shader.get_program(), "point_transform"), 1, GL_FALSE, glm::value_ptr(point_transform));
+
+        model_obj.Draw(shader, lod);
+
+        shader.uninstall();
+    }
+    else if (model_obj.has_texture())
+    {
+        shader_mesh_texture_->install();
+        glUniformMatrix4fv(glGetUniformLocation(shader_mesh_texture_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model_vertex));
+
+        model_obj.Draw(*shader_mesh_texture_, lod);
+
+        shader_mesh_texture_->uninstall();
+    }
+    else
+    {
+        shader_cad_->install();
+        glUniformMatrix4fv(glGetUniformLocation(shader_cad_->get_program(), "model"), 1, GL_FALSE, glm::value_ptr(model_vertex));
+
+        model_obj.Draw(*shader_cad_, lod);
+
+        shader_cad_->uninstall();
+    }
+}
+
+
+void SICAD::projectBoundingBox(const Model& model, const glm::mat4& model_view, ObjectStatistics& statistics) const
+{
+    const glm::vec3& aabb_min = model.getBoundingBoxMin();
+    const glm::vec3& aabb_max = model.getBoundingBoxMax();
+
+    GLfloat u_min = static_cast<GLfloat>(tile_img_width_);
+    GLfloat v_min = static_cast<GLfloat>(tile_img_height_);
+    GLfloat u_max = 0.0f;
+    GLfloat v_max = 0.0f;
+    bool behind_near_plane = false;
+
+    statistics.min_depth = far_;
+    statistics.max_depth = near_;
+
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        glm::vec4 point = model_view * glm::vec4(corner & 1 ? aabb_max.x : aabb_min.x,
+                                                 corner & 2 ? aabb_max.y : aabb_min.y,
+                                                 corner & 4 ? aabb_max.z : aabb_min.z,
+                                                 1.0f);
+
+        /* Depth is the distance from the camera plane, i.e. along the negative z axis of the OpenGL camera. */
+        const GLfloat depth = -point.z;
+        statistics.min_depth = std::min(statistics.min_depth, std::max(depth, near_));
+        statistics.max_depth = std::max(statistics.max_depth, std::min(depth, far_));
+
+        if (depth < near_)
+        {
+            behind_near_plane = true;
+            continue;
+        }
+
+        /* Tile pixel coordinates from the upper-left corner. */
+        glm::vec4 clip = projection_ * point;
+        const GLfloat u = (clip.x / clip.w + 1.0f) / 2.0f * tile_img_width_;
+        const GLfloat v = (1.0f - clip.y / clip.w) / 2.0f * tile_img_height_;
+
+        u_min = std::min(u_min, u);
+        u_max = std::max(u_max, u);
+        v_min = std::min(v_min, v);
+        v_max = std::max(v_max, v);
+    }
+
+    /* Corners behind the camera do not project, hence the whole tile bounds the model. */
+    if (behind_near_plane)
+    {
+        u_min = 0.0f;
+        v_min = 0.0f;
+        u_max = static_cast<GLfloat>(tile_img_width_);
+        v_max = static_cast<GLfloat>(tile_img_height_);
+    }
+
+    const int left   = std::max(static_cast<int>(std::floor(u_min)), 0);
+    const int top    = std::max(static_cast<int>(std::floor(v_min)), 0);
+    const int right  = std::min(static_cast<int>(std::ceil(u_max)), static_cast<int>(tile_img_width_));
+    const int bottom = std::min(static_cast<int>(std::ceil(v_max)), static_cast<int>(tile_img_height_));
+
+    statistics.bounding_box = cv::Rect(left, top, std::max(right - left, 0), std::max(bottom - top, 0));
+}
+
+
+void SICAD::queueStatistics(const ModelPoseContainer& objpos_map, const glm::mat4& view, const size_t tile, const size_t index, const bool use_roi)
+{
+    object_statistics_[index].assign(objpos_map.size(), ObjectStatistics());
+
+    /* Pixels outside the ROI are neither cleared nor drawn, hence they are not reduced. */
+    StatisticsTile statistics_tile;
+    statistics_tile.tile = tile;
+    statistics_tile.index = index;
+    statistics_tile.region = use_roi ? rois_[index] : cv::Rect(0, 0, tile_img_width_, tile_img_height_);
+    statistics_tile.objects = objpos_map.size();
+    statistics_tile.offset = 0;
+
+    /* Visible pixels are counted by occlusion queries, drawing each mesh model again where its depth equals the one of the tile.
+       The viewport and the scissor box of the tile, or of its ROI, are still set. */
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glDepthFunc(GL_EQUAL);
+
+    size_t object = 0;
+    for (const ModelPoseContainer::value_type& pair : objpos_map)
+    {
+        ++object;
+
+        auto iter_model = model_obj_.find(pair.first);
+        if (iter_model == model_obj_.end())
+            continue;
+
+        const glm::mat4 model = getModelTransformationMatrix(pair.second.data());
+        if (!isInsideFrustum(*(iter_model->second), view * model))
+            continue;
+
+        /* Queries are reused across calls and only grow. */
+        if (queries_used_ == queries_.size())
+        {
+            GLuint query;
+            glGenQueries(1, &query);
+            queries_.push_back(query);
+        }
+        const GLuint query = queries_[queries_used_++];
+
+        glBeginQuery(GL_SAMPLES_PASSED, query);
+        drawModel(*(iter_model->second), model, view, static_cast<GLuint>(object));
+        glEndQuery(GL_SAMPLES_PASSED);
+
+        statistics_tile.queries.emplace_back(object - 1, query);
+    }
+
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    if (color_writes_)
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    statistics_tiles_.push_back(statistics_tile);
+}
+
+
+bool SICAD::setUpStatistics(const size_t entries)
+{
+    /* Compile the statistics shader on first use. */
+    if (!statistics_shader_)
+    {
+        try
+        {
+            statistics_shader_ = std::unique_ptr<Shader>(new Shader("__prc/shader/shader_statistics.vert", "__prc/shader/shader_statistics.frag"));
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << "ERROR::SICAD::SETUPSTATISTICS\nERROR:\n\tFailed to create the statistics shader program.\n" << e.what() << std::endl;
+
+            return false;
+        }
+
+        /* The shader draws a point for each pixel from the vertex IDs, with no vertex attribute. */
+        glGenVertexArrays(1, &vao_statistics_);
+
+        /* The depth attachment is sampled with no mipmaps. */
+        glBindTexture(GL_TEXTURE_2D, texture_depth_buffer_);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    /* The textures store the statistics of statistics_width_ mesh models per row, and only grow. */
+    const GLsizei height = static_cast<GLsizei>((entries + statistics_width_ - 1) / statistics_width_);
+    if (height <= statistics_height_)
+        return true;
+
+    if (height > renderbuffer_size_)
+    {
+        std::cerr << "ERROR::SICAD::SETUPSTATISTICS\nERROR:\n\tThe statistics of the render grid exceed the maximum texture size." << std::endl;
+        return false;
+    }
+
+    if (statistics_fbo_ == 0)
+    {
+        glGenFramebuffers(1, &statistics_fbo_);
+        glGenTextures(2, texture_statistics_);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, statistics_fbo_);
+
+    for (GLuint i = 0; i < 2; ++i)
+    {
+        glBindTexture(GL_TEXTURE_2D, texture_statistics_[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, statistics_width_, height, 0, GL_RGBA, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, texture_statistics_[i], 0);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    const GLenum draw_buffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, draw_buffers);
+
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+    if (!complete)
+    {
+        std::cerr << "ERROR::SICAD::SETUPSTATISTICS\nERROR:\n\tStatistics framebuffer could not be created." << std::endl;
+
+        statistics_height_ = 0;
+
+        return false;
+    }
+
+    statistics_height_ = height;
+
+    return true;
+}
+
+
+void SICAD::reduceStatistics()
+{
+    if (statistics_tiles_reduced_ == statistics_tiles_.size())
+        return;
+
+    size_t entries = 0;
+    for (size_t i = statistics_tiles_reduced_; i < statistics_tiles_.size(); ++i)
+        entries += statistics_tiles_[i].objects;
+
+    /* Statistics already reduced are read back, rather than lost, if the textures must grow. */
+    if (statistics_entries_ > 0 && statistics_entries_ + entries > static_cast<size_t>(statistics_width_) * statistics_height_)
+        collectStatistics();
+
+    /* Tiles that cannot be reduced report all statistics set to 0. */
+    if (!setUpStatistics(statistics_entries_ + entries))
+    {
+        statistics_tiles_.resize(statistics_tiles_reduced_);
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, statistics_fbo_);
+
+    glViewport(0, 0, statistics_width_, statistics_height_);
+    glScissor (0, 0, statistics_width_, statistics_height_);
+
+    /* Minima are reduced starting from the largest value. */
+    if (statistics_entries_ == 0)
+    {
+        const GLfloat largest = std::numeric_limits<GLfloat>::max();
+        const GLfloat initial_statistics[] = { largest, largest, largest, largest };
+        glClearBufferfv(GL_COLOR, 0, initial_statistics);
+        glClearBufferfv(GL_COLOR, 1, initial_statistics);
+    }
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_MIN);
+    glBlendFunc(GL_ONE, GL_ONE);
+
+    const GLuint program = statistics_shader_->get_program();
+    statistics_shader_->install();
+    glUniform1i(glGetUniformLocation(program, "instance_ids"), 0);
+    glUniform1i(glGetUniformLocation(program, "depth"), 1);
+    glUniform2i(glGetUniformLocation(program, "statistics_size"), statistics_width_, statistics_height_);
+    glUniform1f(glGetUniformLocation(program, "z_near"), near_);
+    glUniform1f(glGetUniformLocation(program, "z_far"), far_);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture_instance_id_);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, texture_depth_buffer_);
+
+    /* A single draw call per tile, each point reading the instance ID and the depth of a pixel. */
+    glBindVertexArray(vao_statistics_);
+    for (size_t i = statistics_tiles_reduced_; i < statistics_tiles_.size(); ++i)
+    {
+        StatisticsTile& statistics_tile = statistics_tiles_[i];
+        statistics_tile.offset = statistics_entries_;
+        statistics_entries_ += statistics_tile.objects;
+
+        if (statistics_tile.region.area() == 0 || statistics_tile.objects == 0)
+            continue;
+
+        /* Texel of the upper-left pixel of the tile, whose rows are stored bottom-up. */
+        glUniform2i(glGetUniformLocation(program, "tile_origin"), tile_img_width_ * (statistics_tile.tile % tiles_cols_),
+                                                                  framebuffer_height_ - 1 - tile_img_height_ * (statistics_tile.tile / tiles_cols_));
+        glUniform4i(glGetUniformLocation(program, "region"), statistics_tile.region.x, statistics_tile.region.y, statistics_tile.region.width, statistics_tile.region.height);
+        glUniform1ui(glGetUniformLocation(program, "objects"), static_cast<GLuint>(statistics_tile.objects));
+        glUniform1i(glGetUniformLocation(program, "offset"), static_cast<GLint>(statistics_tile.offset));
+
+        glDrawArrays(GL_POINTS, 0, statistics_tile.region.area());
+    }
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    statistics_shader_->uninstall();
+
+    glBlendEquation(GL_FUNC_ADD);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+
+    statistics_tiles_reduced_ = statistics_tiles_.size();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+}
+
+
+void SICAD::collectStatistics()
+{
+    if (statistics_entries_ > 0)
+    {
+        /* Only the rows in use are read. */
+        const GLsizei rows = static_cast<GLsizei>((statistics_entries_ + statistics_width_ - 1) / statistics_width_);
+        std::vector<GLfloat> bounds(4 * static_cast<size_t>(statistics_width_) * rows);
+        std::vector<GLfloat> depths(bounds.size());
+
+        glBindFramebuffer(GL_FRAMEBUFFER, statistics_fbo_);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glReadPixels(0, 0, statistics_width_, rows, GL_RGBA, GL_FLOAT, bounds.data());
+        glReadBuffer(GL_COLOR_ATTACHMENT1);
+        glReadPixels(0, 0, statistics_width_, rows, GL_RGBA, GL_FLOAT, depths.data());
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+        for (size_t i = 0; i < statistics_tiles_reduced_; ++i)
+        {
+            const StatisticsTile& statistics_tile = statistics_tiles_[i];
+            std::vector<ObjectStatistics>& tile_statistics = object_statistics_[statistics_tile.index];
+
+            /* Models outside the view frustum have no query. */
+            for (const std::pair<size_t, GLuint>& object_query : statistics_tile.queries)
+            {
+                const size_t object = object_query.first;
+
+                GLuint samples = 0;
+                glGetQueryObjectuiv(object_query.second, GL_QUERY_RESULT, &samples);
+
+                /* Models that are not visible keep all statistics set to 0. */
+                if (samples == 0)
+                    continue;
+
+                const GLfloat* object_bounds = bounds.data() + 4 * (statistics_tile.offset + object);
+                const GLfloat* object_depths = depths.data() + 4 * (statistics_tile.offset + object);
+
+                /* Bounds are not reduced if the instance ID of the model was overwritten at equal depth, e.g. by a later model. */
+                if (object_bounds[0] == std::numeric_limits<GLfloat>::max())
+                    continue;
+
+                const int left   = static_cast<int>(object_bounds[0]);
+                const int top    = static_cast<int>(object_bounds[1]);
+                const int right  = static_cast<int>(-object_bounds[2]);
+                const int bottom = static_cast<int>(-object_bounds[3]);
+
+                ObjectStatistics& statistics = tile_statistics[object];
+                statistics.visible_pixels = samples;
+                statistics.bounding_box = cv::Rect(left, top, right - left + 1, bottom - top + 1);
+                statistics.min_depth = object_depths[0];
+                statistics.max_depth = -object_depths[1];
+            }
+        }
+    }
+
+    statistics_tiles_.erase(statistics_tiles_.begin(), statistics_tiles_.begin() + statistics_tiles_reduced_);
+    statistics_tiles_reduced_ = 0;
+    statistics_entries_ = 0;
+
+    /* Queries are in use until the tiles still to be reduced are collected. */
+    if (statistics_tiles_.empty())
+        queries_used_ = 0;
+}
+
+
+void SICAD::readStatistics()
+{
+    /* Tiles rendered since the last pass are reduced, then the statistics of the whole call are read back at once. */
+    reduceStatistics();
+
+    collectStatistics();
+}
+
+
+bool SICAD::isInsideFrustum(const Model& model, const glm::mat4& model_view) const
+{
+    /* Clip planes in model coordinates are sums and differences of the rows of the model-view-projection matrix. */
+    glm::mat4 clip = projection_ * model_view;
+
+    const glm::vec3& aabb_min = model.getBoundingBoxMin();
+    const glm::vec3& aabb_max = model.getBoundingBoxMax();
+
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int sign = -1; sign <= 1; sign += 2)
+        {
+            glm::vec4 plane;
+            for (int col = 0; col < 4; ++col)
+                plane[col] = clip[col][3] + sign * clip[col][row];
+
+            /* The bounding box is outside when its corner farthest along the plane normal is behind the plane. */
+            glm::vec3 corner(plane.x >= 0.0f ? aabb_max.x : aabb_min.x,
+                             plane.y >= 0.0f ? aabb_max.y : aabb_min.y,
+                             plane.z >= 0.0f ? aabb_max.z : aabb_min.z);
+
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+size_t SICAD::selectLevelOfDetail(const Model& model, const glm::mat4& model_view) const
+{
+    if (model.getLevelsOfDetail() < 2)
+        return 0;
+
+    glm::vec4 center = model_view * glm::vec4(model.getBoundingSphereCenter(), 1.0f);
+    GLfloat distance = -center.z;
+    GLfloat radius = model.getBoundingSphereRadius();
+
+    /* Use the original model when the camera is inside the bounding sphere. */
+    if (distance <= radius || radius <= 0.0f)
+        return 0;
+
+    /* Radius of the bounding sphere projected on the tile, in pixels. */
+    GLfloat projected_radius = radius * projection_[1][1] * tile_img_height_ / 2.0f / distance;
+
+    return model.selectLevelOfDetail(lod_error_threshold_ * radius / projected_radius);
+}
+
+
+bool SICAD::importModel(const std::string& mesh_id, const std::string& path, const Model::MemoryFileContainer& files, const size_t request)
+{
+    std::cout << log_ID_ << "Loading " + mesh_id + " model for OpenGL rendering from " << path << "." << std::endl;
+
+    Model* model = new (std::nothrow) Model(path.c_str(), files, import_profile_);
+
+    if (model == nullptr || !model->is_loaded())
+    {
+        std::cerr << "ERROR::SICAD::UPDATEMODEL\nERROR:\n\t" + mesh_id + " model file from " + path + " not found!" << std::endl;
+        delete model;
+        return false;
+    }
+
+    Mesh::VertexLayout layout;
+    {
+        std::lock_guard<std::mutex> lock(model_mutex_);
+
+        if (model_requests_[mesh_id] != request)
+        {
+            std::cout << log_ID_ << "Discarding " + mesh_id + " model loaded from " << path << ". A later update has been requested." << std::endl;
+            delete model;
+            return false;
+        }
+
+        layout = vertex_layouts_[model->has_texture() ? 1 : 0];
+    }
+
+    /* Upload textures and buffers on the upload context, whose objects are shared with the rendering context.
+       The fence is flushed, so that it is eventually signaled, as contexts are not flushed when released. */
+    GLsync fence;
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex_);
+
+        glfwMakeContextCurrent(upload_window_);
+
+        model->setVertexLayout(layout);
+        model->uploadBuffers();
+
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    std::lock_guard<std::mutex> lock(model_mutex_);
+
+    if (model_requests_[mesh_id] != request)
+    {
+        std::cout << log_ID_ << "Discarding " + mesh_id + " model loaded from " << path << ". A later update has been requested." << std::endl;
+        discarded_models_.push_back(std::make_pair(model, fence));
+        return false;
+    }
+
+    auto iter_pending = pending_models_.find(mesh_id);
+    if (iter_pending != pending_models_.end() && iter_pending->second != nullptr)
+        discarded_models_.push_back(std::make_pair(iter_pending->second, pending_fences_[mesh_id]));
+
+    pending_models_[mesh_id] = model;
+    pending_fences_[mesh_id] = fence;
+
+    return true;
+}
+
+
+void SICAD::swapModels()
+{
+    ModelContainer updates;
+    std::unordered_map<std::string, GLsync> fences;
+    std::vector<std::pair<Model*, GLsync>> discarded;
+    {
+        std::lock_guard<std::mutex> lock(model_mutex_);
+
+        if (pending_models_.empty() && discarded_models_.empty())
+            return;
+
+        updates.swap(pending_models_);
+        fences.swap(pending_fences_);
+        discarded.swap(discarded_models_);
+    }
+
+    /* Objects of the upload context are shared, hence they are deleted on the rendering context. */
+    for (const std::pair<Model*, GLsync>& model : discarded)
+    {
+        glDeleteSync(model.second);
+        (model.first)->release();
+        delete model.first;
+    }
+
+    if (updates.empty())
+        return;
+
+    /* The GPU, not the CPU, waits for the uploads to complete before drawing the models. Only the vertex arrays, that are not shared
+       among contexts, are created here, along with the vertex buffers of the models whose layout changed since they were uploaded. */
+    for (const ModelElement& pair : updates)
+    {
+        if (pair.second != nullptr)
+        {
+            glWaitSync(fences[pair.first], 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fences[pair.first]);
+
+            updateVertexLayout(*(pair.second));
+            (pair.second)->upload();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(model_mutex_);
+
+    for (const ModelElement& pair : updates)
+    {
+        auto iter_model = model_obj_.find(pair.first);
+        if (iter_model != model_obj_.end())
+        {
+            std::cout << log_ID_ << "Deleting OpenGL " + pair.first + " model." << std::endl;
+
+            (iter_model->second)->release();
+            delete iter_model->second;
+            model_obj_.erase(iter_model);
+        }
+
+        if (pair.second != nullptr)
+        {
+            std::cout << log_ID_ << "Swapping in " + pair.first + " model." << std::endl;
+
+            model_obj_[pair.first] = pair.second;
+        }
+    }
+
+    /* Updated models may be part of the static scene, and of the cached tiles. */
+    invalidateStaticScene();
+    clearRenderCache();
+}
+
+
+void SICAD::updateVertexLayouts()
+{
+    {
+        std::lock_guard<std::mutex> lock(model_mutex_);
+
+        vertex_layouts_[0] = selectVertexLayout(false);
+        vertex_layouts_[1] = selectVertexLayout(true);
+    }
+
+    for (const ModelElement& pair : model_obj_)
+        updateVertexLayout(*(pair.second));
+}
+
+
+void SICAD::updateVertexLayout(Model& model)
+{
+    const Mesh::VertexLayout layout = selectVertexLayout(model.has_texture());
+
+    if (model.getVertexLayout() != layout)
+        model.setVertexLayout(layout);
+}
+
+
+Mesh::VertexLayout SICAD::selectVertexLayout(const bool textured) const
+{
+    /* Textured models are drawn with the full vertex layout, as texture coordinates are needed.
+       Untextured models are drawn by the mesh model shader: when it reads the vertex position only,
+       normals and texture coordinates are not uploaded to the GPU, and positions may be quantized.
+       In depth mode all the models are drawn by the depth-only shader, which reads the vertex position only. */
+    const bool position_only = render_mode_ == RenderMode::depth ||
+                               (!textured && !shader_cad_->is_attribute_active(1) && !shader_cad_->is_attribute_active(2));
+
+    if (!position_only)
+        return Mesh::VertexLayout::full;
+
+    return vertex_quantization_ ? Mesh::VertexLayout::quantized_position : Mesh::VertexLayout::position;
+}
+
+
+void SICAD::setWireframe(GLenum mode)
+{
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+}
+
+
+void SICAD::setUpTiles
+(
+    const GLint num_images,
+    const GLsizei cam_width,
+    const GLsizei cam_height
+)
+{
+    /* Given image size */
+    image_width_ = cam_width;
+    image_height_ = cam_height;
+    std::cout << log_ID_ << "Given image size " + std::to_string(image_width_) + "x" + std::to_string(image_height_) + "." << std::endl;
+
+
+    /* Compute the maximum number of images that can be rendered conditioned on the maximum renderbuffer size */
+    requested_images_ = num_images;
+    std::cout << log_ID_ << "Required to render " + std::to_string(num_images) + " image(s)." << std::endl;
+
+    GLsizei tiles_cols = 0;
+    GLsizei tiles_rows = 0;
+    factorize_int(num_images, std::floor(renderbuffer_size_ / image_width_), std::floor(renderbuffer_size_ / image_height_), tiles_cols, tiles_rows);
+
+    setUpGrid(tiles_cols, tiles_rows);
+}
+
+
+void SICAD::setUpGrid
+(
+    const GLsizei tiles_cols,
+    const GLsizei tiles_rows
+)
+{
+    tiles_cols_ = tiles_cols;
+    tiles_rows_ = tiles_rows;
+    tiles_num_ = tiles_rows_ * tiles_cols_;
+    std::cout << log_ID_ << "Allowed number or rendered images is " + std::to_string(tiles_num_) + " (" + std::to_string(tiles_rows_) + "x" + std::to_string(tiles_cols_) + " grid)." << std::endl;
+
+    setUpFramebufferSize();
+    std::cout << log_ID_ << "The rendered image size is " + std::to_string(tile_img_width_) + "x" + std::to_string(tile_img_height_) + "." << std::endl;
+}
+
+
+void SICAD::setUpFramebufferSize()
+{
+    /* Set framebuffer size. Tiles shrink with the resolution scale. */
+    framebuffer_width_ = std::max(static_cast<GLsizei>(std::lround(image_width_ * resolution_scale_)), 1) * tiles_cols_;
+    framebuffer_height_ = std::max(static_cast<GLsizei>(std::lround(image_height_ * resolution_scale_)), 1) * tiles_rows_;
+
+    /* Set rendered image size. May vary in HDPI monitors. */
+    tile_img_width_ = framebuffer_width_ / tiles_cols_;
+    tile_img_height_ = framebuffer_height_ / tiles_rows_;
+}
+
+
+bool SICAD::switchResolutionScale(const GLfloat scale)
+{
+    if (scale == resolution_scale_)
+        return true;
+
+    /* Keep the layers of the current scale, and restore the ones of the new scale, if any. */
+    swapScaleLayers(scale_layers_[resolution_scale_]);
+
+    auto iter_layers = scale_layers_.find(scale);
+    if (iter_layers != scale_layers_.end())
+    {
+        swapScaleLayers(iter_layers->second);
+        scale_layers_.erase(iter_layers);
+    }
+
+    const GLfloat previous_scale = resolution_scale_;
+    resolution_scale_ = scale;
+
+    setUpFramebufferSize();
+
+    /* Attachments and PBOs grow only if the grid has been laid out at a smaller scale. */
+    if (!resizeAttachments())
+    {
+        switchResolutionScale(previous_scale);
+
+        return false;
+    }
+
+    allocatePBOs();
+
+    return true;
+}
+
+
+void SICAD::swapScaleLayers(ScaleLayers& layers)
+{
+    std::swap(static_fbo_, layers.static_fbo);
+    std::swap(texture_static_color_, layers.texture_static_color);
+    std::swap(texture_static_depth_, layers.texture_static_depth);
+    std::swap(static_width_, layers.static_width);
+    std::swap(static_height_, layers.static_height);
+    std::swap(static_scene_valid_, layers.static_scene_valid);
+    std::swap(static_view_, layers.static_view);
+    std::swap(static_projection_, layers.static_projection);
+    std::swap(static_render_mode_, layers.static_render_mode);
+    std::swap(static_mesh_mode_, layers.static_mesh_mode);
+
+    std::swap(render_cache_keys_, layers.render_cache_keys);
+    std::swap(render_cache_empty_tiles_, layers.render_cache_empty_tiles);
+    std::swap(render_cache_fbo_, layers.render_cache_fbo);
+    std::swap(texture_render_cache_color_, layers.texture_render_cache_color);
+    std::swap(texture_render_cache_depth_, layers.texture_render_cache_depth);
+    std::swap(render_cache_size_, layers.render_cache_size);
+    std::swap(render_cache_generation_, layers.render_cache_generation);
+    std::swap(render_cache_projection_, layers.render_cache_projection);
+    std::swap(render_cache_mode_, layers.render_cache_mode);
+    std::swap(render_cache_mesh_mode_, layers.render_cache_mesh_mode);
+    std::swap(render_cache_tile_size_, layers.render_cache_tile_size);
 }
 
 
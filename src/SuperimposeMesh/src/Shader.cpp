@@ -10,15 +10,42 @@
 #include <cmrc/cmrc.hpp>
 CMRC_DECLARE(shader);
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
 
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
-Shader::Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path)
+
+std::string Shader::binary_cache_folder_;
+
+
+Shader::Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path) :
+    Shader(vertex_shader_path, fragment_shader_path, std::vector<std::string>())
+{ }
+
+
+Shader::Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const std::vector<std::string>& defines) :
+    Shader(vertex_shader_path, fragment_shader_path, std::string(), defines)
+{ }
+
+
+Shader::Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const std::string& geometry_shader_path, const std::vector<std::string>& defines)
 {
     std::string sourcecode_vertex_shader;
     std::string sourcecode_fragmentshader;
+    std::string sourcecode_geometry_shader;
 
     /* Retrieve the vertex/fragment source code from path. */
     try
@@ -62,6 +89,30 @@ Shader::Shader(const std::string& vertex_shader_path, const std::string& fragmen
             sourcecode_vertex_shader = vertex_shader_stream.str();
             sourcecode_fragmentshader = fragment_shader_stream.str();
         }
+
+        if (!geometry_shader_path.empty())
+        {
+            if (cmrc_fs.exists(geometry_shader_path) && cmrc_fs.is_file(geometry_shader_path))
+            {
+                auto geometry_shader_cmrc_file = cmrc_fs.open(geometry_shader_path);
+                sourcecode_geometry_shader.assign(geometry_shader_cmrc_file.cbegin(), geometry_shader_cmrc_file.cend());
+            }
+            else
+            {
+                std::ifstream file_geometry_shader;
+                file_geometry_shader.exceptions(std::ifstream::badbit);
+
+                file_geometry_shader.open(geometry_shader_path);
+
+                std::stringstream geometry_shader_stream;
+                geometry_shader_stream << file_geometry_shader.rdbuf();
+
+                file_geometry_shader.close();
+
+
+                sourcecode_geometry_shader = geometry_shader_stream.str();
+            }
+        }
     }
     catch (const std::ifstream::failure& e)
     {
@@ -69,6 +120,52 @@ Shader::Shader(const std::string& vertex_shader_path, const std::string& fragmen
     }
 
 
+    /* Inject the defines right after the version directive, which must be the first statement. */
+    if (!defines.empty())
+    {
+        std::string define_directives;
+        for (const std::string& define : defines)
+            define_directives += "#define " + define + "\n";
+
+        for (std::string* sourcecode : { &sourcecode_vertex_shader, &sourcecode_fragmentshader, &sourcecode_geometry_shader })
+        {
+            if (sourcecode->empty())
+                continue;
+
+            size_t version = sourcecode->find("#version");
+            size_t position = version == std::string::npos ? 0 : sourcecode->find('\n', version);
+            position = position == std::string::npos ? sourcecode->size() : position + 1;
+
+            sourcecode->insert(position, define_directives);
+        }
+    }
+
+
+    /* Look up the linked program in the binary cache. */
+    if (!binary_cache_folder_.empty() && (GLEW_ARB_get_program_binary || glewIsSupported("GL_VERSION_4_1")))
+    {
+        /* 64-bit FNV-1a hash of the source code and of the driver identification strings. */
+        std::string key_source = sourcecode_vertex_shader + '\0' + sourcecode_fragmentshader + '\0' + sourcecode_geometry_shader;
+        for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+        {
+            const GLubyte* value = glGetString(name);
+            key_source += '\0' + std::string(value != nullptr ? reinterpret_cast<const char*>(value) : "");
+        }
+
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (const char c : key_source)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+
+        binary_hash_ = hash;
+
+        if (load_binary(get_binary_cache_file()))
+            return;
+    }
+
+
     /* Compile shaders. */
     const GLchar* ptr_sourcecode_vertex_shader = sourcecode_vertex_shader.c_str();
     const GLchar* ptr_sourcecode_fragment_shader = sourcecode_fragmentshader.c_str();
@@ -106,10 +203,34 @@ Shader::Shader(const std::string& vertex_shader_path, const std::string& fragmen
     };
 
 
+    /* Geometry Shader, if any. */
+    GLuint geometry = 0;
+    if (!sourcecode_geometry_shader.empty())
+    {
+        const GLchar* ptr_sourcecode_geometry_shader = sourcecode_geometry_shader.c_str();
+
+        geometry = glCreateShader(GL_GEOMETRY_SHADER);
+        glShaderSource(geometry, 1, &ptr_sourcecode_geometry_shader, NULL);
+        glCompileShader(geometry);
+
+        /* Print compile errors if any. */
+        glGetShaderiv(geometry, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            glGetShaderInfoLog(geometry, 512, NULL, info_log);
+            throw std::runtime_error("ERROR::SHADER::CTOR\nERROR:\n\tGeometry shader program compilation error.\nLOG:\n\t" + std::string(info_log));
+        };
+    }
+
+
     /* Shader Program. */
     shader_program_id_ = glCreateProgram();
     glAttachShader(shader_program_id_, vertex);
     glAttachShader(shader_program_id_, fragment);
+    if (geometry != 0)
+        glAttachShader(shader_program_id_, geometry);
+    if (binary_hash_ != 0)
+        glProgramParameteri(shader_program_id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(shader_program_id_);
 
     /* Print linking errors if any. */
@@ -123,6 +244,45 @@ Shader::Shader(const std::string& vertex_shader_path, const std::string& fragmen
     /* Delete the shaders as they're linked into our program now and no longer necessery. */
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+    if (geometry != 0)
+        glDeleteShader(geometry);
+
+    if (binary_hash_ != 0)
+        store_binary(get_binary_cache_file());
+}
+
+
+void Shader::set_binary_cache_folder(const std::string& folder)
+{
+    binary_cache_folder_ = folder;
+
+    /* Create the folder, if it does not exist. */
+    if (!binary_cache_folder_.empty())
+    {
+#ifdef _WIN32
+        _mkdir(binary_cache_folder_.c_str());
+#else
+        mkdir(binary_cache_folder_.c_str(), 0755);
+#endif
+    }
+}
+
+
+const std::string& Shader::get_binary_cache_folder()
+{
+    return binary_cache_folder_;
+}
+
+
+std::string Shader::get_binary_cache_file() const
+{
+    if (binary_hash_ == 0)
+        return std::string();
+
+    std::ostringstream cache_file_stream;
+    cache_file_stream << binary_cache_folder_ << "/" << std::hex << std::setw(16) << std::setfill('0') << binary_hash_ << ".bin";
+
+    return cache_file_stream.str();
 }
 
 
@@ -136,3 +296,122 @@ void Shader::uninstall()
 {
     glUseProgram(0);
 }
+
+
+bool Shader::load_binary(const std::string& cache_file)
+{
+    std::ifstream file(cache_file, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    GLenum format;
+    if (!file.read(reinterpret_cast<char*>(&format), sizeof(format)))
+        return false;
+
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (binary.empty())
+        return false;
+
+    shader_program_id_ = glCreateProgram();
+    glProgramBinary(shader_program_id_, format, binary.data(), binary.size());
+
+    /* Drivers may reject binaries, e.g. after an update, hence fall back to compiling from source. */
+    GLint success;
+    glGetProgramiv(shader_program_id_, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glDeleteProgram(shader_program_id_);
+        shader_program_id_ = 0;
+
+        return false;
+    }
+
+    cached_ = true;
+
+    return true;
+}
+
+
+void Shader::store_binary(const std::string& cache_file) const
+{
+    GLint length = 0;
+    glGetProgramiv(shader_program_id_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    GLenum format;
+    std::vector<char> binary(length);
+    glGetProgramBinary(shader_program_id_, length, nullptr, &format, binary.data());
+
+    /* Write to a temporary file first, so that concurrent processes never read partially written files. */
+    std::string temporary_file = cache_file + ".tmp" + std::to_string(std::random_device()());
+    {
+        std::ofstream file(temporary_file, std::ios::binary);
+        if (!file.is_open())
+            return;
+
+        file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+        file.write(binary.data(), binary.size());
+    }
+
+    if (std::rename(temporary_file.c_str(), cache_file.c_str()) != 0)
+        std::remove(temporary_file.c_str());
+}
+
+
+ShaderVariants::ShaderVariants(const std::string& vertex_shader_path, const std::string& fragment_shader_path) :
+    ShaderVariants(vertex_shader_path, fragment_shader_path, std::string(), std::string())
+{ }
+
+
+ShaderVariants::ShaderVariants(const std::string& vertex_shader_path, const std::string& fragment_shader_path, const std::string& geometry_shader_path, const std::string& geometry_define) :
+    vertex_shader_path_(vertex_shader_path),
+    fragment_shader_path_(fragment_shader_path),
+    geometry_shader_path_(geometry_shader_path),
+    geometry_define_(geometry_define)
+{ }
+
+
+Shader& ShaderVariants::get(const std::vector<std::string>& defines)
+{
+    /* The order of the defines does not matter. */
+    std::vector<std::string> sorted_defines(defines);
+    std::sort(sorted_defines.begin(), sorted_defines.end());
+
+    auto iter_variant = variants_.find(sorted_defines);
+    if (iter_variant != variants_.end())
+        return *(iter_variant->second);
+
+    /* The geometry stage is linked only to the variants requiring it. */
+    const bool geometry = !geometry_shader_path_.empty() && std::find(sorted_defines.begin(), sorted_defines.end(), geometry_define_) != sorted_defines.end();
+
+    std::unique_ptr<Shader> variant(new Shader(vertex_shader_path_, fragment_shader_path_, geometry ? geometry_shader_path_ : std::string(), sorted_defines));
+    Shader& shader = *variant;
+
+    variants_.emplace(sorted_defines, std::move(variant));
+
+    return shader;
+}
+
+
+bool Shader::is_attribute_active(const GLint location) const
+{
+    GLint num_attributes = 0;
+    glGetProgramiv(shader_program_id_, GL_ACTIVE_ATTRIBUTES, &num_attributes);
+
+    GLint name_length = 0;
+    glGetProgramiv(shader_program_id_, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &name_length);
+
+    std::vector<GLchar> name(std::max(name_length, 1));
+    for (GLint i = 0; i < num_attributes; ++i)
+    {
+        GLint size;
+        GLenum type;
+        glGetActiveAttrib(shader_program_id_, i, name.size(), nullptr, &size, &type, name.data());
+
+        if (glGetAttribLocation(shader_program_id_, name.data()) == location)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,599 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "SuperimposeMesh/TemplateLibrary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+
+/* File layout: header, entries, orientations as (w, x, y, z) quaternions, distances, packed masks and edges.
+   Values are stored in the byte order of the machine generating the library, identified by `byte_order`. */
+struct TemplateLibrary::Header
+{
+    char magic[8];
+    std::uint32_t byte_order;
+    std::uint32_t version;
+    std::uint32_t orientations_num;
+    std::uint32_t distances_num;
+    std::uint32_t image_width;
+    std::uint32_t image_height;
+    float optical_axis[3];
+    std::uint32_t reserved;
+    std::uint64_t entries_offset;
+    std::uint64_t orientations_offset;
+    std::uint64_t distances_offset;
+};
+
+
+struct TemplateLibrary::Entry
+{
+    std::int32_t x;
+    std::int32_t y;
+    std::int32_t width;
+    std::int32_t height;
+    std::uint64_t mask_offset;
+    std::uint64_t edges_offset;
+};
+
+
+namespace
+{
+    const char template_magic[8] = { 'S', 'I', 'T', 'M', 'P', 'L', '\0', '\0' };
+
+    const std::uint32_t template_version = 2;
+
+    /* Reads as 0x04030201 on a machine with the opposite byte order. */
+    const std::uint32_t template_byte_order = 0x01020304;
+
+    std::uint64_t alignOffset(const std::uint64_t offset)
+    {
+        return (offset + 7) & ~static_cast<std::uint64_t>(7);
+    }
+}
+
+
+TemplateLibrary::TemplateLibrary(const std::string& path)
+{
+    static_assert(sizeof(Header) == 72, "Unexpected padding of the template library header.");
+    static_assert(sizeof(Entry) == 32, "Unexpected padding of the template library entries.");
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("ERROR::TEMPLATELIBRARY::CTOR\nERROR:\n\tCould not open " + path + ".");
+    file_handle_ = file;
+
+    LARGE_INTEGER file_size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    mapping_handle_ = mapping;
+
+    if (mapping != nullptr)
+    {
+        data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        data_size_ = static_cast<size_t>(file_size.QuadPart);
+    }
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        throw std::runtime_error("ERROR::TEMPLATELIBRARY::CTOR\nERROR:\n\tCould not open " + path + ".");
+
+    struct stat file_stat;
+    if (fstat(file, &file_stat) == 0 && file_stat.st_size > 0)
+    {
+        void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (data != MAP_FAILED)
+        {
+            data_ = static_cast<const unsigned char*>(data);
+            data_size_ = static_cast<size_t>(file_stat.st_size);
+        }
+    }
+
+    /* The mapping stays valid after closing the file descriptor. */
+    close(file);
+#endif
+
+    if (data_ == nullptr)
+    {
+        unmap();
+
+        throw std::runtime_error("ERROR::TEMPLATELIBRARY::CTOR\nERROR:\n\tCould not map " + path + " to memory.");
+    }
+
+    header_ = reinterpret_cast<const Header*>(data_);
+
+    if (data_size_ >= sizeof(Header) && std::memcmp(header_->magic, template_magic, sizeof(template_magic)) == 0 &&
+        header_->byte_order != template_byte_order)
+    {
+        unmap();
+
+        throw std::runtime_error("ERROR::TEMPLATELIBRARY::CTOR\nERROR:\n\t" + path + " has been generated on a machine with a different byte order.");
+    }
+
+    const bool valid_header = data_size_ >= sizeof(Header) &&
+                              std::memcmp(header_->magic, template_magic, sizeof(template_magic)) == 0 &&
+                              header_->version == template_version &&
+                              header_->orientations_num > 0 && header_->distances_num > 0;
+
+    if (!valid_header ||
+        header_->entries_offset + sizeof(Entry) * size() > data_size_ ||
+        header_->orientations_offset + 4 * sizeof(float) * getOrientationsNumber() > data_size_ ||
+        header_->distances_offset + sizeof(float) * getDistancesNumber() > data_size_)
+    {
+        unmap();
+
+        throw std::runtime_error("ERROR::TEMPLATELIBRARY::CTOR\nERROR:\n\t" + path + " is not a valid template library.");
+    }
+
+    entries_ = reinterpret_cast<const Entry*>(data_ + header_->entries_offset);
+    orientations_ = reinterpret_cast<const float*>(data_ + header_->orientations_offset);
+    distances_ = reinterpret_cast<const float*>(data_ + header_->distances_offset);
+
+    std::cout << log_ID_ << "Mapped " << size() << " templates from " << path << "." << std::endl;
+}
+
+
+TemplateLibrary::~TemplateLibrary()
+{
+    unmap();
+}
+
+
+std::vector<std::array<double, 4>> TemplateLibrary::getOrientationGrid(const size_t orientations_num)
+{
+    /* Super-Fibonacci spiral over the unit quaternions, see M. Alexa, "Super-Fibonacci Spirals: Fast, Low-Discrepancy Sampling of SO(3)", CVPR 2022. */
+    const double pi = 3.14159265358979323846;
+    const double phi = std::sqrt(2.0);
+    const double psi = 1.533751168755204288118041;
+
+    std::vector<std::array<double, 4>> orientations(orientations_num);
+    for (size_t i = 0; i < orientations_num; ++i)
+    {
+        const double s = static_cast<double>(i) + 0.5;
+        const double r = std::sqrt(s / orientations_num);
+        const double big_r = std::sqrt(1.0 - s / orientations_num);
+        const double alpha = 2.0 * pi * s / phi;
+        const double beta = 2.0 * pi * s / psi;
+
+        /* Quaternions q and -q are the same rotation, the one with positive real part is used. */
+        double q[4] = { big_r * std::cos(beta), r * std::sin(alpha), r * std::cos(alpha), big_r * std::sin(beta) };
+        if (q[0] < 0)
+            for (double& value : q)
+                value = -value;
+
+        orientations[i] = toAxisAngle(q);
+    }
+
+    return orientations;
+}
+
+
+bool TemplateLibrary::generate
+(
+    SICAD& si_cad,
+    const std::string& mesh_id,
+    const size_t orientations_num,
+    const std::vector<double>& distances,
+    const std::string& path,
+    const std::array<double, 3>& optical_axis
+)
+{
+    std::vector<double> grid_distances(distances);
+    std::sort(grid_distances.begin(), grid_distances.end());
+    grid_distances.erase(std::unique(grid_distances.begin(), grid_distances.end()), grid_distances.end());
+
+    if (orientations_num == 0 || grid_distances.empty() || grid_distances.front() <= 0)
+    {
+        std::cerr << "ERROR::TEMPLATELIBRARY::GENERATE\nERROR:\n\tThe grid requires at least one orientation and one positive distance." << std::endl;
+        return false;
+    }
+
+    const double axis_norm = std::sqrt(optical_axis[0] * optical_axis[0] + optical_axis[1] * optical_axis[1] + optical_axis[2] * optical_axis[2]);
+    if (axis_norm == 0)
+    {
+        std::cerr << "ERROR::TEMPLATELIBRARY::GENERATE\nERROR:\n\tThe optical axis must not be null." << std::endl;
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "ERROR::TEMPLATELIBRARY::GENERATE\nERROR:\n\tCould not open " << path << " for writing." << std::endl;
+        return false;
+    }
+
+    const std::vector<std::array<double, 4>> orientations = getOrientationGrid(orientations_num);
+    const size_t distances_num = grid_distances.size();
+    const size_t count = orientations_num * distances_num;
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, template_magic, sizeof(template_magic));
+    header.byte_order = template_byte_order;
+    header.version = template_version;
+    header.orientations_num = static_cast<std::uint32_t>(orientations_num);
+    header.distances_num = static_cast<std::uint32_t>(distances_num);
+    for (int i = 0; i < 3; ++i)
+        header.optical_axis[i] = static_cast<float>(optical_axis[i] / axis_norm);
+    header.entries_offset = sizeof(Header);
+    header.orientations_offset = alignOffset(header.entries_offset + sizeof(Entry) * count);
+    header.distances_offset = alignOffset(header.orientations_offset + 4 * sizeof(float) * orientations_num);
+
+    /* Orientations and distances are written now, header and entries once all the templates are known. */
+    std::vector<float> quaternions;
+    quaternions.reserve(4 * orientations_num);
+    for (const std::array<double, 4>& orientation : orientations)
+    {
+        const std::array<double, 4> q = toQuaternion(orientation.data());
+        quaternions.insert(quaternions.end(), q.begin(), q.end());
+    }
+
+    const std::vector<float> distances_f(grid_distances.begin(), grid_distances.end());
+
+    file.seekp(static_cast<std::streamoff>(header.orientations_offset));
+    file.write(reinterpret_cast<const char*>(quaternions.data()), quaternions.size() * sizeof(float));
+    file.seekp(static_cast<std::streamoff>(header.distances_offset));
+    file.write(reinterpret_cast<const char*>(distances_f.data()), distances_f.size() * sizeof(float));
+
+    std::uint64_t data_offset = alignOffset(header.distances_offset + sizeof(float) * distances_num);
+    file.seekp(static_cast<std::streamoff>(data_offset));
+
+
+    /* A partially written library is removed, so that it can not be mistaken for a valid one. */
+    const auto discard = [&file, &path]()
+    {
+        file.close();
+        std::remove(path.c_str());
+
+        return false;
+    };
+
+    /* Templates need whole images, hence ROIs, readback skipping and the render cache, which may reuse tiles rendered
+       in another render mode, are disabled while generating and restored afterwards. */
+    const SICAD::RenderMode render_mode = si_cad.getRenderModeOpt();
+    const bool roi = si_cad.getRoiOpt();
+    const bool readback = si_cad.getReadbackOpt();
+    const bool render_cache = si_cad.getRenderCacheOpt();
+    const double render_cache_resolution = si_cad.getRenderCacheResolutionOpt();
+
+    si_cad.setRoiOpt(false);
+    si_cad.setReadbackOpt(true);
+    si_cad.setRenderCacheOpt(false, render_cache_resolution);
+
+    const auto restore = [&]()
+    {
+        si_cad.setRenderModeOpt(render_mode);
+        si_cad.setRoiOpt(roi);
+        si_cad.setReadbackOpt(readback);
+        si_cad.setRenderCacheOpt(render_cache, render_cache_resolution);
+    };
+
+    /* Depth is 0 where no mesh model is drawn, so that masks do not depend on lighting nor on textures. */
+    if (!si_cad.setRenderModeOpt(SICAD::RenderMode::depth))
+    {
+        std::cerr << "ERROR::TEMPLATELIBRARY::GENERATE\nERROR:\n\tCould not render depth." << std::endl;
+
+        restore();
+
+        return discard();
+    }
+
+    const size_t batch_size = static_cast<size_t>(si_cad.getTilesNumber());
+    const size_t tiles_cols = static_cast<size_t>(si_cad.getTilesCols());
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    std::vector<Entry> entries(count);
+    std::vector<Superimpose::ModelPoseContainer> objposes;
+    std::vector<unsigned char> packed;
+    bool success = true;
+    size_t visible_templates = 0;
+
+    for (size_t first = 0; first < count && success; first += batch_size)
+    {
+        const size_t batch = std::min(batch_size, count - first);
+
+        objposes.assign(batch, Superimpose::ModelPoseContainer());
+        for (size_t k = 0; k < batch; ++k)
+        {
+            const std::array<double, 4>& orientation = orientations[(first + k) / distances_num];
+            const double distance = grid_distances[(first + k) % distances_num];
+
+            Superimpose::ModelPose pose(7);
+            for (int i = 0; i < 3; ++i)
+                pose[i] = header.optical_axis[i] * distance;
+            for (int i = 0; i < 4; ++i)
+                pose[3 + i] = orientation[i];
+
+            objposes[k].emplace(mesh_id, pose);
+        }
+
+        cv::Mat img;
+        if (!si_cad.superimpose(objposes, cam_x, cam_o, img))
+        {
+            std::cerr << "ERROR::TEMPLATELIBRARY::GENERATE\nERROR:\n\tCould not render templates " << first << " to " << first + batch - 1 << "." << std::endl;
+            success = false;
+            break;
+        }
+
+        const size_t rows = (batch + tiles_cols - 1) / tiles_cols;
+        const int tile_width = img.cols / static_cast<int>(tiles_cols);
+        const int tile_height = img.rows / static_cast<int>(rows);
+        header.image_width = static_cast<std::uint32_t>(tile_width);
+        header.image_height = static_cast<std::uint32_t>(tile_height);
+
+        for (size_t k = 0; k < batch; ++k)
+        {
+            const cv::Mat tile = img(cv::Rect(tile_width * static_cast<int>(k % tiles_cols), tile_height * static_cast<int>(k / tiles_cols), tile_width, tile_height));
+
+            /* Edges are the mask pixels with a neighbour outside the mask, i.e. removed by erosion. Pixels on the image border are not edges. */
+            const cv::Mat mask = tile > 0;
+            cv::Mat edges;
+            cv::erode(mask, edges, cv::Mat());
+            cv::bitwise_xor(mask, edges, edges);
+
+            const cv::Rect roi = cv::boundingRect(mask);
+
+            Entry& entry = entries[first + k];
+            entry.x = roi.x;
+            entry.y = roi.y;
+            entry.width = roi.width;
+            entry.height = roi.height;
+            entry.mask_offset = data_offset;
+            entry.edges_offset = data_offset;
+
+            if (roi.area() == 0)
+                continue;
+
+            ++visible_templates;
+
+            packed.clear();
+            packBits(mask(roi), packed);
+            entry.edges_offset = data_offset + packed.size();
+            packBits(edges(roi), packed);
+
+            file.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+            data_offset += packed.size();
+        }
+    }
+
+    restore();
+
+    if (!success)
+        return discard();
+
+    if (visible_templates == 0)
+        std::cerr << "WARNING::TEMPLATELIBRARY::GENERATE\nWARNING:\n\tMesh model " << mesh_id << " is not visible in any template." << std::endl;
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+
+    if (!file.good())
+    {
+        std::cerr << "ERROR::TEMPLATELIBRARY::GENERATE\nERROR:\n\tCould not write " << path << "." << std::endl;
+        return discard();
+    }
+
+    return true;
+}
+
+
+size_t TemplateLibrary::size() const
+{
+    return getOrientationsNumber() * getDistancesNumber();
+}
+
+
+size_t TemplateLibrary::getOrientationsNumber() const
+{
+    return header_->orientations_num;
+}
+
+
+size_t TemplateLibrary::getDistancesNumber() const
+{
+    return header_->distances_num;
+}
+
+
+cv::Size TemplateLibrary::getImageSize() const
+{
+    return cv::Size(static_cast<int>(header_->image_width), static_cast<int>(header_->image_height));
+}
+
+
+TemplateLibrary::Template TemplateLibrary::getTemplate(const size_t index) const
+{
+    Template item;
+    if (index >= size())
+        return item;
+
+    const Entry& entry = entries_[index];
+    const float* q = orientations_ + 4 * (index / getDistancesNumber());
+    const double distance = distances_[index % getDistancesNumber()];
+
+    item.pose.resize(7);
+    for (int i = 0; i < 3; ++i)
+        item.pose[i] = header_->optical_axis[i] * distance;
+
+    const double grid_q[] = { q[0], q[1], q[2], q[3] };
+    const std::array<double, 4> axis_angle = toAxisAngle(grid_q);
+    for (int i = 0; i < 4; ++i)
+        item.pose[3 + i] = axis_angle[i];
+
+    item.roi = cv::Rect(entry.x, entry.y, entry.width, entry.height);
+    if (item.roi.area() == 0)
+        return item;
+
+    const size_t packed_size = static_cast<size_t>((entry.width + 7) / 8) * entry.height;
+    if (entry.mask_offset + packed_size > data_size_ || entry.edges_offset + packed_size > data_size_)
+    {
+        std::cerr << "ERROR::TEMPLATELIBRARY::GETTEMPLATE\nERROR:\n\tTemplate " << index << " lies outside the file." << std::endl;
+        item.roi = cv::Rect();
+        return item;
+    }
+
+    item.mask = unpackBits(data_ + entry.mask_offset, item.roi.size());
+    item.edges = unpackBits(data_ + entry.edges_offset, item.roi.size());
+
+    return item;
+}
+
+
+size_t TemplateLibrary::findNearest(const Superimpose::ModelPose& pose) const
+{
+    return findNearest(pose, 1).front();
+}
+
+
+std::vector<size_t> TemplateLibrary::findNearest(const Superimpose::ModelPose& pose, const size_t k) const
+{
+    /* The absolute dot product of two unit quaternions is the cosine of half the angle between the rotations. */
+    const std::array<double, 4> q = toQuaternion(pose.data() + 3);
+    const size_t orientations_num = getOrientationsNumber();
+
+    std::vector<float> similarities(orientations_num);
+    for (size_t i = 0; i < orientations_num; ++i)
+    {
+        const float* grid_q = orientations_ + 4 * i;
+        similarities[i] = static_cast<float>(std::abs(q[0] * grid_q[0] + q[1] * grid_q[1] + q[2] * grid_q[2] + q[3] * grid_q[3]));
+    }
+
+    std::vector<size_t> nearest(orientations_num);
+    std::iota(nearest.begin(), nearest.end(), 0);
+
+    const size_t nearest_num = std::min(std::max<size_t>(k, 1), orientations_num);
+    std::partial_sort(nearest.begin(), nearest.begin() + nearest_num, nearest.end(),
+                      [&similarities](const size_t a, const size_t b) { return similarities[a] > similarities[b]; });
+    nearest.resize(nearest_num);
+
+    const size_t distance_index = findNearestDistance(pose);
+    for (size_t& index : nearest)
+        index = index * getDistancesNumber() + distance_index;
+
+    return nearest;
+}
+
+
+std::array<double, 4> TemplateLibrary::toQuaternion(const double* axis_angle)
+{
+    const double axis_norm = std::sqrt(axis_angle[0] * axis_angle[0] + axis_angle[1] * axis_angle[1] + axis_angle[2] * axis_angle[2]);
+    if (axis_norm == 0)
+        return { { 1.0, 0.0, 0.0, 0.0 } };
+
+    const double sin_half_angle = std::sin(axis_angle[3] / 2.0) / axis_norm;
+
+    return { { std::cos(axis_angle[3] / 2.0), axis_angle[0] * sin_half_angle, axis_angle[1] * sin_half_angle, axis_angle[2] * sin_half_angle } };
+}
+
+
+std::array<double, 4> TemplateLibrary::toAxisAngle(const double* quaternion)
+{
+    const double sin_half_angle = std::sqrt(quaternion[1] * quaternion[1] + quaternion[2] * quaternion[2] + quaternion[3] * quaternion[3]);
+    if (sin_half_angle < 1e-12)
+        return { { 1.0, 0.0, 0.0, 0.0 } };
+
+    return { { quaternion[1] / sin_half_angle, quaternion[2] / sin_half_angle, quaternion[3] / sin_half_angle, 2.0 * std::atan2(sin_half_angle, quaternion[0]) } };
+}
+
+
+void TemplateLibrary::packBits(const cv::Mat& mask, std::vector<unsigned char>& data)
+{
+    /* Rows are padded to whole bytes, the most significant bit being the leftmost pixel. */
+    const int row_bytes = (mask.cols + 7) / 8;
+
+    for (int y = 0; y < mask.rows; ++y)
+    {
+        const unsigned char* row = mask.ptr<unsigned char>(y);
+
+        const size_t row_offset = data.size();
+        data.resize(row_offset + row_bytes, 0);
+
+        for (int x = 0; x < mask.cols; ++x)
+            if (row[x] != 0)
+                data[row_offset + x / 8] |= static_cast<unsigned char>(0x80 >> (x % 8));
+    }
+}
+
+
+cv::Mat TemplateLibrary::unpackBits(const unsigned char* data, const cv::Size& size)
+{
+    const int row_bytes = (size.width + 7) / 8;
+
+    cv::Mat mask(size, CV_8UC1);
+    for (int y = 0; y < size.height; ++y)
+    {
+        const unsigned char* packed_row = data + static_cast<size_t>(y) * row_bytes;
+        unsigned char* row = mask.ptr<unsigned char>(y);
+
+        for (int x = 0; x < size.width; ++x)
+            row[x] = (packed_row[x / 8] & (0x80 >> (x % 8))) ? 255 : 0;
+    }
+
+    return mask;
+}
+
+
+void TemplateLibrary::unmap()
+{
+#ifdef _WIN32
+    if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+
+    if (mapping_handle_ != nullptr)
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+
+    if (file_handle_ != nullptr)
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    if (data_ != nullptr)
+        munmap(const_cast<unsigned char*>(data_), data_size_);
+#endif
+
+    data_ = nullptr;
+    data_size_ = 0;
+}
+
+
+size_t TemplateLibrary::findNearestDistance(const Superimpose::ModelPose& pose) const
+{
+    const double distance = std::sqrt(pose[0] * pose[0] + pose[1] * pose[1] + pose[2] * pose[2]);
+
+    size_t nearest = 0;
+    for (size_t i = 1; i < getDistancesNumber(); ++i)
+        if (std::abs(distances_[i] - distance) < std::abs(distances_[nearest] - distance))
+            nearest = i;
+
+    return nearest;
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "SuperimposeMesh/TextureCache.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+
+TextureCache& TextureCache::getInstance()
+{
+    static TextureCache cache;
+
+    return cache;
+}
+
+
+std::string TextureCache::getKey(const char* data, const size_t size)
+{
+    /* 64-bit FNV-1a hash. */
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash << "-" << std::dec << size;
+
+    return key.str();
+}
+
+
+std::string TextureCache::getCanonicalPath(const std::string& path)
+{
+#ifdef _WIN32
+    char canonical_path[_MAX_PATH];
+    if (_fullpath(canonical_path, path.c_str(), _MAX_PATH) == nullptr)
+        return "";
+#else
+    char canonical_path[PATH_MAX];
+    if (realpath(path.c_str(), canonical_path) == nullptr)
+        return "";
+#endif
+
+    return std::string(canonical_path);
+}
+
+
+bool TextureCache::findPath(const std::string& canonical_path, std::string& key) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto iter_path = paths_.find(canonical_path);
+    if (iter_path == paths_.end())
+        return false;
+
+    key = iter_path->second;
+
+    return true;
+}
+
+
+void TextureCache::addPath(const std::string& canonical_path, const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    paths_[canonical_path] = key;
+}
+
+
+bool TextureCache::contains(const std::string& key) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return textures_.find(key) != textures_.end();
+}
+
+
+bool TextureCache::acquire(const std::string& key, GLuint& texture)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto iter_texture = textures_.find(key);
+    if (iter_texture == textures_.end())
+        return false;
+
+    ++(iter_texture->second.references);
+    texture = iter_texture->second.id;
+
+    return true;
+}
+
+
+GLuint TextureCache::acquire(const std::string& key, const cv::Mat& image)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto iter_texture = textures_.find(key);
+    if (iter_texture != textures_.end())
+    {
+        ++(iter_texture->second.references);
+        return iter_texture->second.id;
+    }
+
+    /* Mipmaps take one third of the memory of the base level. */
+    auto texture_bytes = [](const cv::Mat& mipmap) { return mipmap.total() * mipmap.elemSize() * 4 / 3; };
+
+    /* Downscale to the largest mipmap level fitting the memory budget. */
+    cv::Mat level = image;
+    while (memory_usage_ + texture_bytes(level) > memory_budget_ && (level.cols > 1 || level.rows > 1))
+    {
+        cv::Mat next_level;
+        cv::resize(level, next_level, cv::Size(std::max(level.cols / 2, 1), std::max(level.rows / 2, 1)), 0, 0, cv::INTER_AREA);
+        level = next_level;
+    }
+
+    if (level.cols != image.cols || level.rows != image.rows)
+        std::cout << log_ID_ << "Texture downscaled from " << image.cols << "x" << image.rows << " to " << level.cols << "x" << level.rows << " to fit the memory budget." << std::endl;
+
+    /* Generate texture ID and load texture data. */
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+
+    /* Assign texture to ID. */
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, (level.step & 3) ? 1 : 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, level.cols, level.rows, 0, GL_RGB, GL_UNSIGNED_BYTE, level.ptr());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    /* Parameters. */
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    /* Texture objects are used by other contexts sharing them, hence they must be completely uploaded. */
+    glFinish();
+
+    Texture texture;
+    texture.id = textureID;
+    texture.references = 1;
+    texture.bytes = texture_bytes(level);
+
+    textures_[key] = texture;
+    keys_[textureID] = key;
+    memory_usage_ += texture.bytes;
+
+    return textureID;
+}
+
+
+void TextureCache::release(const GLuint texture)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto iter_key = keys_.find(texture);
+    if (iter_key == keys_.end())
+        return;
+
+    Texture& cached = textures_[iter_key->second];
+    if (--cached.references > 0)
+        return;
+
+    glDeleteTextures(1, &cached.id);
+    memory_usage_ -= cached.bytes;
+
+    textures_.erase(iter_key->second);
+    keys_.erase(iter_key);
+}
+
+
+void TextureCache::setMemoryBudget(const size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    memory_budget_ = bytes;
+}
+
+
+size_t TextureCache::getMemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return memory_budget_;
+}
+
+
+size_t TextureCache::getMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return memory_usage_;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Batch size]";
+    std::cout << log_ID << "This test checks whether batches smaller and larger than the render grid match single-tile renders." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 4);
+
+    const int tiles_num  = si_cad.getTilesNumber();
+    const int tiles_cols = si_cad.getTilesCols();
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    /* Each pose moves the model sideways, so that tiles swapped or out of order are detected. */
+    const int batch_sizes[] = { 1, tiles_num - 1, 2 * tiles_num + 1 };
+
+    for (const int batch_size : batch_sizes)
+    {
+        if (batch_size < 1)
+            continue;
+
+        std::vector<Superimpose::ModelPoseContainer> objposes(batch_size);
+        for (int k = 0; k < batch_size; ++k)
+        {
+            Superimpose::ModelPose pose(7);
+            pose[0] = -0.05 + 0.01 * k;
+            pose[1] = 0;
+            pose[2] = -0.2;
+            pose[3] = 0;
+            pose[4] = 1.0;
+            pose[5] = 0;
+            pose[6] = 0;
+
+            objposes[k].emplace("alien", pose);
+        }
+
+        cv::Mat img_batch;
+        if (!si_cad.superimpose(objposes, cam_x, cam_o, img_batch))
+        {
+            std::cerr << log_ID << " Failed to render a batch of " << batch_size << " poses." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        const int rows = (batch_size + tiles_cols - 1) / tiles_cols;
+        if (img_batch.rows != static_cast<int>(rows * cam_height) || img_batch.cols != static_cast<int>(tiles_cols * cam_width))
+        {
+            std::cerr << log_ID << " Wrong image size for a batch of " << batch_size << " poses." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        if (si_cad.getEmptyTiles().size() != static_cast<size_t>(batch_size))
+        {
+            std::cerr << log_ID << " Wrong number of empty tile flags for a batch of " << batch_size << " poses." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        for (int k = 0; k < batch_size; ++k)
+        {
+            cv::Mat img_single;
+            si_cad.superimpose(objposes[k], cam_x, cam_o, img_single);
+
+            const cv::Rect tile((k % tiles_cols) * cam_width, (k / tiles_cols) * cam_height, cam_width, cam_height);
+            if (cv::norm(img_batch(tile), img_single, cv::NORM_INF) != 0)
+            {
+                std::cerr << log_ID << " Tile " << k << " of a batch of " << batch_size << " poses does not match its single-tile render." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+
+        /* Tiles left over in the last row are blank. */
+        for (int k = batch_size; k < rows * tiles_cols; ++k)
+        {
+            const cv::Rect tile((k % tiles_cols) * cam_width, (k / tiles_cols) * cam_height, cam_width, cam_height);
+            if (cv::norm(img_batch(tile), cv::NORM_INF) != 0)
+            {
+                std::cerr << log_ID << " Unused tile " << k << " of a batch of " << batch_size << " poses is not blank." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    std::cout << log_ID << " Batches match single-tile renders." << std::endl;
+
+    return EXIT_SUCCESS;
+}
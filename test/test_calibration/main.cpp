@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <utils.h>
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Calibration]";
+    std::cout << log_ID << "This test checks whether the calibrated render configuration is used and persisted for later constructions." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+    const int          num_images = 3;
+
+    const std::string calibration_file = "./test_calibration.txt";
+    std::remove(calibration_file.c_str());
+
+    SICAD::setCalibrationFile(calibration_file);
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.2;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    SICAD::Calibration calibration;
+    cv::Mat img_reference;
+    {
+        SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, num_images);
+
+        if (si_cad.getCalibration().images_per_second != 0.0)
+        {
+            std::cerr << log_ID << " A calibration is available before calibrating." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        if (!si_cad.calibrate(objpose_map, cam_x, cam_o))
+        {
+            std::cerr << log_ID << " Failed to calibrate." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        calibration = si_cad.getCalibration();
+        if (calibration.images_per_second <= 0.0 ||
+            si_cad.getTilesCols() != calibration.tiles_cols || si_cad.getTilesRows() != calibration.tiles_rows)
+        {
+            std::cerr << log_ID << " The calibrated render grid is not in use." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        if (calibration.tiles_cols * calibration.tiles_rows < num_images)
+        {
+            std::cerr << log_ID << " The calibrated render grid has fewer tiles than the requested images." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        if (calibration.batch_rows < 1 || calibration.batch_rows > calibration.tiles_rows || calibration.pbo_depth < 1 || calibration.pbo_depth > 3 ||
+            (calibration.pbo_readback && calibration.batch_rows != calibration.tiles_rows))
+        {
+            std::cerr << log_ID << " The calibrated batch size or PBO depth is invalid." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        /* Resizing back to the calibrated configuration restores the calibrated render grid. */
+        if (!si_cad.resize(num_images + 1, cam_width, cam_height) || !si_cad.resize(num_images, cam_width, cam_height) ||
+            si_cad.getTilesCols() != calibration.tiles_cols || si_cad.getTilesRows() != calibration.tiles_rows)
+        {
+            std::cerr << log_ID << " The calibrated render grid is not restored by resize()." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        std::vector<Superimpose::ModelPoseContainer> objposes(num_images, objpose_map);
+
+        if (!si_cad.superimpose(objposes, cam_x, cam_o, img_reference))
+        {
+            std::cerr << log_ID << " Failed to render with the calibrated render configuration." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        img_reference = img_reference(cv::Rect(0, 0, img_reference.cols / si_cad.getTilesCols(), img_reference.rows / ((num_images + si_cad.getTilesCols() - 1) / si_cad.getTilesCols()))).clone();
+    }
+
+    if (!std::ifstream(calibration_file).good())
+    {
+        std::cerr << log_ID << " The calibration file has not been written." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    {
+        SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, num_images);
+
+        const SICAD::Calibration& read = si_cad.getCalibration();
+        if (si_cad.getTilesCols() != calibration.tiles_cols || si_cad.getTilesRows() != calibration.tiles_rows ||
+            read.batch_rows != calibration.batch_rows || read.pbo_readback != calibration.pbo_readback || read.pbo_depth != calibration.pbo_depth)
+        {
+            std::cerr << log_ID << " The calibration has not been read at construction." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Replace the calibration with a single-column grid rendering a row of tiles per pass through 3 PBOs. */
+    std::string line;
+    {
+        std::ifstream file(calibration_file);
+        std::getline(file, line);
+    }
+
+    std::vector<std::string> fields;
+    {
+        std::istringstream values(line);
+        std::string field;
+        while (std::getline(values, field, '\t'))
+            fields.push_back(field);
+    }
+
+    if (fields.size() != 10)
+    {
+        std::cerr << log_ID << " The calibration file has " << fields.size() << " fields instead of 10." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    fields[4] = "1";
+    fields[5] = std::to_string(num_images);
+    fields[6] = "1";
+    fields[7] = "0";
+    fields[8] = "3";
+
+    {
+        std::ofstream file(calibration_file, std::ios::trunc);
+        for (size_t i = 0; i < fields.size(); ++i)
+            file << fields[i] << (i + 1 < fields.size() ? "\t" : "\n");
+    }
+
+    {
+        SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, num_images);
+
+        if (si_cad.getTilesCols() != 1 || si_cad.getTilesRows() != num_images || si_cad.getCalibration().batch_rows != 1 || si_cad.getCalibration().pbo_depth != 3)
+        {
+            std::cerr << log_ID << " The edited calibration has not been read at construction." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        /* Each image is rendered in its own pass and all of them are rendered as by the calibrated configuration. */
+        std::vector<Superimpose::ModelPoseContainer> objposes(num_images, objpose_map);
+
+        cv::Mat img_rendered;
+        if (!si_cad.superimpose(objposes, cam_x, cam_o, img_rendered) || img_rendered.rows != num_images * img_reference.rows)
+        {
+            std::cerr << log_ID << " Failed to render in multiple passes." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        for (int i = 0; i < num_images; ++i)
+        {
+            if (!utils::compareImages(img_rendered(cv::Rect(0, i * img_reference.rows, img_reference.cols, img_reference.rows)), img_reference))
+            {
+                std::cerr << log_ID << " Image " << i << " rendered in multiple passes differs from the one rendered by the calibrated configuration." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    std::remove(calibration_file.c_str());
+    SICAD::setCalibrationFile("");
+
+    std::cout << log_ID << " The calibration is used and persisted." << std::endl;
+
+    return EXIT_SUCCESS;
+}
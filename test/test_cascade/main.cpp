@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Cascade]";
+    std::cout << log_ID << "This test checks whether coarse-to-fine rendering selects and re-renders the right hypotheses." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 6);
+
+    /* Only the hypotheses 1 and 3 are in the field of view. */
+    const double xs[] = { -0.5, 0.0, 0.5, 0.01, 0.9, -0.9 };
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(6);
+    for (size_t k = 0; k < objposes.size(); ++k)
+    {
+        Superimpose::ModelPose pose(7);
+        pose[0] = xs[k];
+        pose[1] = 0;
+        pose[2] = -0.2;
+        pose[3] = 0;
+        pose[4] = 1.0;
+        pose[5] = 0;
+        pose[6] = 0;
+
+        objposes[k].emplace("alien", pose);
+    }
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    const float scale = 0.25f;
+    const int coarse_width  = cam_width * scale;
+    const int coarse_height = cam_height * scale;
+    const int tiles_cols = si_cad.getTilesCols();
+
+    bool coarse_size_ok = true;
+    const auto select = [&](const cv::Mat& coarse_img) -> std::vector<size_t>
+    {
+        coarse_size_ok = coarse_img.cols == tiles_cols * coarse_width &&
+                         coarse_img.rows == static_cast<int>((objposes.size() + tiles_cols - 1) / tiles_cols) * coarse_height;
+
+        std::vector<size_t> selection;
+        if (!coarse_size_ok)
+            return selection;
+
+        for (size_t k = 0; k < objposes.size(); ++k)
+        {
+            cv::Mat tile_gray;
+            cv::cvtColor(coarse_img(cv::Rect((k % tiles_cols) * coarse_width, (k / tiles_cols) * coarse_height, coarse_width, coarse_height)), tile_gray, cv::COLOR_BGR2GRAY);
+
+            if (cv::countNonZero(tile_gray) > 0)
+                selection.push_back(k);
+        }
+
+        return selection;
+    };
+
+    cv::Mat img_fine;
+    std::vector<size_t> selected;
+    if (!si_cad.superimposeCascade(objposes, cam_x, cam_o, scale, select, img_fine, selected))
+    {
+        std::cerr << log_ID << " Failed to render the cascade." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (!coarse_size_ok)
+    {
+        std::cerr << log_ID << " Wrong coarse image size." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (selected != std::vector<size_t>({ 1, 3 }))
+    {
+        std::cerr << log_ID << " Wrong hypotheses selected at the coarse level." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (si_cad.getResolutionScaleOpt() != 1.0f)
+    {
+        std::cerr << log_ID << " The resolution scale has not been restored." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The fine level matches a direct full resolution rendering of the selected hypotheses. */
+    std::vector<Superimpose::ModelPoseContainer> objposes_selected;
+    for (const size_t k : selected)
+        objposes_selected.push_back(objposes[k]);
+
+    cv::Mat img_direct;
+    si_cad.superimpose(objposes_selected, cam_x, cam_o, img_direct);
+
+    if (img_fine.size() != img_direct.size() || cv::norm(img_fine, img_direct, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " The fine level does not match the full resolution rendering." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The coarse scale must be below the current one. */
+    if (si_cad.superimposeCascade(objposes, cam_x, cam_o, 1.0f, select, img_fine, selected))
+    {
+        std::cerr << log_ID << " A coarse scale not below the current one has been accepted." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Each level keeps its render cache, so that repeating the cascade renders no tile at the fine level. */
+    si_cad.setRenderCacheOpt(true, 1e-6);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (!si_cad.superimposeCascade(objposes, cam_x, cam_o, scale, select, img_fine, selected))
+        {
+            std::cerr << log_ID << " Failed to render the cascade with the render cache." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (si_cad.getRenderedTilesNumber() != 0 || img_fine.size() != img_direct.size() || cv::norm(img_fine, img_direct, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " The fine level has not been reused from the render cache." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Coarse-to-fine rendering is consistent." << std::endl;
+
+    return EXIT_SUCCESS;
+}
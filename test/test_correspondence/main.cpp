@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Correspondence]";
+    std::cout << log_ID << "This test checks whether the model points of the rendered pixels project back onto the pixels." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1);
+
+    if (!si_cad.setCorrespondenceOpt(true))
+    {
+        std::cerr << log_ID << " Failed to enable correspondences." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    const std::vector<SICAD::Correspondence>& correspondences = si_cad.getCorrespondences();
+
+    cv::Mat img_gray;
+    cv::cvtColor(img_rendered, img_gray, cv::COLOR_BGR2GRAY);
+
+    if (correspondences.empty() || correspondences.size() != static_cast<size_t>(cv::countNonZero(img_gray)))
+    {
+        std::cerr << log_ID << " Correspondences do not cover the rendered pixels." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Triangles are indexed across all the meshes of the model. Models are imported on the CPU only, hence with no context. */
+    const size_t triangles_number = Model("./spaceinvader.obj").getTrianglesNumber(0);
+
+    /* Both the camera and the model are not rotated, the camera looks along the negative z axis. */
+    for (const SICAD::Correspondence& correspondence : correspondences)
+    {
+        const double x = correspondence.point.x + obj_pose[0];
+        const double y = correspondence.point.y + obj_pose[1];
+        const double z = correspondence.point.z + obj_pose[2];
+
+        const double u = cam_cx + cam_fx * x / -z;
+        const double v = cam_cy - cam_fy * y / -z;
+
+        if (correspondence.tile != 0 || correspondence.triangle >= triangles_number || img_gray.at<unsigned char>(correspondence.v, correspondence.u) == 0 ||
+            std::abs(u - (correspondence.u + 0.5)) > 1.0 || std::abs(v - (correspondence.v + 0.5)) > 1.0)
+        {
+            std::cerr << log_ID << " Model point (" << correspondence.point.x << ", " << correspondence.point.y << ", " << correspondence.point.z << ") "
+                      << "of triangle " << correspondence.triangle << " projects onto (" << u << ", " << v << ") "
+                      << "instead of pixel (" << correspondence.u << ", " << correspondence.v << ")." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << log_ID << " " << correspondences.size() << " model points project back onto their pixels." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Depth only]";
+    std::cout << log_ID << "This test checks whether the depth-only render mode renders the same pixels of the color mode with the expected depth." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1);
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_color;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_color);
+
+    if (!si_cad.setRenderModeOpt(SICAD::RenderMode::depth))
+    {
+        std::cerr << log_ID << " Failed to set the depth render mode." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    cv::Mat img_depth;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_depth);
+
+    if (img_depth.type() != CV_32FC1 || img_depth.size() != img_color.size())
+    {
+        std::cerr << log_ID << " Wrong depth image type or size." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    cv::Mat mask_color;
+    cv::cvtColor(img_color, mask_color, cv::COLOR_BGR2GRAY);
+    mask_color = mask_color > 0;
+
+    cv::Mat mask_depth = img_depth > 0;
+
+    cv::Mat mask_diff;
+    cv::bitwise_xor(mask_color, mask_depth, mask_diff);
+
+    if (cv::countNonZero(mask_depth) == 0 || cv::countNonZero(mask_diff) != 0)
+    {
+        std::cerr << log_ID << " Depth image does not cover the same pixels of the color image." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The model is small with respect to its distance from the camera. */
+    double min_depth;
+    double max_depth;
+    cv::minMaxLoc(img_depth, &min_depth, &max_depth, nullptr, nullptr, mask_depth);
+
+    if (min_depth < 0.05 || max_depth > 0.15)
+    {
+        std::cerr << log_ID << " Depth in [" << min_depth << ", " << max_depth << "] is not close to the model distance." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Back to color mode the image is rendered as before. */
+    si_cad.setRenderModeOpt(SICAD::RenderMode::color);
+
+    cv::Mat img_color_again;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_color_again);
+
+    cv::Mat img_diff;
+    cv::absdiff(img_color, img_color_again, img_diff);
+    cv::cvtColor(img_diff, img_diff, cv::COLOR_BGR2GRAY);
+
+    if (cv::countNonZero(img_diff) != 0)
+    {
+        std::cerr << log_ID << " Color image changed after switching render mode." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    cv::Mat img_depth_8u;
+    img_depth.convertTo(img_depth_8u, CV_8UC1, 255.0 / max_depth);
+    cv::imwrite("./test_depth_only.png", img_depth_8u);
+
+    std::cout << log_ID << " Depth image matches the color image. Saving rendered depth for visual inspection." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Frustum culling]";
+    std::cout << log_ID << "This test checks whether models outside the view frustum are culled and their tiles reported as empty." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 3);
+
+
+    /* In front of the camera. */
+    Superimpose::ModelPose visible_pose(7);
+    visible_pose[0] = 0;
+    visible_pose[1] = 0;
+    visible_pose[2] = -0.1;
+    visible_pose[3] = 0;
+    visible_pose[4] = 1.0;
+    visible_pose[5] = 0;
+    visible_pose[6] = 0;
+
+    /* Behind the camera. */
+    Superimpose::ModelPose behind_pose(visible_pose);
+    behind_pose[2] = 0.1;
+
+    /* Far outside the image. */
+    Superimpose::ModelPose aside_pose(visible_pose);
+    aside_pose[0] = 10.0;
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(3);
+    objposes[0].emplace("alien", visible_pose);
+    objposes[1].emplace("alien", behind_pose);
+    objposes[2].emplace("alien", aside_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+
+    si_cad.superimpose(objposes, cam_x, cam_o, img_rendered);
+
+    cv::imwrite("./test_frustum_culling.png", img_rendered);
+
+    const std::vector<bool>& empty_tiles = si_cad.getEmptyTiles();
+
+    if (empty_tiles.size() != 3 || empty_tiles[0] || !empty_tiles[1] || !empty_tiles[2])
+    {
+        std::cerr << log_ID << " Wrong empty tile flags." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    const int tile_width  = img_rendered.cols / si_cad.getTilesCols();
+    const int tile_height = img_rendered.rows / si_cad.getTilesRows();
+
+    for (int idx = 0; idx < si_cad.getTilesNumber(); ++idx)
+    {
+        cv::Mat tile = img_rendered(cv::Rect(tile_width * (idx % si_cad.getTilesCols()), tile_height * (idx / si_cad.getTilesCols()), tile_width, tile_height));
+
+        cv::Mat tile_gray;
+        cv::cvtColor(tile, tile_gray, cv::COLOR_BGR2GRAY);
+
+        if ((cv::countNonZero(tile_gray) == 0) != empty_tiles[idx])
+        {
+            std::cerr << log_ID << " Content of tile " << idx << " does not match its empty tile flag." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << log_ID << " Empty tile flags match the rendered tiles. Saving rendered image for visual inspection." << std::endl;
+
+    return EXIT_SUCCESS;
+}
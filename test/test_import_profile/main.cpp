@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+/**
+ * Returns a Wavefront OBJ grid of 64x64 vertices whose triangles are stored in random order, i.e. with almost no vertex cache locality.
+ */
+std::string shuffledGrid()
+{
+    const int grid_size = 64;
+
+    std::ostringstream obj;
+    for (int j = 0; j < grid_size; ++j)
+        for (int i = 0; i < grid_size; ++i)
+            obj << "v " << 0.001 * i << " " << 0.001 * j << " 0\nvn 0 0 1\n";
+
+    std::vector<std::array<int, 3>> triangles;
+    for (int j = 0; j + 1 < grid_size; ++j)
+    {
+        for (int i = 0; i + 1 < grid_size; ++i)
+        {
+            const int a = 1 + j * grid_size + i;
+            triangles.push_back({{ a, a + 1, a + grid_size + 1 }});
+            triangles.push_back({{ a, a + grid_size + 1, a + grid_size }});
+        }
+    }
+
+    std::mt19937 generator(0);
+    std::shuffle(triangles.begin(), triangles.end(), generator);
+
+    for (const std::array<int, 3>& triangle : triangles)
+        obj << "f " << triangle[0] << "//" << triangle[0] << " " << triangle[1] << "//" << triangle[1] << " " << triangle[2] << "//" << triangle[2] << "\n";
+
+    return obj.str();
+}
+
+
+cv::Mat render(const Model::ImportProfile& profile)
+{
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1, "__prc/shader", { 1.0, 0.0, 0.0, 0.0 }, profile);
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0.3;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0.2;
+    obj_pose[6] = 0.7;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    return img_rendered;
+}
+
+
+int testStatistics(const std::string& log_ID, const Model::ImportProfile& optimized)
+{
+    const Model model("./spaceinvader.obj", Model::ImportProfile());
+    const Model optimized_model("./spaceinvader.obj", optimized);
+
+    const Model::ImportStatistics& statistics = model.getImportStatistics();
+    const Model::ImportStatistics& optimized_statistics = optimized_model.getImportStatistics();
+
+    std::cout << log_ID << " Vertices from " << optimized_statistics.vertices_before << " to " << optimized_statistics.vertices_after << ", "
+              << "ACMR from " << optimized_statistics.acmr_before << " to " << optimized_statistics.acmr_after << "." << std::endl;
+
+    /* The default profile imports meshes as they are stored. */
+    if (statistics.vertices_after != statistics.vertices_before || statistics.acmr_after != statistics.acmr_before)
+    {
+        std::cerr << log_ID << " The default import profile changed the mesh model." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (optimized_statistics.vertices_after >= optimized_statistics.vertices_before ||
+        optimized_statistics.acmr_after > optimized_statistics.acmr_before)
+    {
+        std::cerr << log_ID << " The import profile did not weld the vertices without increasing the ACMR." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Triangles in random order are reordered for vertex cache locality, and overdraw ordering mostly preserves it. */
+    std::ofstream grid_file("./test_import_profile_grid.obj");
+    grid_file << shuffledGrid();
+    grid_file.close();
+
+    Model::ImportProfile welded;
+    welded.weld_vertices = true;
+
+    Model::ImportProfile cache_optimized(welded);
+    cache_optimized.optimize_vertex_cache = true;
+
+    const float acmr_welded = Model("./test_import_profile_grid.obj", welded).getImportStatistics().acmr_after;
+    const float acmr_cache_optimized = Model("./test_import_profile_grid.obj", cache_optimized).getImportStatistics().acmr_after;
+    const float acmr_optimized = Model("./test_import_profile_grid.obj", optimized).getImportStatistics().acmr_after;
+
+    std::cout << log_ID << " Shuffled grid ACMR is " << acmr_welded << " welded, " << acmr_cache_optimized << " reordered for the vertex cache, "
+              << acmr_optimized << " reordered for overdraw as well." << std::endl;
+
+    if (acmr_cache_optimized >= acmr_welded || acmr_optimized >= acmr_welded)
+    {
+        std::cerr << log_ID << " Reordering triangles did not reduce the ACMR of the shuffled grid." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int testContext(const std::string& log_ID, const Model::ImportProfile& optimized)
+{
+    if (glfwInit() == GL_FALSE)
+    {
+        std::cerr << log_ID << " Failed to initialize GLFW." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Same context as the one created by SICAD. */
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(1, 1, "OpenGL window", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cerr << log_ID << " Failed to create the OpenGL context." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+        std::cerr << log_ID << " Failed to initialize GLEW." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    /* Models are imported with a current OpenGL context, as SICAD does. */
+    int result = testStatistics(log_ID, optimized);
+
+    glfwMakeContextCurrent(nullptr);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    return result;
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Import profile]";
+    std::cout << log_ID << "This test checks whether the import optimizations reduce the vertices and the ACMR of mesh models, and render them as imported." << std::endl;
+
+    Model::ImportProfile optimized;
+    optimized.weld_vertices = true;
+    optimized.optimize_vertex_cache = true;
+    optimized.optimize_overdraw = true;
+
+    if (testContext(log_ID, optimized) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    /* Reordered triangles cover the same pixels, and differ only where triangles have the same depth. */
+    cv::Mat img_imported = render(Model::ImportProfile());
+    cv::Mat img_optimized = render(optimized);
+
+    cv::imwrite("./test_import_profile.png", img_optimized);
+
+    cv::Mat mask_imported;
+    cv::cvtColor(img_imported, mask_imported, cv::COLOR_BGR2GRAY);
+    mask_imported = mask_imported > 0;
+
+    cv::Mat mask_optimized;
+    cv::cvtColor(img_optimized, mask_optimized, cv::COLOR_BGR2GRAY);
+    mask_optimized = mask_optimized > 0;
+
+    cv::Mat mask_diff;
+    cv::bitwise_xor(mask_imported, mask_optimized, mask_diff);
+
+    cv::Mat img_diff;
+    cv::absdiff(img_imported, img_optimized, img_diff);
+    cv::cvtColor(img_diff, img_diff, cv::COLOR_BGR2GRAY);
+
+    const int foreground = cv::countNonZero(mask_imported);
+    if (foreground == 0 || cv::countNonZero(mask_diff) != 0 || cv::countNonZero(img_diff) > foreground / 100)
+    {
+        std::cerr << log_ID << " The optimized mesh model renders differently from the imported one." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Import optimizations reduce the ACMR and preserve the rendered mesh model." << std::endl;
+
+    return EXIT_SUCCESS;
+}
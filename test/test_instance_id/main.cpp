@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Instance ID]";
+    std::cout << log_ID << "This test checks whether instance IDs and their pixel counts are written in the same pass of color." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 2);
+
+    if (!si_cad.setInstanceIdOpt(true))
+    {
+        std::cerr << log_ID << " Failed to enable instance IDs." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    Superimpose::ModelPose left_pose(7);
+    left_pose[0] = -0.07;
+    left_pose[1] = 0;
+    left_pose[2] = -0.3;
+    left_pose[3] = 0;
+    left_pose[4] = 1.0;
+    left_pose[5] = 0;
+    left_pose[6] = 0;
+
+    Superimpose::ModelPose right_pose(left_pose);
+    right_pose[0] = 0.07;
+
+    /* Two instances of the same model in the first tile, one in the second tile. */
+    std::vector<Superimpose::ModelPoseContainer> objposes(2);
+    objposes[0].emplace("alien", left_pose);
+    objposes[0].emplace("alien", right_pose);
+    objposes[1].emplace("alien", right_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_rendered);
+
+    const cv::Mat& img_ids = si_cad.getInstanceIdImage();
+
+    if (img_ids.type() != CV_16UC1 || img_ids.size() != img_rendered.size())
+    {
+        std::cerr << log_ID << " Wrong instance ID image type or size." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Instance IDs cover the same pixels of color. */
+    cv::Mat mask_color;
+    cv::cvtColor(img_rendered, mask_color, cv::COLOR_BGR2GRAY);
+    mask_color = mask_color > 0;
+
+    cv::Mat mask_ids = img_ids > 0;
+
+    cv::Mat mask_diff;
+    cv::bitwise_xor(mask_color, mask_ids, mask_diff);
+
+    if (cv::countNonZero(mask_diff) != 0)
+    {
+        std::cerr << log_ID << " Instance IDs do not cover the same pixels of color." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<std::vector<size_t>>& counts = si_cad.getInstancePixelCounts();
+
+    if (counts.size() != 2)
+    {
+        std::cerr << log_ID << " Wrong number of tiles in the pixel counts." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    const size_t tile_area = (img_rendered.cols / si_cad.getTilesCols()) * (img_rendered.rows / si_cad.getTilesRows());
+
+    for (size_t idx = 0; idx < counts.size(); ++idx)
+    {
+        size_t total = 0;
+        for (const size_t count : counts[idx])
+            total += count;
+
+        if (total != tile_area)
+        {
+            std::cerr << log_ID << " Pixel counts of tile " << idx << " do not sum up to the tile area." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (counts[0].size() != 3 || counts[0][1] == 0 || counts[0][2] == 0)
+    {
+        std::cerr << log_ID << " Both instances must be visible in the first tile." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The same model at the same pose covers the same pixels, regardless of its ID. */
+    if (counts[1].size() != 2 || counts[1][1] != counts[0][2])
+    {
+        std::cerr << log_ID << " Only the first instance must be visible in the second tile, with the same pixels of the second instance of the first tile." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    cv::Mat img_ids_8u;
+    img_ids.convertTo(img_ids_8u, CV_8UC1, 100.0);
+    cv::imwrite("./test_instance_id.png", img_ids_8u);
+
+    std::cout << log_ID << " Instance IDs match the rendered image. Saving instance IDs for visual inspection." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int testLevels(const std::string& log_ID, const Model::ImportProfile& profile, GLfloat& coarsest_error)
+{
+    const Model model("./spaceinvader.obj", profile);
+
+    const size_t levels = model.getLevelsOfDetail();
+    if (levels != profile.lod_ratios.size() + 1 || model.getLevelOfDetailError(0) != 0.0f)
+    {
+        std::cerr << log_ID << " Wrong number of levels of detail (" << levels << ") or error of the original model." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    for (size_t lod = 1; lod < levels; ++lod)
+    {
+        std::cout << log_ID << " Level of detail " << lod << " has error " << model.getLevelOfDetailError(lod) << "." << std::endl;
+
+        if (model.getLevelOfDetailError(lod) < model.getLevelOfDetailError(lod - 1))
+        {
+            std::cerr << log_ID << " Level of detail " << lod << " has a smaller error than the previous one." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    const size_t coarsest = levels - 1;
+    coarsest_error = model.getLevelOfDetailError(coarsest);
+    if (coarsest_error <= 0.0f)
+    {
+        std::cerr << log_ID << " The coarsest level of detail has no error." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The selected level of detail is the coarsest one within the error threshold, hence it is coarser and coarser as the threshold increases. */
+    size_t previous_lod = 0;
+    for (size_t step = 0; step <= 20; ++step)
+    {
+        const GLfloat max_error = coarsest_error * step / 10.0f;
+        const size_t lod = model.selectLevelOfDetail(max_error);
+
+        if (lod < previous_lod || model.getLevelOfDetailError(lod) > max_error ||
+            (lod < coarsest && model.getLevelOfDetailError(lod + 1) <= max_error))
+        {
+            std::cerr << log_ID << " Wrong level of detail " << lod << " selected for error threshold " << max_error << "." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        previous_lod = lod;
+    }
+
+    if (model.selectLevelOfDetail(coarsest_error) != coarsest)
+    {
+        std::cerr << log_ID << " The coarsest level of detail is not selected within its error." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int testContext(const std::string& log_ID, const Model::ImportProfile& profile, GLfloat& coarsest_error)
+{
+    if (glfwInit() == GL_FALSE)
+    {
+        std::cerr << log_ID << " Failed to initialize GLFW." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Same context as the one created by SICAD. */
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(1, 1, "OpenGL window", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cerr << log_ID << " Failed to create the OpenGL context." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+        std::cerr << log_ID << " Failed to initialize GLEW." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    /* Models are imported with a current OpenGL context, as SICAD does. */
+    int result = testLevels(log_ID, profile, coarsest_error);
+
+    glfwMakeContextCurrent(nullptr);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    return result;
+}
+
+
+cv::Mat render(SICAD& si_cad, const double distance)
+{
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -distance;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    return img_rendered;
+}
+
+
+/**
+ * Returns a Wavefront OBJ flat grid of 16x16 quads, whose left and right halves are mapped to distant regions of the texture,
+ * i.e. with a texture seam along the middle column of vertices.
+ */
+std::string seamGrid()
+{
+    const int grid_size = 16;
+    const int seam = grid_size / 2;
+
+    std::ostringstream obj;
+    obj << "mtllib grid.mtl\nusemtl grid\nvn 0 0 1\n";
+
+    /* Vertices of the left half, then of the right half, both including the seam column. */
+    for (int half = 0; half < 2; ++half)
+    {
+        for (int j = 0; j <= grid_size; ++j)
+        {
+            for (int i = half * seam; i <= seam + half * seam; ++i)
+            {
+                obj << "v " << -0.04 + 0.08 * i / grid_size << " " << -0.04 + 0.08 * j / grid_size << " 0\n";
+                obj << "vt " << 0.5 * i / grid_size + 0.5 * half << " " << static_cast<double>(j) / grid_size << "\n";
+            }
+        }
+    }
+
+    for (int half = 0; half < 2; ++half)
+    {
+        for (int j = 0; j < grid_size; ++j)
+        {
+            for (int i = 0; i < seam; ++i)
+            {
+                const int a = 1 + half * (grid_size + 1) * (seam + 1) + j * (seam + 1) + i;
+                const int b = a + 1;
+                const int c = a + seam + 1;
+                const int d = c + 1;
+
+                obj << "f " << a << "/" << a << "/1 " << b << "/" << b << "/1 " << d << "/" << d << "/1\n";
+                obj << "f " << a << "/" << a << "/1 " << d << "/" << d << "/1 " << c << "/" << c << "/1\n";
+            }
+        }
+    }
+
+    return obj.str();
+}
+
+
+cv::Mat renderSeamGrid(const Model::MemoryFileContainer& files, const Model::ImportProfile& profile)
+{
+    SICAD::ModelPathContainer obj;
+    obj.emplace("grid", "memory/grid.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1, "__prc/shader", { 1.0, 0.0, 0.0, 0.0 }, profile, files);
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("grid", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    return img_rendered;
+}
+
+
+int testSeam(const std::string& log_ID)
+{
+    /* A smooth gradient, so that texture coordinates taken from the wrong side of the seam show up as a large color difference. */
+    cv::Mat texture(256, 256, CV_8UC3);
+    for (int r = 0; r < texture.rows; ++r)
+    {
+        for (int c = 0; c < texture.cols; ++c)
+            texture.at<cv::Vec3b>(r, c) = cv::Vec3b(c, r, 255 - c);
+    }
+
+    std::vector<uchar> encoded_texture;
+    cv::imencode(".png", texture, encoded_texture);
+
+    const std::string grid = seamGrid();
+    const std::string material = "newmtl grid\nKd 1 1 1\nmap_Kd grid.png\n";
+
+    Model::MemoryFileContainer files;
+    files["memory/grid.obj"] = Model::MemoryFile{ grid.data(), grid.size() };
+    files["memory/grid.mtl"] = Model::MemoryFile{ material.data(), material.size() };
+    files["memory/grid.png"] = Model::MemoryFile{ reinterpret_cast<const char*>(encoded_texture.data()), encoded_texture.size() };
+
+    Model::ImportProfile profile;
+    profile.lod_ratios = { 0.1f };
+
+    /* Models are imported on the CPU only, hence with no context. */
+    const Model model("memory/grid.obj", files, profile);
+    if (model.getLevelsOfDetail() != 2 || model.getTrianglesNumber(1) >= model.getTrianglesNumber(0))
+    {
+        std::cerr << log_ID << " The textured grid has not been simplified." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Textured grid simplified from " << model.getTrianglesNumber(0) << " to " << model.getTrianglesNumber(1) << " triangles." << std::endl;
+
+    /* The grid is flat, hence its levels of detail have no error and the coarsest one is drawn. Texture coordinates are affine in the
+       position on either side of the seam, hence the coarsest level of detail is textured as the original grid if no triangle crosses the seam. */
+    cv::Mat img_original = renderSeamGrid(files, Model::ImportProfile());
+    cv::Mat img_simplified = renderSeamGrid(files, profile);
+
+    cv::imwrite("./test_level_of_detail_seam.png", img_simplified);
+
+    cv::Mat mask;
+    cv::cvtColor(img_original, mask, cv::COLOR_BGR2GRAY);
+    mask = mask > 0;
+
+    cv::Mat img_diff;
+    cv::absdiff(img_original, img_simplified, img_diff);
+    cv::cvtColor(img_diff, img_diff, cv::COLOR_BGR2GRAY);
+
+    const int foreground = cv::countNonZero(mask);
+    const int different = cv::countNonZero(img_diff > 16);
+    if (foreground == 0 || different > foreground / 100)
+    {
+        std::cerr << log_ID << " " << different << " out of " << foreground << " pixels of the simplified textured grid differ from the original one." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Level of detail]";
+    std::cout << log_ID << "This test checks whether levels of detail are coarser and coarser, selected according to the distance and the error threshold, and do not cross texture seams." << std::endl;
+
+    Model::ImportProfile profile;
+    profile.lod_ratios = { 0.5f, 0.25f, 0.1f };
+
+    GLfloat coarsest_error = 0.0f;
+    if (testContext(log_ID, profile, coarsest_error) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1, "__prc/shader", { 1.0, 0.0, 0.0, 0.0 }, profile);
+
+    const std::vector<GLfloat> errors = si_cad.getLevelOfDetailErrors("alien");
+    if (errors.size() != profile.lod_ratios.size() + 1 || errors.back() != coarsest_error)
+    {
+        std::cerr << log_ID << " SICAD reports levels of detail different from the ones of the model." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The allowed error, in model units, is the pixel threshold times distance / focal length. The threshold is such that the
+       coarsest level of detail is selected at the far distance, but not at the near one, where the allowed error is 5 times smaller.
+       Any threshold above the coarsest error at both distances draws the coarsest level of detail. */
+    const double far_distance  = 0.5;
+    const double near_distance = 0.1;
+    const GLfloat threshold = 1.5f * coarsest_error * cam_fy / far_distance;
+    const GLfloat coarsest_threshold = 1000.0f * threshold;
+
+    si_cad.setLevelOfDetailErrorOpt(coarsest_threshold);
+    cv::Mat img_far_coarsest = render(si_cad, far_distance);
+    cv::Mat img_near_coarsest = render(si_cad, near_distance);
+
+    si_cad.setLevelOfDetailErrorOpt(threshold);
+    cv::Mat img_far = render(si_cad, far_distance);
+    cv::Mat img_near = render(si_cad, near_distance);
+
+    cv::imwrite("./test_level_of_detail_far.png", img_far);
+    cv::imwrite("./test_level_of_detail_near.png", img_near);
+
+    if (cv::countNonZero(img_far.reshape(1)) == 0 || cv::norm(img_far, img_far_coarsest, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " The coarsest level of detail is not drawn far from the camera." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (cv::norm(img_near, img_near_coarsest, cv::NORM_INF) == 0)
+    {
+        std::cerr << log_ID << " The coarsest level of detail is drawn close to the camera." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* A zero threshold draws the original model at any distance. */
+    si_cad.setLevelOfDetailErrorOpt(0.0f);
+
+    cv::Mat img_exact = render(si_cad, far_distance);
+
+    cv::imwrite("./test_level_of_detail_exact.png", img_exact);
+
+    if (cv::norm(img_exact, img_far_coarsest, cv::NORM_INF) == 0)
+    {
+        std::cerr << log_ID << " The coarsest level of detail is drawn with a zero error threshold." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (testSeam(log_ID) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    std::cout << log_ID << " Levels of detail are selected according to the distance and the error threshold, and preserve texture seams." << std::endl;
+
+    return EXIT_SUCCESS;
+}
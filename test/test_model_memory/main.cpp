@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <utils.h>
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+std::vector<char> readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Model from memory]";
+    std::cout << log_ID << "This test checks whether a textured mesh model is rendered the same when loaded from memory and from file, also when its texture path is parent-relative." << std::endl;
+
+    /* Files are stored in memory under a directory that does not exist in the filesystem. */
+    std::vector<char> mesh = readFile("./spaceinvader_textured.obj");
+    std::vector<char> material = readFile("./spaceinvader_textured.mtl");
+    std::vector<char> texture = readFile("./spaceinvader_texture.jpg");
+
+    Model::MemoryFileContainer files;
+    files["memory/spaceinvader_textured.obj"] = Model::MemoryFile{ mesh.data(), mesh.size() };
+    files["memory/spaceinvader_textured.mtl"] = Model::MemoryFile{ material.data(), material.size() };
+    files["memory/spaceinvader_texture.jpg"] = Model::MemoryFile{ texture.data(), texture.size() };
+
+    /* The same model in a directory next to the one of its texture, whose material references it as "../texture/./spaceinvader_texture.jpg". */
+    std::string parent_material(material.begin(), material.end());
+    const std::string texture_line = "map_Kd spaceinvader_texture.jpg";
+    parent_material.replace(parent_material.find(texture_line), texture_line.size(), "map_Kd ../texture/./spaceinvader_texture.jpg");
+
+    files["memory/mesh/spaceinvader_textured.obj"] = Model::MemoryFile{ mesh.data(), mesh.size() };
+    files["memory/mesh/spaceinvader_textured.mtl"] = Model::MemoryFile{ parent_material.data(), parent_material.size() };
+    files["memory/texture/spaceinvader_texture.jpg"] = Model::MemoryFile{ texture.data(), texture.size() };
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien_file", "./spaceinvader_textured.obj");
+    obj.emplace("alien_memory", "memory/spaceinvader_textured.obj");
+    obj.emplace("alien_parent", "memory/mesh/spaceinvader_textured.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 3, "__prc/shader", { 1.0, 0.0, 0.0, 0.0 }, Model::ImportProfile(), files);
+
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(3);
+    objposes[0].emplace("alien_file", obj_pose);
+    objposes[1].emplace("alien_memory", obj_pose);
+    objposes[2].emplace("alien_parent", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+
+    si_cad.superimpose(objposes, cam_x, cam_o, img_rendered);
+
+    cv::imwrite("./test_model_memory.png", img_rendered);
+
+    const int tile_width  = img_rendered.cols / si_cad.getTilesCols();
+    const int tile_height = img_rendered.rows / si_cad.getTilesRows();
+
+    cv::Mat img_file   = img_rendered(cv::Rect(0, 0, tile_width, tile_height));
+    cv::Mat img_memory = img_rendered(cv::Rect(tile_width * (1 % si_cad.getTilesCols()), tile_height * (1 / si_cad.getTilesCols()), tile_width, tile_height));
+    cv::Mat img_parent = img_rendered(cv::Rect(tile_width * (2 % si_cad.getTilesCols()), tile_height * (2 / si_cad.getTilesCols()), tile_width, tile_height));
+
+    if (si_cad.getEmptyTiles()[1] || !utils::compareImages(img_memory, img_file))
+    {
+        std::cerr << log_ID << " Mesh models loaded from memory and from file are rendered differently." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (si_cad.getEmptyTiles()[2] || !utils::compareImages(img_parent, img_file))
+    {
+        std::cerr << log_ID << " Mesh model loaded from memory with a parent-relative texture path is rendered differently from file." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Mesh models loaded from memory and from file are rendered the same. Saving rendered image for visual inspection." << std::endl;
+
+    return EXIT_SUCCESS;
+}
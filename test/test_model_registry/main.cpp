@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <utils.h>
+
+#include <exception>
+#include <future>
+#include <iostream>
+#include <string>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Model registry]";
+    std::cout << log_ID << "This test checks whether models can be added, replaced and removed at runtime." << std::endl;
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy);
+
+    SICAD::ModelPathContainer obj_textured;
+    obj_textured.emplace("alien", "./spaceinvader_textured.obj");
+
+    SICAD si_cad_textured(obj_textured, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy);
+
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+
+    /* Replace the model and check that it is swapped in at the next frame only. */
+    std::shared_future<bool> updated = si_cad.updateModel("alien", "./spaceinvader_textured.obj");
+    if (!updated.get())
+    {
+        std::cerr << log_ID << " Failed to load the textured model." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    cv::imwrite("./test_model_registry.png", img_rendered);
+
+    cv::Mat img_ground_truth;
+    si_cad_textured.superimpose(objpose_map, cam_x, cam_o, img_ground_truth);
+
+    if (!utils::compareImages(img_rendered, img_ground_truth))
+    {
+        std::cerr << log_ID << " The replaced model is not rendered as the same model loaded at construction." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+
+    /* Load a missing model. */
+    if (si_cad.updateModel("missing", "./missing.obj").get())
+    {
+        std::cerr << log_ID << " Loading a missing model file succeeded." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+
+    /* Remove the model. */
+    si_cad.removeModel("alien");
+    if (!si_cad.hasModel("alien"))
+    {
+        std::cerr << log_ID << " The model has been removed before the next frame." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    if (si_cad.hasModel("alien") || cv::countNonZero(img_rendered.reshape(1)) != 0)
+    {
+        std::cerr << log_ID << " The model has not been removed." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Models have been correctly added, replaced and removed." << std::endl;
+
+    return EXIT_SUCCESS;
+}
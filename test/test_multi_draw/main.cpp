@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+/* Each grid has 200x200 vertices, i.e. 40000 vertices fitting 16-bit indices, while two grids do not. */
+const int grid_size = 200;
+
+
+/**
+ * Append to `obj` a wavy grid spanning [x_min, x_min + 0.05] x [-0.04, 0.04], as a Wavefront OBJ object whose vertices are numbered from `first_vertex`.
+ */
+void appendGrid(std::ostringstream& obj, const std::string& name, const double x_min, const int first_vertex)
+{
+    obj << "o " << name << "\n";
+
+    for (int j = 0; j < grid_size; ++j)
+    {
+        for (int i = 0; i < grid_size; ++i)
+        {
+            const double x = x_min + 0.05 * i / (grid_size - 1);
+            const double y = -0.04 + 0.08 * j / (grid_size - 1);
+            const double z = 0.005 * std::sin(200.0 * x) * std::cos(200.0 * y);
+
+            /* Normal of the surface z = f(x, y), i.e. (-df/dx, -df/dy, 1) normalized. */
+            const double dx = std::cos(200.0 * x) * std::cos(200.0 * y);
+            const double dy = -std::sin(200.0 * x) * std::sin(200.0 * y);
+            const double norm = std::sqrt(dx * dx + dy * dy + 1.0);
+
+            obj << "v " << x << " " << y << " " << z << "\n";
+            obj << "vn " << -dx / norm << " " << -dy / norm << " " << 1.0 / norm << "\n";
+        }
+    }
+
+    for (int j = 0; j + 1 < grid_size; ++j)
+    {
+        for (int i = 0; i + 1 < grid_size; ++i)
+        {
+            const int a = first_vertex + j * grid_size + i;
+            const int b = a + 1;
+            const int c = a + grid_size;
+            const int d = c + 1;
+
+            obj << "f " << a << "//" << a << " " << b << "//" << b << " " << d << "//" << d << "\n";
+            obj << "f " << a << "//" << a << " " << d << "//" << d << " " << c << "//" << c << "\n";
+        }
+    }
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Multi draw]";
+    std::cout << log_ID << "This test checks whether submeshes packed in a single mesh, and drawn with a multi-draw, render as separate mesh models." << std::endl;
+
+    /* Both grids are packed in a single mesh, whose vertices do not fit 16-bit indices, hence drawn with a single multi-draw.
+       Each grid alone is drawn with a single draw. */
+    std::ostringstream packed_stream;
+    appendGrid(packed_stream, "left", -0.05, 1);
+    appendGrid(packed_stream, "right", 0.0, 1 + grid_size * grid_size);
+
+    std::ostringstream left_stream;
+    appendGrid(left_stream, "left", -0.05, 1);
+
+    std::ostringstream right_stream;
+    appendGrid(right_stream, "right", 0.0, 1);
+
+    /* Mesh models are written next to the executable, then imported as usual. */
+    std::ofstream packed_file("./test_multi_draw_packed.obj");
+    packed_file << packed_stream.str();
+    packed_file.close();
+
+    std::ofstream left_file("./test_multi_draw_left.obj");
+    left_file << left_stream.str();
+    left_file.close();
+
+    std::ofstream right_file("./test_multi_draw_right.obj");
+    right_file << right_stream.str();
+    right_file.close();
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("packed", "./test_multi_draw_packed.obj");
+    obj.emplace("left", "./test_multi_draw_left.obj");
+    obj.emplace("right", "./test_multi_draw_right.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 2);
+
+
+    /* Tilted, so that the grids occlude themselves. */
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 1.0;
+    obj_pose[4] = 0.2;
+    obj_pose[5] = 0;
+    obj_pose[6] = 1.0;
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(2);
+    objposes[0].emplace("packed", obj_pose);
+    objposes[1].emplace("left", obj_pose);
+    objposes[1].emplace("right", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+
+    si_cad.superimpose(objposes, cam_x, cam_o, img_rendered);
+
+    cv::imwrite("./test_multi_draw.png", img_rendered);
+
+    const int tile_width  = img_rendered.cols / si_cad.getTilesCols();
+    const int tile_height = img_rendered.rows / si_cad.getTilesRows();
+
+    cv::Mat img_packed = img_rendered(cv::Rect(0, 0, tile_width, tile_height));
+    cv::Mat img_separate = img_rendered(cv::Rect((1 % si_cad.getTilesCols()) * tile_width, (1 / si_cad.getTilesCols()) * tile_height, tile_width, tile_height));
+
+    if (cv::countNonZero(img_packed.reshape(1)) == 0 || cv::norm(img_packed, img_separate, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " Packed submeshes render differently from separate mesh models." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Packed submeshes render as separate mesh models. Saving rendered images for visual inspection." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Point cloud]";
+    std::cout << log_ID << "This test checks whether organized and compact point clouds match the rendered pixels in camera and world frames." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1);
+
+    /* The model lies in the world origin, the camera is 0.1 m away along the z axis. */
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = 0;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0.1 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    const size_t tile_area = cam_width * cam_height;
+
+    /* Points padded to 16 bytes. */
+    struct PaddedPoint
+    {
+        float x;
+        float y;
+        float z;
+        float padding;
+    };
+
+    for (const SICAD::PointCloudFrame frame : { SICAD::PointCloudFrame::camera, SICAD::PointCloudFrame::world })
+    {
+        if (!si_cad.setPointCloudOpt(true, frame, SICAD::PointCloudFormat::float32))
+        {
+            std::cerr << log_ID << " Failed to enable point clouds." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        cv::Mat img_rendered;
+        si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+        cv::Mat img_gray;
+        cv::cvtColor(img_rendered, img_gray, cv::COLOR_BGR2GRAY);
+        const size_t foreground = cv::countNonZero(img_gray);
+
+        std::vector<PaddedPoint> organized(tile_area);
+        size_t organized_number = 0;
+        if (!si_cad.getPointCloud(0, organized.data(), sizeof(PaddedPoint), false, organized_number) || organized_number != tile_area)
+        {
+            std::cerr << log_ID << " Organized point cloud must have one point per pixel." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        std::vector<PaddedPoint> compact(tile_area);
+        size_t compact_number = 0;
+        if (!si_cad.getPointCloud(0, compact.data(), sizeof(PaddedPoint), true, compact_number) || compact_number != foreground)
+        {
+            std::cerr << log_ID << " Compact point cloud must have one point per foreground pixel." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        size_t valid = 0;
+        for (int v = 0; v < img_gray.rows; ++v)
+        {
+            for (int u = 0; u < img_gray.cols; ++u)
+            {
+                const PaddedPoint& point = organized[v * img_gray.cols + u];
+
+                if (std::isnan(point.x) != (img_gray.at<unsigned char>(v, u) == 0))
+                {
+                    std::cerr << log_ID << " Invalid points do not match the background pixels." << std::endl;
+
+                    return EXIT_FAILURE;
+                }
+
+                if (std::isnan(point.x))
+                    continue;
+
+                const PaddedPoint& compact_point = compact[valid++];
+                if (compact_point.x != point.x || compact_point.y != point.y || compact_point.z != point.z)
+                {
+                    std::cerr << log_ID << " Compact point cloud does not follow the order of the organized one." << std::endl;
+
+                    return EXIT_FAILURE;
+                }
+
+                if (frame == SICAD::PointCloudFrame::world)
+                {
+                    if (std::abs(point.z) > 0.006)
+                    {
+                        std::cerr << log_ID << " World point (" << point.x << ", " << point.y << ", " << point.z << ") lies outside the model." << std::endl;
+
+                        return EXIT_FAILURE;
+                    }
+                }
+                else
+                {
+                    /* The camera looks along the negative z axis. */
+                    const double u_point = cam_cx + cam_fx * point.x / -point.z;
+                    const double v_point = cam_cy - cam_fy * point.y / -point.z;
+
+                    if (std::abs(u_point - (u + 0.5)) > 1.0 || std::abs(v_point - (v + 0.5)) > 1.0)
+                    {
+                        std::cerr << log_ID << " Camera point (" << point.x << ", " << point.y << ", " << point.z << ") does not project onto pixel (" << u << ", " << v << ")." << std::endl;
+
+                        return EXIT_FAILURE;
+                    }
+                }
+            }
+        }
+    }
+
+    /* Half precision points are 6 bytes long. */
+    si_cad.setPointCloudOpt(true, SICAD::PointCloudFrame::camera, SICAD::PointCloudFormat::float16);
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    cv::Mat img_gray;
+    cv::cvtColor(img_rendered, img_gray, cv::COLOR_BGR2GRAY);
+
+    std::vector<unsigned short> half_points(3 * tile_area);
+    size_t half_number = 0;
+    if (!si_cad.getPointCloud(0, half_points.data(), 3 * sizeof(unsigned short), true, half_number) || half_number != static_cast<size_t>(cv::countNonZero(img_gray)))
+    {
+        std::cerr << log_ID << " Half precision compact point cloud must have one point per foreground pixel." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Point clouds match the rendered pixels." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+Superimpose::ModelPoseContainer makeHypothesis(const double x)
+{
+    Superimpose::ModelPose pose(7);
+    pose[0] = x;
+    pose[1] = 0;
+    pose[2] = -0.2;
+    pose[3] = 0;
+    pose[4] = 1.0;
+    pose[5] = 0;
+    pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", pose);
+
+    return objpose_map;
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Render cache]";
+    std::cout << log_ID << "This test checks whether cached and duplicate tiles are reused without changing the result." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 4);
+
+    /* The first batch has a duplicate, the second one reuses three tiles of the first one in a different order. */
+    const std::vector<Superimpose::ModelPoseContainer> batch_first  = { makeHypothesis(0.0), makeHypothesis(0.01), makeHypothesis(0.01), makeHypothesis(0.02) };
+    const std::vector<Superimpose::ModelPoseContainer> batch_second = { makeHypothesis(0.0), makeHypothesis(0.03), makeHypothesis(0.02), makeHypothesis(0.01) };
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_first_reference;
+    si_cad.superimpose(batch_first, cam_x, cam_o, img_first_reference);
+
+    cv::Mat img_second_reference;
+    si_cad.superimpose(batch_second, cam_x, cam_o, img_second_reference);
+
+    si_cad.setRenderCacheOpt(true, 1e-6);
+
+    const std::vector<Superimpose::ModelPoseContainer>* batches[] = { &batch_first, &batch_second };
+    const cv::Mat* references[] = { &img_first_reference, &img_second_reference };
+    const size_t rendered_tiles[] = { 3, 1 };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        cv::Mat img_cached;
+        if (!si_cad.superimpose(*batches[i], cam_x, cam_o, img_cached))
+        {
+            std::cerr << log_ID << " Failed to render with the render cache." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        if (si_cad.getRenderedTilesNumber() != rendered_tiles[i])
+        {
+            std::cerr << log_ID << " Batch " << i << " rendered " << si_cad.getRenderedTilesNumber() << " tiles, expected " << rendered_tiles[i] << "." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        if (img_cached.size() != references[i]->size() || cv::norm(img_cached, *references[i], cv::NORM_INF) != 0)
+        {
+            std::cerr << log_ID << " Batch " << i << " differs from the rendering without cache." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Repeating the batch keeps all the tiles in the framebuffer, also if the caller modified the previous image. */
+    cv::Mat img_repeated;
+    si_cad.superimpose(batch_second, cam_x, cam_o, img_repeated);
+    img_repeated.setTo(cv::Scalar(0, 0, 0));
+
+    si_cad.superimpose(batch_second, cam_x, cam_o, img_repeated);
+
+    if (si_cad.getRenderedTilesNumber() != 0 || cv::norm(img_repeated, img_second_reference, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " Repeating the batch rendered " << si_cad.getRenderedTilesNumber() << " tiles or changed the result." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Rendering a single image overwrites the framebuffer, the cached tiles are then copied from the previous render grid. */
+    cv::Mat img_single;
+    si_cad.superimpose(makeHypothesis(0.04), cam_x, cam_o, img_single);
+
+    cv::Mat img_restored;
+    si_cad.superimpose(batch_second, cam_x, cam_o, img_restored);
+
+    if (si_cad.getRenderedTilesNumber() != 0 || cv::norm(img_restored, img_second_reference, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " The batch rendered after a single image rendered " << si_cad.getRenderedTilesNumber() << " tiles or changed the result." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Moving the camera makes all the tiles dirty. */
+    cam_x[0] = 0.01;
+
+    cv::Mat img_moved;
+    si_cad.superimpose(batch_second, cam_x, cam_o, img_moved);
+
+    if (si_cad.getRenderedTilesNumber() != 4)
+    {
+        std::cerr << log_ID << " Tiles have been reused after moving the camera." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Changing an option affecting the rendering clears the cache. */
+    si_cad.setLevelOfDetailErrorOpt(si_cad.getLevelOfDetailErrorOpt() + 1.0f);
+
+    cv::Mat img_option;
+    si_cad.superimpose(batch_second, cam_x, cam_o, img_option);
+
+    if (si_cad.getRenderedTilesNumber() != 4)
+    {
+        std::cerr << log_ID << " Tiles have been reused after changing the level of detail option." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " The render cache reuses tiles consistently." << std::endl;
+
+    return EXIT_SUCCESS;
+}
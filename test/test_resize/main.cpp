@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Resize]";
+    std::cout << log_ID << "This test checks whether resizing the render grid keeps the rendering consistent." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1);
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.2;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_reference;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_reference);
+
+    /* Grow the grid and shrink the images. */
+    if (!si_cad.resize(4, cam_width / 2, cam_height / 2))
+    {
+        std::cerr << log_ID << " Failed to resize to 4 images of half size." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(si_cad.getTilesNumber(), objpose_map);
+
+    cv::Mat img_grid;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_grid);
+
+    if (si_cad.getTilesNumber() != 4 ||
+        img_grid.cols != static_cast<int>(si_cad.getTilesCols() * cam_width / 2) ||
+        img_grid.rows != static_cast<int>(si_cad.getTilesRows() * cam_height / 2))
+    {
+        std::cerr << log_ID << " Wrong render grid after resizing." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The projection is kept, hence each tile is the reference image at half resolution. */
+    cv::Mat img_half;
+    cv::resize(img_reference, img_half, cv::Size(cam_width / 2, cam_height / 2), 0, 0, cv::INTER_AREA);
+
+    cv::Mat tile_difference;
+    cv::absdiff(img_grid(cv::Rect(0, 0, cam_width / 2, cam_height / 2)), img_half, tile_difference);
+    cv::cvtColor(tile_difference, tile_difference, cv::COLOR_BGR2GRAY);
+    if (cv::countNonZero(tile_difference > 64) > static_cast<int>(cam_width + cam_height))
+    {
+        std::cerr << log_ID << " Tiles do not match the reference image at half resolution." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Shrink back to the original layout, reusing the storage of the attachments. */
+    if (!si_cad.resize(1, cam_width, cam_height))
+    {
+        std::cerr << log_ID << " Failed to resize back to the original layout." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    if (img_rendered.size() != img_reference.size() || cv::norm(img_rendered, img_reference, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " Rendering after resizing back differs from the reference." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (si_cad.resize(0, cam_width, cam_height))
+    {
+        std::cerr << log_ID << " Resizing to no images must fail." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Resizing keeps the rendering consistent." << std::endl;
+
+    return EXIT_SUCCESS;
+}
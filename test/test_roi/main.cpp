@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - ROI]";
+    std::cout << log_ID << "This test checks whether ROI rendering reads back the tight rectangle around the mesh models." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 4);
+
+    /* The last hypothesis is out of the field of view. */
+    const double xs[] = { -0.02, 0.0, 0.03, 0.9 };
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(4);
+    for (size_t k = 0; k < objposes.size(); ++k)
+    {
+        Superimpose::ModelPose pose(7);
+        pose[0] = xs[k];
+        pose[1] = 0;
+        pose[2] = -0.2;
+        pose[3] = 0;
+        pose[4] = 1.0;
+        pose[5] = 0;
+        pose[6] = 0;
+
+        objposes[k].emplace("alien", pose);
+    }
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    const int tiles_cols = si_cad.getTilesCols();
+
+    cv::Mat img_full;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_full);
+
+    si_cad.setRoiOpt(true);
+
+    cv::Mat img_atlas;
+    if (!si_cad.superimpose(objposes, cam_x, cam_o, img_atlas))
+    {
+        std::cerr << log_ID << " Failed to render the ROIs." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<cv::Rect> rois = si_cad.getRois();
+    const std::vector<cv::Rect> atlas = si_cad.getRoiAtlas();
+    const std::vector<cv::Mat> roi_images = si_cad.getRoiImages();
+
+    if (rois.size() != objposes.size() || atlas.size() != objposes.size() || roi_images.size() != objposes.size() || rois[3].area() != 0 || !roi_images[3].empty())
+    {
+        std::cerr << log_ID << " Wrong ROIs." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    for (size_t k = 0; k < 3; ++k)
+    {
+        const cv::Rect tile((k % tiles_cols) * cam_width, (k / tiles_cols) * cam_height, cam_width, cam_height);
+        const cv::Mat img_tile = img_full(tile);
+
+        if (rois[k].area() == 0 || rois[k].area() > static_cast<int>(cam_width * cam_height) / 4 || atlas[k].size() != rois[k].size())
+        {
+            std::cerr << log_ID << " ROI " << k << " is not tight." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        /* The ROI matches the full rendering, and encloses all the pixels of the mesh model. */
+        if (cv::norm(img_atlas(atlas[k]), img_tile(rois[k]), cv::NORM_INF) != 0 || roi_images[k].data != img_atlas(atlas[k]).data)
+        {
+            std::cerr << log_ID << " ROI " << k << " does not match the full rendering." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        cv::Mat tile_gray;
+        cv::cvtColor(img_tile, tile_gray, cv::COLOR_BGR2GRAY);
+        if (cv::countNonZero(tile_gray) != cv::countNonZero(tile_gray(rois[k])))
+        {
+            std::cerr << log_ID << " ROI " << k << " does not enclose the mesh model." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Single-tile rendering returns the ROI of the tile. */
+    cv::Mat img_roi;
+    si_cad.superimpose(objposes[0], cam_x, cam_o, img_roi);
+
+    if (si_cad.getRois().size() != 1 || img_roi.size() != rois[0].size() ||
+        cv::norm(img_roi, img_full(cv::Rect(0, 0, cam_width, cam_height))(rois[0]), cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " Single-tile ROI does not match the full rendering." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Without packing, the ROIs stay in their tiles and the pixels outside them, that are background, are 0. */
+    si_cad.setRoiPackingOpt(false);
+
+    cv::Mat img_unpacked;
+    if (!si_cad.superimpose(objposes, cam_x, cam_o, img_unpacked) || img_unpacked.size() != img_full.size() ||
+        cv::norm(img_unpacked, img_full, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " ROIs rendered without packing do not match the full rendering." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    for (size_t k = 0; k < 3; ++k)
+    {
+        const cv::Rect roi_in_image = si_cad.getRois()[k] + cv::Point((k % tiles_cols) * cam_width, (k / tiles_cols) * cam_height);
+
+        if (si_cad.getRoiAtlas()[k] != roi_in_image || si_cad.getRoiImages()[k].data != img_unpacked(roi_in_image).data)
+        {
+            std::cerr << log_ID << " ROI " << k << " is not in place without packing." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << log_ID << " ROIs are tight and match the full rendering." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <SuperimposeMesh/SICAD.h>
+#include <SuperimposeMesh/Shader.h>
+
+
+const std::string vertex_shader_path = "__prc/shader/shader_model.vert";
+
+const std::string fragment_shader_path = "__prc/shader/shader_model.frag";
+
+
+bool isFallback(Shader& shader)
+{
+    /* Programs compiled from source are valid and not cached, and the cache file is written again. */
+    return !shader.is_cached() && shader.get_program() != 0 && shader.is_attribute_active(0) &&
+           std::ifstream(shader.get_binary_cache_file(), std::ios::binary).is_open();
+}
+
+
+int testCacheFiles(const std::string& log_ID)
+{
+    std::string cache_file = Shader(vertex_shader_path, fragment_shader_path).get_binary_cache_file();
+    if (cache_file.empty())
+    {
+        std::cout << log_ID << " The program binary cache is not supported by the OpenGL context, cache files are not checked." << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    /* Files left by previous runs are removed, so that the program is compiled and then cached. */
+    std::remove(cache_file.c_str());
+
+    Shader compiled(vertex_shader_path, fragment_shader_path);
+    if (!isFallback(compiled))
+    {
+        std::cerr << log_ID << " Program not compiled and cached in " << cache_file << "." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    Shader cached(vertex_shader_path, fragment_shader_path);
+    if (!cached.is_cached() || cached.get_binary_cache_file() != cache_file ||
+        cached.is_attribute_active(0) != compiled.is_attribute_active(0) ||
+        cached.is_attribute_active(1) != compiled.is_attribute_active(1) ||
+        cached.is_attribute_active(2) != compiled.is_attribute_active(2))
+    {
+        std::cerr << log_ID << " Program not loaded from " << cache_file << " as it was compiled." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* A corrupt binary, e.g. written by another driver, is rejected by the driver. */
+    {
+        std::ofstream file(cache_file, std::ios::binary | std::ios::trunc);
+        const GLenum format = 0;
+        file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+        file << "corrupt program binary";
+    }
+
+    Shader corrupt(vertex_shader_path, fragment_shader_path);
+    if (!isFallback(corrupt))
+    {
+        std::cerr << log_ID << " Program not compiled from source with a corrupt cache file." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* A truncated binary, e.g. written by a process being killed, is not even passed to the driver. */
+    {
+        std::ofstream file(cache_file, std::ios::binary | std::ios::trunc);
+        file << 'x';
+    }
+
+    Shader truncated(vertex_shader_path, fragment_shader_path);
+    if (!isFallback(truncated))
+    {
+        std::cerr << log_ID << " Program not compiled from source with a truncated cache file." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (!Shader(vertex_shader_path, fragment_shader_path).is_cached())
+    {
+        std::cerr << log_ID << " Program not loaded from the cache file written again." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int testContext(const std::string& log_ID)
+{
+    if (glfwInit() == GL_FALSE)
+    {
+        std::cerr << log_ID << " Failed to initialize GLFW." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Same context as the one created by SICAD. */
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(1, 1, "OpenGL window", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cerr << log_ID << " Failed to create the OpenGL context." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+        std::cerr << log_ID << " Failed to initialize GLEW." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    int result = testCacheFiles(log_ID);
+
+    glfwMakeContextCurrent(nullptr);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    return result;
+}
+
+
+cv::Mat render()
+{
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader_textured.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1);
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objpose_map, cam_x, cam_o, img_rendered);
+
+    return img_rendered;
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Shader binary cache]";
+    std::cout << log_ID << "This test checks whether cached shader programs render as compiled ones, and corrupt cache files fall back to compiling." << std::endl;
+
+    Shader::set_binary_cache_folder("./test_shader_binary_cache");
+
+    if (testContext(log_ID) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    /* Render with programs compiled from source, with programs possibly compiled and cached, then with programs loaded from the cache. */
+    Shader::set_binary_cache_folder("");
+    cv::Mat img_compiled = render();
+
+    Shader::set_binary_cache_folder("./test_shader_binary_cache");
+    cv::Mat img_first = render();
+    cv::Mat img_cached = render();
+
+    cv::imwrite("./test_shader_binary_cache.png", img_cached);
+
+    if (cv::countNonZero(img_compiled.reshape(1)) == 0 ||
+        cv::norm(img_compiled, img_first, cv::NORM_INF) != 0 || cv::norm(img_compiled, img_cached, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " Cached shader programs render differently from compiled ones." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Cached shader programs render as compiled ones." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <array>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <SuperimposeMesh/Shader.h>
+
+
+int testVariants(const std::string& log_ID, ShaderVariants& variants)
+{
+    /* All the variants must compile, i.e. every color or depth output with any set of additional outputs, either with the model uniform
+       or with the per-instance model matrix, and rendering to a single layer or to a layer of a layered framebuffer.
+       Instanced and layered variants are checked without and with all the additional outputs, to keep the number of programs low. */
+    const std::vector<std::string> outputs = { "", "DEPTH_ONLY", "SILHOUETTE", "ID", "TEXTURED" };
+    const std::vector<std::string> additional_outputs = { "INSTANCE_ID", "CORRESPONDENCE", "POINT_CLOUD" };
+    const std::vector<std::vector<std::string>> vertex_defines = { { }, { "INSTANCED" }, { "LAYERED" }, { "INSTANCED", "LAYERED" } };
+
+    const unsigned int all_additional_outputs = (1u << additional_outputs.size()) - 1;
+
+    for (const std::vector<std::string>& vertex_define : vertex_defines)
+    {
+        for (const std::string& output : outputs)
+        {
+            for (unsigned int mask = 0; mask <= all_additional_outputs; ++mask)
+            {
+                if (!vertex_define.empty() && mask != 0 && mask != all_additional_outputs)
+                    continue;
+
+                std::vector<std::string> defines(vertex_define);
+                if (!output.empty())
+                    defines.push_back(output);
+
+                for (size_t i = 0; i < additional_outputs.size(); ++i)
+                {
+                    if (mask & (1u << i))
+                        defines.push_back(additional_outputs[i]);
+                }
+
+                try
+                {
+                    variants.get(defines);
+                }
+                catch (const std::runtime_error& e)
+                {
+                    std::cerr << log_ID << " Variant " << output << " (additional outputs mask " << mask << ", " << vertex_define.size() << " vertex defines) does not compile.\n" << e.what() << std::endl;
+
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    /* Variants are cached regardless of the order of the defines. */
+    Shader& textured_id = variants.get({ "TEXTURED", "INSTANCE_ID" });
+    Shader& id_textured = variants.get({ "INSTANCE_ID", "TEXTURED" });
+    if (&textured_id != &id_textured)
+    {
+        std::cerr << log_ID << " The same defines in a different order compiled a different variant." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    Shader& textured = variants.get({ "TEXTURED" });
+    Shader& untextured = variants.get({ });
+    Shader& depth = variants.get({ "DEPTH_ONLY" });
+    if (textured.get_program() == untextured.get_program() || textured.get_program() == depth.get_program() || untextured.get_program() == depth.get_program())
+    {
+        std::cerr << log_ID << " Different defines returned the same shader program." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Only the textured variants read the texture coordinates. */
+    if (!textured.is_attribute_active(2) || untextured.is_attribute_active(2) || depth.is_attribute_active(2))
+    {
+        std::cerr << log_ID << " The texture coordinates are not read by the textured variant only." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Only the instanced variants read the per-instance model matrix. */
+    if (!variants.get({ "INSTANCED" }).is_attribute_active(3) || untextured.is_attribute_active(3))
+    {
+        std::cerr << log_ID << " The per-instance model matrix is not read by the instanced variant only." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Only the variants writing object IDs have the object_id uniform. */
+    if (glGetUniformLocation(textured_id.get_program(), "object_id") == -1 || glGetUniformLocation(textured.get_program(), "object_id") != -1)
+    {
+        std::cerr << log_ID << " The object_id uniform is not declared by the INSTANCE_ID variant only." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * Render two instances of a triangle, left and right of the center of a 2-layer framebuffer, by means of the variant specialized by `defines`.
+ * Returns, for each layer and for the left, center and right of the framebuffer, whether the pixel is drawn.
+ */
+std::vector<std::array<bool, 3>> renderInstances(ShaderVariants& variants, const std::vector<std::string>& defines, const GLint layer)
+{
+    const GLsizei width = 64;
+    const GLsizei height = 32;
+    const GLsizei layers = 2;
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    /* A layered attachment, where variants that are not layered render to layer 0. */
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture, 0);
+
+    /* A triangle around the origin, and the column-major model matrices of the instances translating it left and right. */
+    const GLfloat vertices[] = { -0.2f, -0.4f, 0.0f,   0.2f, -0.4f, 0.0f,   0.0f, 0.4f, 0.0f };
+
+    GLfloat instance_models[2][16] = { };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        instance_models[i][0] = instance_models[i][5] = instance_models[i][10] = instance_models[i][15] = 1.0f;
+        instance_models[i][12] = i == 0 ? -0.5f : 0.5f;
+    }
+
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    GLuint vbo[2];
+    glGenBuffers(2, vbo);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
+
+    /* A mat4 attribute takes 4 consecutive locations, one per column, advancing once per instance. */
+    glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(instance_models), instance_models, GL_STATIC_DRAW);
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        glEnableVertexAttribArray(3 + column);
+        glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(GLfloat), (GLvoid*)(4 * column * sizeof(GLfloat)));
+        glVertexAttribDivisor(3 + column, 1);
+    }
+
+    /* Without the per-instance model matrix, both instances are drawn by the model uniform on the right. */
+    const GLfloat identity[16] = { 1.0f, 0.0f, 0.0f, 0.0f,   0.0f, 1.0f, 0.0f, 0.0f,   0.0f, 0.0f, 1.0f, 0.0f,   0.0f, 0.0f, 0.0f, 1.0f };
+
+    Shader& shader = variants.get(defines);
+    shader.install();
+    glUniformMatrix4fv(glGetUniformLocation(shader.get_program(), "model"), 1, GL_FALSE, instance_models[1]);
+    glUniformMatrix4fv(glGetUniformLocation(shader.get_program(), "view"), 1, GL_FALSE, identity);
+    glUniformMatrix4fv(glGetUniformLocation(shader.get_program(), "projection"), 1, GL_FALSE, identity);
+    glUniform1i(glGetUniformLocation(shader.get_program(), "layer"), layer);
+
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 3, 2);
+
+    shader.uninstall();
+
+    std::vector<GLubyte> pixels(width * height * layers * 4);
+    glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    glBindVertexArray(0);
+    glDeleteBuffers(2, vbo);
+    glDeleteVertexArrays(1, &vao);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glDeleteTextures(1, &texture);
+
+    /* Drawn pixels are opaque, while the framebuffer is cleared to transparent. */
+    std::vector<std::array<bool, 3>> drawn(layers);
+    for (GLsizei l = 0; l < layers; ++l)
+    {
+        for (size_t x = 0; x < 3; ++x)
+        {
+            const size_t column = width / 4 * (x + 1);
+            drawn[l][x] = pixels[((l * height + height / 2) * width + column) * 4 + 3] != 0;
+        }
+    }
+
+    return drawn;
+}
+
+
+int testRendering(const std::string& log_ID, ShaderVariants& variants)
+{
+    typedef std::vector<std::array<bool, 3>> Layers;
+
+    const std::array<bool, 3> left_right = { { true, false, true } };
+    const std::array<bool, 3> left = { { true, false, false } };
+    const std::array<bool, 3> right = { { false, false, true } };
+    const std::array<bool, 3> none = { { false, false, false } };
+
+    /* Instances are drawn where their own model matrix places them. */
+    if (renderInstances(variants, { "INSTANCED" }, 0) != Layers({ left_right, none }))
+    {
+        std::cerr << log_ID << " The instanced variant does not draw the instances with their model matrices." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (renderInstances(variants, { }, 0) != Layers({ right, none }))
+    {
+        std::cerr << log_ID << " The variant that is not instanced does not draw the instances with the model uniform." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Layered variants render to the layer selected by the layer uniform, plus the instance index if instanced. */
+    if (renderInstances(variants, { "LAYERED" }, 1) != Layers({ none, right }))
+    {
+        std::cerr << log_ID << " The layered variant does not render to the selected layer." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (renderInstances(variants, { "INSTANCED", "LAYERED" }, 0) != Layers({ left, right }))
+    {
+        std::cerr << log_ID << " The instanced layered variant does not render each instance to its own layer." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Shader variants]";
+    std::cout << log_ID << "This test checks whether the variants of the mesh model shader compile, are cached by their defines, and draw instanced and layered geometry." << std::endl;
+
+    if (glfwInit() == GL_FALSE)
+    {
+        std::cerr << log_ID << " Failed to initialize GLFW." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Same context as the one created by SICAD. */
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(1, 1, "OpenGL window", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cerr << log_ID << " Failed to create the OpenGL context." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+        std::cerr << log_ID << " Failed to initialize GLEW." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_FAILURE;
+    {
+        ShaderVariants variants("__prc/shader/shader_mesh.vert", "__prc/shader/shader_mesh.frag", "__prc/shader/shader_mesh.geom", "LAYERED");
+
+        result = testVariants(log_ID, variants);
+
+        if (result == EXIT_SUCCESS)
+            result = testRendering(log_ID, variants);
+    }
+
+    glfwMakeContextCurrent(nullptr);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    if (result != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    std::cout << log_ID << " Shader variants are compiled, cached and draw instanced and layered geometry." << std::endl;
+
+    return EXIT_SUCCESS;
+}
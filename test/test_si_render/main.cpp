@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "DatasetWriter.h"
+#include "PoseStream.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+
+bool writeFile(const std::string& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+
+    return file.good();
+}
+
+
+std::vector<unsigned char> readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+
+void appendImage(const cv::Mat& image, std::vector<unsigned char>& data)
+{
+    for (int y = 0; y < image.rows; ++y)
+        data.insert(data.end(), image.ptr<unsigned char>(y), image.ptr<unsigned char>(y) + image.cols * image.elemSize());
+}
+
+
+int testPoseStream(const std::string& log_ID)
+{
+    /* Frames with no mesh model hold the camera pose only, i.e. 7 values. */
+    const std::vector<double> frame_first  = { 0.1, 0.2, 0.3, 0.0, 1.0, 0.0, 0.5 };
+    const std::vector<double> frame_second = { -1.0, 2.5, 1e-3, 1.0, 0.0, 0.0, 3.0 };
+
+    /* Binary files must be made of whole frames. */
+    const std::string binary_path = "./test_si_render_poses.bin";
+    {
+        std::string content;
+        content.append(reinterpret_cast<const char*>(frame_first.data()), frame_first.size() * sizeof(double));
+        content.append(reinterpret_cast<const char*>(frame_second.data()), frame_second.size() * sizeof(double));
+        writeFile(binary_path, content);
+
+        PoseStream poses(binary_path, PoseStream::Format::binary, 0);
+
+        std::vector<double> frame;
+        if (poses.size() != 2 || !poses.getFrame(1, frame) || frame != frame_second || poses.getFrame(2, frame))
+        {
+            std::cerr << log_ID << " Binary frames are not read back." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        writeFile(binary_path, content + "truncated");
+
+        bool thrown = false;
+        try
+        {
+            PoseStream truncated(binary_path, PoseStream::Format::binary, 0);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        if (!thrown)
+        {
+            std::cerr << log_ID << " A binary file not made of whole frames has been accepted." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+    std::remove(binary_path.c_str());
+
+    /* Comments, blank lines and CRLF line endings are skipped, values are separated by commas or white spaces. */
+    const std::string csv_path = "./test_si_render_poses.csv";
+    {
+        writeFile(csv_path, "# x, y, z, ux, uy, uz, theta\r\n"
+                            "\r\n"
+                            "0.1, 0.2, 0.3, 0, 1, 0, 0.5\r\n"
+                            "   \n"
+                            "  # indented comment\n"
+                            "-1.0 2.5\t1e-3,1,0,0,3\r\n"
+                            "1, 2, 3\n"
+                            "1, 2, 3, 4, 5, 6, 7, 8");
+
+        PoseStream poses(csv_path, PoseStream::Format::csv, 0);
+
+        if (poses.size() != 4)
+        {
+            std::cerr << log_ID << " The CSV file has " << poses.size() << " frames instead of 4." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        std::vector<double> frame;
+        if (!poses.getFrame(0, frame) || frame != frame_first || !poses.getFrame(1, frame) || frame != frame_second)
+        {
+            std::cerr << log_ID << " CSV frames are not parsed." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        if (poses.getFrame(2, frame) || poses.getFrame(3, frame))
+        {
+            std::cerr << log_ID << " CSV lines with the wrong number of columns have been accepted." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+    std::remove(csv_path.c_str());
+
+    return EXIT_SUCCESS;
+}
+
+
+int testDatasetWriter(const std::string& log_ID)
+{
+    const cv::Size size(4, 3);
+    const size_t frames_number = 3;
+    const double depth_scale = 1000.0;
+
+    DatasetWriter::Outputs outputs;
+    outputs.color = true;
+    outputs.depth = true;
+    outputs.mask = true;
+
+    /* Frames are regions of larger images, as the tiles of a rendered batch. */
+    cv::Mat color_tiles(size.height, size.width * static_cast<int>(frames_number), CV_8UC3);
+    cv::Mat depth_tiles(size.height, size.width * static_cast<int>(frames_number), CV_32FC1);
+    cv::Mat mask_tiles(size.height, size.width * static_cast<int>(frames_number), CV_16UC1);
+    cv::randu(color_tiles, 0, 256);
+    cv::randu(depth_tiles, 0.0f, 2.0f);
+    cv::randu(mask_tiles, 0, 1000);
+
+    /* Depth is stored with 1 / depth_scale meters resolution in the images layout. */
+    depth_tiles.convertTo(depth_tiles, CV_16U, depth_scale);
+    depth_tiles.convertTo(depth_tiles, CV_32F, 1.0 / depth_scale);
+
+    const auto tile = [size](const size_t frame)
+    {
+        return cv::Rect(size.width * static_cast<int>(frame), 0, size.width, size.height);
+    };
+
+    /* Two frames per chunk, so that the last chunk is partial. */
+    const std::string chunked_folder = "./test_si_render_chunked";
+    {
+        DatasetWriter writer(chunked_folder, DatasetWriter::Layout::chunked, outputs, size, 2, depth_scale, 2);
+
+        for (size_t i = 0; i < frames_number; ++i)
+            writer.write(color_tiles(tile(i)), depth_tiles(tile(i)), mask_tiles(tile(i)));
+
+        if (!writer.finish() || writer.getFramesNumber() != frames_number)
+        {
+            std::cerr << log_ID << " Failed to write the chunked dataset." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    const std::vector<std::string> chunks = { chunked_folder + "/chunk_000000.bin", chunked_folder + "/chunk_000001.bin" };
+    for (size_t c = 0; c < chunks.size(); ++c)
+    {
+        std::vector<unsigned char> expected;
+        for (size_t i = 2 * c; i < std::min<size_t>(2 * c + 2, frames_number); ++i)
+        {
+            appendImage(color_tiles(tile(i)), expected);
+            appendImage(depth_tiles(tile(i)), expected);
+            appendImage(mask_tiles(tile(i)), expected);
+        }
+
+        if (readFile(chunks[c]) != expected)
+        {
+            std::cerr << log_ID << " Chunk " << c << " does not store the written frames." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        std::remove(chunks[c].c_str());
+    }
+    std::remove((chunked_folder + "/dataset.txt").c_str());
+    std::remove(chunked_folder.c_str());
+
+    const std::string images_folder = "./test_si_render_images";
+    {
+        DatasetWriter writer(images_folder, DatasetWriter::Layout::images, outputs, size, 2, depth_scale, 2);
+
+        for (size_t i = 0; i < frames_number; ++i)
+            writer.write(color_tiles(tile(i)), depth_tiles(tile(i)), mask_tiles(tile(i)));
+
+        if (!writer.finish())
+        {
+            std::cerr << log_ID << " Failed to write the image dataset." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (size_t i = 0; i < frames_number; ++i)
+    {
+        const std::string index = "_00000" + std::to_string(i) + ".png";
+        const std::string color_path = images_folder + "/color" + index;
+        const std::string depth_path = images_folder + "/depth" + index;
+        const std::string mask_path = images_folder + "/mask" + index;
+
+        const cv::Mat color = cv::imread(color_path, cv::IMREAD_UNCHANGED);
+        const cv::Mat depth = cv::imread(depth_path, cv::IMREAD_UNCHANGED);
+        const cv::Mat mask = cv::imread(mask_path, cv::IMREAD_UNCHANGED);
+
+        cv::Mat depth_expected;
+        depth_tiles(tile(i)).convertTo(depth_expected, CV_16U, depth_scale);
+
+        if (color.size() != size || depth.size() != size || mask.size() != size ||
+            cv::norm(color, color_tiles(tile(i)), cv::NORM_INF) != 0 ||
+            cv::norm(depth, depth_expected, cv::NORM_INF) != 0 ||
+            cv::norm(mask, mask_tiles(tile(i)), cv::NORM_INF) != 0)
+        {
+            std::cerr << log_ID << " The images of frame " << i << " do not store the written frame." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        std::remove(color_path.c_str());
+        std::remove(depth_path.c_str());
+        std::remove(mask_path.c_str());
+    }
+    std::remove((images_folder + "/dataset.txt").c_str());
+    std::remove(images_folder.c_str());
+
+    return EXIT_SUCCESS;
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - si-render]";
+    std::cout << log_ID << "This test checks whether pose streams are parsed and datasets are written back as rendered." << std::endl;
+
+    if (testPoseStream(log_ID) != EXIT_SUCCESS || testDatasetWriter(log_ID) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    std::cout << log_ID << " Pose streams and datasets are consistent." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Static scene]";
+    std::cout << log_ID << "This test checks whether the cached static scene composites as drawing it in every tile." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 4);
+
+    /* The static model lies behind the dynamic ones, that partially occlude it. */
+    Superimpose::ModelPose static_pose(7);
+    static_pose[0] = -0.03;
+    static_pose[1] = 0;
+    static_pose[2] = -0.3;
+    static_pose[3] = 0;
+    static_pose[4] = 1.0;
+    static_pose[5] = 0;
+    static_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer static_objpose_map;
+    static_objpose_map.emplace("alien", static_pose);
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(si_cad.getTilesNumber());
+    std::vector<Superimpose::ModelPoseContainer> objposes_reference(si_cad.getTilesNumber());
+    for (size_t k = 0; k < objposes.size(); ++k)
+    {
+        Superimpose::ModelPose pose(static_pose);
+        pose[0] = 0.01 * k;
+        pose[2] = -0.2;
+
+        objposes[k].emplace("alien", pose);
+
+        objposes_reference[k] = objposes[k];
+        objposes_reference[k].emplace("alien", static_pose);
+    }
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    /* The second camera position checks that the cache is invalidated when the camera moves. */
+    const double cam_xs[][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0.01, 0, 0 } };
+
+    for (const auto& cam_position : cam_xs)
+    {
+        cam_x[0] = cam_position[0];
+        cam_x[1] = cam_position[1];
+        cam_x[2] = cam_position[2];
+
+        si_cad.setStaticModels(Superimpose::ModelPoseContainer());
+
+        cv::Mat img_reference;
+        si_cad.superimpose(objposes_reference, cam_x, cam_o, img_reference);
+
+        si_cad.setStaticModels(static_objpose_map);
+
+        /* Render twice, filling the cache and then using it. */
+        for (int i = 0; i < 2; ++i)
+        {
+            cv::Mat img_static;
+            if (!si_cad.superimpose(objposes, cam_x, cam_o, img_static))
+            {
+                std::cerr << log_ID << " Failed to render with the static scene." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+
+            if (cv::norm(img_static, img_reference, cv::NORM_INF) != 0)
+            {
+                std::cerr << log_ID << " Rendering with the static scene differs from drawing it in every tile." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    /* Single-tile rendering composites the static scene as well. */
+    cv::Mat img_reference;
+    si_cad.setStaticModels(Superimpose::ModelPoseContainer());
+    si_cad.superimpose(objposes_reference[1], cam_x, cam_o, img_reference);
+
+    cv::Mat img_static;
+    si_cad.setStaticModels(static_objpose_map);
+    si_cad.superimpose(objposes[1], cam_x, cam_o, img_static);
+
+    if (cv::norm(img_static, img_reference, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " Single-tile rendering with the static scene differs from drawing it." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " The static scene composites correctly." << std::endl;
+
+    return EXIT_SUCCESS;
+}
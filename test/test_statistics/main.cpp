@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Statistics]";
+    std::cout << log_ID << "This test checks whether statistics reduced on the GPU match the visible pixels of each model." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 2);
+
+    if (!si_cad.setStatisticsOpt(true))
+    {
+        std::cerr << log_ID << " Failed to enable statistics." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (!si_cad.setInstanceIdOpt(true))
+    {
+        std::cerr << log_ID << " Failed to enable instance IDs." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The front model partially occludes the back one. */
+    Superimpose::ModelPose front_pose(7);
+    front_pose[0] = 0;
+    front_pose[1] = 0;
+    front_pose[2] = -0.2;
+    front_pose[3] = 0;
+    front_pose[4] = 1.0;
+    front_pose[5] = 0;
+    front_pose[6] = 0;
+
+    Superimpose::ModelPose back_pose(front_pose);
+    back_pose[0] = 0.04;
+    back_pose[2] = -0.3;
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(2);
+    objposes[0].emplace("alien", front_pose);
+    objposes[0].emplace("alien", back_pose);
+    objposes[1].emplace("alien", back_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    cv::Mat img_rendered;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_rendered);
+
+    const std::vector<std::vector<SICAD::ObjectStatistics>> statistics = si_cad.getStatistics();
+    const std::vector<std::vector<size_t>>& counts = si_cad.getInstancePixelCounts();
+    const cv::Mat& img_ids = si_cad.getInstanceIdImage();
+
+    if (statistics.size() != 2 || statistics[0].size() != 2 || statistics[1].size() != 1)
+    {
+        std::cerr << log_ID << " Wrong number of statistics." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    const int tile_width  = img_rendered.cols / si_cad.getTilesCols();
+    const int tile_height = img_rendered.rows / si_cad.getTilesRows();
+
+    for (size_t tile = 0; tile < statistics.size(); ++tile)
+    {
+        cv::Mat tile_ids = img_ids(cv::Rect(tile_width * (tile % si_cad.getTilesCols()), tile_height * (tile / si_cad.getTilesCols()), tile_width, tile_height));
+
+        for (size_t object = 0; object < statistics[tile].size(); ++object)
+        {
+            const SICAD::ObjectStatistics& object_statistics = statistics[tile][object];
+            const size_t id = object + 1;
+
+            /* Statistics count the same pixels of the instance IDs. */
+            if (id >= counts[tile].size() || object_statistics.visible_pixels != counts[tile][id] || object_statistics.visible_pixels == 0)
+            {
+                std::cerr << log_ID << " Object " << object << " of tile " << tile << " has " << object_statistics.visible_pixels << " visible pixels"
+                          << " instead of " << (id < counts[tile].size() ? counts[tile][id] : 0) << "." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+
+            /* The bounding box is the one of the visible pixels. */
+            cv::Mat mask_ids;
+            cv::compare(tile_ids, cv::Mat(tile_ids.size(), CV_16UC1, cv::Scalar(static_cast<double>(id))), mask_ids, cv::CMP_EQ);
+
+            if (object_statistics.bounding_box != cv::boundingRect(mask_ids))
+            {
+                std::cerr << log_ID << " Bounding box of object " << object << " of tile " << tile << " is " << object_statistics.bounding_box
+                          << " instead of " << cv::boundingRect(mask_ids) << "." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    /* The back model is partially occluded in the first tile only. */
+    if (statistics[0][1].visible_pixels >= statistics[1][0].visible_pixels)
+    {
+        std::cerr << log_ID << " Occlusion is not accounted for." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Statistics are measured without reading back the images. */
+    si_cad.setReadbackOpt(false);
+
+    cv::Mat img_not_read;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_not_read);
+
+    if (!img_not_read.empty())
+    {
+        std::cerr << log_ID << " Image read back while readback is disabled." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<std::vector<SICAD::ObjectStatistics>>& statistics_not_read = si_cad.getStatistics();
+    for (size_t tile = 0; tile < statistics.size(); ++tile)
+    {
+        for (size_t object = 0; object < statistics[tile].size(); ++object)
+        {
+            if (statistics_not_read[tile][object].visible_pixels != statistics[tile][object].visible_pixels)
+            {
+                std::cerr << log_ID << " Statistics changed without readback." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    /* Depth ranges are the ones of the visible pixels. */
+    if (!si_cad.setRenderModeOpt(SICAD::RenderMode::depth))
+    {
+        std::cerr << log_ID << " Failed to render depth." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    si_cad.setReadbackOpt(true);
+
+    cv::Mat img_depth;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_depth);
+
+    const std::vector<std::vector<SICAD::ObjectStatistics>>& statistics_depth = si_cad.getStatistics();
+    const cv::Mat& img_depth_ids = si_cad.getInstanceIdImage();
+
+    for (size_t tile = 0; tile < statistics_depth.size(); ++tile)
+    {
+        const cv::Rect tile_rect(tile_width * (tile % si_cad.getTilesCols()), tile_height * (tile / si_cad.getTilesCols()), tile_width, tile_height);
+        cv::Mat tile_ids = img_depth_ids(tile_rect);
+        cv::Mat tile_depth = img_depth(tile_rect);
+
+        for (size_t object = 0; object < statistics_depth[tile].size(); ++object)
+        {
+            cv::Mat mask_ids;
+            cv::compare(tile_ids, cv::Mat(tile_ids.size(), CV_16UC1, cv::Scalar(static_cast<double>(object + 1))), mask_ids, cv::CMP_EQ);
+
+            double min_depth;
+            double max_depth;
+            cv::minMaxLoc(tile_depth, &min_depth, &max_depth, nullptr, nullptr, mask_ids);
+
+            const SICAD::ObjectStatistics& object_statistics = statistics_depth[tile][object];
+            if (std::abs(object_statistics.min_depth - min_depth) > 1e-4 || std::abs(object_statistics.max_depth - max_depth) > 1e-4)
+            {
+                std::cerr << log_ID << " Depth range of object " << object << " of tile " << tile << " is [" << object_statistics.min_depth << ", " << object_statistics.max_depth << "]"
+                          << " instead of [" << min_depth << ", " << max_depth << "]." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    /* Statistics are measured without instance IDs, for batches rendered in more passes than the render grid. */
+    if (!si_cad.setInstanceIdOpt(false))
+    {
+        std::cerr << log_ID << " Failed to disable instance IDs." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Superimpose::ModelPoseContainer> objposes_passes(objposes);
+    for (int i = 0; i < si_cad.getTilesNumber(); ++i)
+        objposes_passes.push_back(objposes[1]);
+
+    cv::Mat img_passes;
+    si_cad.superimpose(objposes_passes, cam_x, cam_o, img_passes);
+
+    const std::vector<std::vector<SICAD::ObjectStatistics>>& statistics_passes = si_cad.getStatistics();
+    if (statistics_passes.size() != objposes_passes.size())
+    {
+        std::cerr << log_ID << " Wrong number of statistics for the batch rendered in passes." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    for (size_t tile = 0; tile < statistics_passes.size(); ++tile)
+    {
+        for (size_t object = 0; object < statistics_passes[tile].size(); ++object)
+        {
+            const SICAD::ObjectStatistics& expected = tile < statistics.size() ? statistics[tile][object] : statistics[1][0];
+
+            if (statistics_passes[tile][object].visible_pixels != expected.visible_pixels || statistics_passes[tile][object].bounding_box != expected.bounding_box)
+            {
+                std::cerr << log_ID << " Statistics of object " << object << " of tile " << tile << " changed when rendering in passes." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    std::cout << log_ID << " Statistics match the visible pixels of each model." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <SuperimposeMesh/SICAD.h>
+#include <SuperimposeMesh/TemplateLibrary.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Template library]";
+    std::cout << log_ID << "This test checks whether templates are stored, mapped and retrieved by nearest orientation." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 4);
+
+    /* The number of templates is not a multiple of the number of tiles, so that the last batch is partial. */
+    const size_t orientations_num = 25;
+    const std::vector<double> distances = { 0.3, 0.2 };
+    const std::string path = "./test_template_library.sitmpl";
+
+    /* Options altering the rendered images are disabled while generating and restored afterwards. */
+    si_cad.setRoiOpt(true);
+    si_cad.setRenderCacheOpt(true, 1e-6);
+
+    if (!TemplateLibrary::generate(si_cad, "alien", orientations_num, distances, path))
+    {
+        std::cerr << log_ID << " Failed to generate the template library." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (si_cad.getRenderModeOpt() != SICAD::RenderMode::color || !si_cad.getRoiOpt() || !si_cad.getRenderCacheOpt())
+    {
+        std::cerr << log_ID << " The options have not been restored." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    si_cad.setRoiOpt(false);
+    si_cad.setRenderCacheOpt(false, 1e-6);
+
+    try
+    {
+        TemplateLibrary library(path);
+
+        if (library.size() != orientations_num * distances.size() || library.getImageSize() != cv::Size(cam_width, cam_height))
+        {
+            std::cerr << log_ID << " Wrong number or size of templates." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        si_cad.setRenderModeOpt(SICAD::RenderMode::depth);
+
+        double cam_x[] = { 0, 0, 0 };
+        double cam_o[] = { 1.0, 0, 0, 0 };
+
+        for (size_t i = 0; i < library.size(); i += 7)
+        {
+            const TemplateLibrary::Template item = library.getTemplate(i);
+
+            if (library.findNearest(item.pose) != i)
+            {
+                std::cerr << log_ID << " The nearest template to template " << i << " is " << library.findNearest(item.pose) << "." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+
+            Superimpose::ModelPoseContainer objpose_map;
+            objpose_map.emplace("alien", item.pose);
+
+            cv::Mat img;
+            si_cad.superimpose(objpose_map, cam_x, cam_o, img);
+
+            const cv::Mat mask = img > 0;
+            if (cv::boundingRect(mask) != item.roi || item.roi.area() == 0 || cv::norm(mask(item.roi), item.mask, cv::NORM_INF) != 0)
+            {
+                std::cerr << log_ID << " The mask of template " << i << " does not match its rendering." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+
+            cv::Mat edges_inside;
+            cv::bitwise_and(item.edges, item.mask, edges_inside);
+            if (cv::countNonZero(item.edges) == 0 || cv::countNonZero(edges_inside) != cv::countNonZero(item.edges))
+            {
+                std::cerr << log_ID << " The edges of template " << i << " are not on the silhouette." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        }
+
+        /* The nearest orientations are sorted and all at the nearest distance. */
+        const TemplateLibrary::Template item = library.getTemplate(3 * distances.size() + 1);
+        const std::vector<size_t> nearest = library.findNearest(item.pose, 5);
+        if (nearest.size() != 5 || nearest.front() != 3 * distances.size() + 1)
+        {
+            std::cerr << log_ID << " Wrong nearest orientations." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        for (const size_t index : nearest)
+            if (index % distances.size() != 1)
+            {
+                std::cerr << log_ID << " Nearest template " << index << " is not at the nearest distance." << std::endl;
+
+                return EXIT_FAILURE;
+            }
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << log_ID << " " << e.what() << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Libraries with a different byte order are rejected. The byte order field follows the 8-byte magic. */
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+
+        char byte_order[4];
+        file.seekg(8);
+        file.read(byte_order, 4);
+        std::reverse(byte_order, byte_order + 4);
+        file.seekp(8);
+        file.write(byte_order, 4);
+        file.close();
+
+        bool thrown = false;
+        try
+        {
+            TemplateLibrary library(path);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        if (!thrown)
+        {
+            std::cerr << log_ID << " A library with a different byte order has been opened." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::remove(path.c_str());
+
+    std::cout << log_ID << " Templates are stored and retrieved consistently." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+float halfToFloat(const std::uint16_t half)
+{
+    const int exponent = (half >> 10) & 0x1F;
+    const int mantissa = half & 0x3FF;
+    const float sign = (half & 0x8000) ? -1.0f : 1.0f;
+
+    if (exponent == 0)
+        return sign * std::ldexp(static_cast<float>(mantissa), -24);
+
+    return sign * std::ldexp(static_cast<float>(mantissa + 1024), exponent - 25);
+}
+
+
+float getElement(const SICAD::Tensor& tensor, const size_t n, const size_t c, const size_t h, const size_t w)
+{
+    const size_t index = tensor.layout == SICAD::TensorLayout::nchw ?
+                         n * tensor.strides[0] + c * tensor.strides[1] + h * tensor.strides[2] + w * tensor.strides[3] :
+                         n * tensor.strides[0] + h * tensor.strides[1] + w * tensor.strides[2] + c * tensor.strides[3];
+
+    if (tensor.format == SICAD::TensorFormat::float16)
+    {
+        std::uint16_t half;
+        std::memcpy(&half, static_cast<const unsigned char*>(tensor.data) + index * tensor.element_size, sizeof(half));
+
+        return halfToFloat(half);
+    }
+
+    float value;
+    std::memcpy(&value, static_cast<const unsigned char*>(tensor.data) + index * tensor.element_size, sizeof(value));
+
+    return value;
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Tensor]";
+    std::cout << log_ID << "This test checks whether tensors match the normalized tiles of the multi-tile superimpose()." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 4);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    /* The batch is larger than the render grid, so that it is rendered in two passes. */
+    const size_t batch_size = si_cad.getTilesNumber() + 1;
+    const int tiles_cols = si_cad.getTilesCols();
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(batch_size);
+    for (size_t k = 0; k < batch_size; ++k)
+    {
+        Superimpose::ModelPose pose(7);
+        pose[0] = -0.04 + 0.02 * k;
+        pose[1] = 0;
+        pose[2] = -0.2;
+        pose[3] = 0;
+        pose[4] = 1.0;
+        pose[5] = 0;
+        pose[6] = 0.3 * k;
+
+        objposes[k].emplace("alien", pose);
+    }
+
+    cv::Mat img;
+    si_cad.superimpose(objposes, cam_x, cam_o, img);
+
+    const std::array<GLfloat, 3> mean = { { 0.485f, 0.456f, 0.406f } };
+    const std::array<GLfloat, 3> std_dev = { { 0.229f, 0.224f, 0.225f } };
+
+    const SICAD::TensorLayout layouts[] = { SICAD::TensorLayout::nchw, SICAD::TensorLayout::nhwc };
+    const SICAD::TensorFormat formats[] = { SICAD::TensorFormat::float32, SICAD::TensorFormat::float16 };
+    const float tolerances[] = { 1e-4f, 2e-2f };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (!si_cad.setTensorOpt(layouts[i], formats[i], mean, std_dev))
+        {
+            std::cerr << log_ID << " Failed to set the tensor options." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        SICAD::Tensor tensor;
+        if (!si_cad.superimposeTensor(objposes, cam_x, cam_o, tensor))
+        {
+            std::cerr << log_ID << " Failed to render the tensor." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        const std::array<size_t, 4> shape = layouts[i] == SICAD::TensorLayout::nchw ?
+                                            std::array<size_t, 4>{ { batch_size, 3, cam_height, cam_width } } :
+                                            std::array<size_t, 4>{ { batch_size, cam_height, cam_width, 3 } };
+
+        if (tensor.data == nullptr || tensor.shape != shape || tensor.strides[3] != 1 || tensor.strides[0] != 3 * cam_width * cam_height)
+        {
+            std::cerr << log_ID << " Wrong tensor descriptor." << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        for (size_t n = 0; n < batch_size; ++n)
+        {
+            const cv::Mat tile = img(cv::Rect((n % tiles_cols) * cam_width, (n / tiles_cols) * cam_height, cam_width, cam_height));
+
+            for (size_t h = 0; h < cam_height; h += 3)
+                for (size_t w = 0; w < cam_width; w += 3)
+                {
+                    const cv::Vec3b& bgr = tile.at<cv::Vec3b>(h, w);
+
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        const float expected = (bgr[2 - c] / 255.0f - mean[c]) / std_dev[c];
+                        if (std::abs(getElement(tensor, n, c, h, w) - expected) > tolerances[i] * std::max(1.0f, std::abs(expected)))
+                        {
+                            std::cerr << log_ID << " Element (" << n << ", " << c << ", " << h << ", " << w << ") is " << getElement(tensor, n, c, h, w)
+                                      << " instead of " << expected << "." << std::endl;
+
+                            return EXIT_FAILURE;
+                        }
+                    }
+                }
+        }
+    }
+
+    std::cout << log_ID << " Tensors match the normalized tiles." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+#include <SuperimposeMesh/TextureCache.h>
+
+
+int testReferences(const std::string& log_ID)
+{
+    TextureCache& texture_cache = TextureCache::getInstance();
+
+    const cv::Mat image(256, 256, CV_8UC3, cv::Scalar(255, 128, 0));
+    const size_t image_bytes = image.total() * image.elemSize() * 4 / 3;
+
+    const std::string key = "test_texture_cache_references";
+
+    /* Textures are uploaded once, then shared. */
+    const GLuint texture = texture_cache.acquire(key, image);
+    const GLuint shared_texture = texture_cache.acquire(key, image);
+
+    GLuint texture_by_key = 0;
+    if (texture == 0 || shared_texture != texture || !texture_cache.acquire(key, texture_by_key) || texture_by_key != texture)
+    {
+        std::cerr << log_ID << " The same key returned different texture objects." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (texture_cache.getMemoryUsage() != image_bytes)
+    {
+        std::cerr << log_ID << " Shared texture accounted for " << texture_cache.getMemoryUsage() << " bytes instead of " << image_bytes << "." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Textures are deleted with their last reference. */
+    texture_cache.release(texture);
+    texture_cache.release(texture);
+    if (!texture_cache.contains(key) || glIsTexture(texture) == GL_FALSE)
+    {
+        std::cerr << log_ID << " Texture deleted while still referenced." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    texture_cache.release(texture);
+    if (texture_cache.contains(key) || glIsTexture(texture) == GL_TRUE || texture_cache.getMemoryUsage() != 0)
+    {
+        std::cerr << log_ID << " Texture not deleted with its last reference." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int testBudget(const std::string& log_ID)
+{
+    TextureCache& texture_cache = TextureCache::getInstance();
+
+    const cv::Mat image(256, 256, CV_8UC3, cv::Scalar(255, 128, 0));
+
+    /* Only a 64x64 texture, with its mipmaps, fits the budget. */
+    const size_t budget = 64 * 64 * 3 * 4 / 3;
+    texture_cache.setMemoryBudget(budget);
+
+    const GLuint texture = texture_cache.acquire("test_texture_cache_budget", image);
+
+    GLint width = 0;
+    GLint height = 0;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    const size_t usage = texture_cache.getMemoryUsage();
+
+    texture_cache.release(texture);
+    texture_cache.setMemoryBudget(static_cast<size_t>(-1));
+
+    if (width != 64 || height != 64 || usage > budget)
+    {
+        std::cerr << log_ID << " Texture uploaded as " << width << "x" << height << " using " << usage << " bytes with a budget of " << budget << " bytes." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int testContext(const std::string& log_ID)
+{
+    if (glfwInit() == GL_FALSE)
+    {
+        std::cerr << log_ID << " Failed to initialize GLFW." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Same context as the one created by SICAD. */
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(1, 1, "OpenGL window", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        std::cerr << log_ID << " Failed to create the OpenGL context." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK)
+    {
+        std::cerr << log_ID << " Failed to initialize GLEW." << std::endl;
+        glfwTerminate();
+
+        return EXIT_FAILURE;
+    }
+
+    int result = testReferences(log_ID);
+
+    if (result == EXIT_SUCCESS)
+        result = testBudget(log_ID);
+
+    glfwMakeContextCurrent(nullptr);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    return result;
+}
+
+
+int testSharing(const std::string& log_ID)
+{
+    TextureCache& texture_cache = TextureCache::getInstance();
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader_textured.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    /* Textures are keyed by their content. */
+    std::ifstream file("./spaceinvader_texture.jpg", std::ios::binary);
+    const std::vector<char> encoded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const std::string key = TextureCache::getKey(encoded.data(), encoded.size());
+
+    const cv::Mat image = cv::imread("./spaceinvader_texture.jpg", cv::IMREAD_ANYCOLOR);
+    const size_t image_bytes = image.total() * image.elemSize() * 4 / 3;
+
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPoseContainer objpose_map;
+    objpose_map.emplace("alien", obj_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    SICAD* si_cad_first = new SICAD(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1);
+    SICAD* si_cad_second = new SICAD(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 1);
+
+    /* The texture file is read from the cache by its canonical path, and the texture object is shared by both the SICAD objects. */
+    std::string path_key;
+    if (!texture_cache.findPath(TextureCache::getCanonicalPath("./spaceinvader_texture.jpg"), path_key) || path_key != key ||
+        !texture_cache.contains(key) || texture_cache.getMemoryUsage() != image_bytes)
+    {
+        std::cerr << log_ID << " Texture not shared between SICAD objects, " << texture_cache.getMemoryUsage() << " bytes used instead of " << image_bytes << "." << std::endl;
+        delete si_cad_second;
+        delete si_cad_first;
+
+        return EXIT_FAILURE;
+    }
+
+    cv::Mat img_first;
+    si_cad_first->superimpose(objpose_map, cam_x, cam_o, img_first);
+
+    cv::Mat img_second;
+    si_cad_second->superimpose(objpose_map, cam_x, cam_o, img_second);
+
+    cv::imwrite("./test_texture_cache.png", img_second);
+
+    if (cv::countNonZero(img_first.reshape(1)) == 0 || cv::norm(img_first, img_second, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " SICAD objects sharing the texture rendered different images." << std::endl;
+        delete si_cad_second;
+        delete si_cad_first;
+
+        return EXIT_FAILURE;
+    }
+
+    /* The texture object is released by each SICAD object, and deleted with the last one. */
+    delete si_cad_first;
+    if (!texture_cache.contains(key))
+    {
+        std::cerr << log_ID << " Texture deleted while still used by a SICAD object." << std::endl;
+        delete si_cad_second;
+
+        return EXIT_FAILURE;
+    }
+
+    delete si_cad_second;
+    if (texture_cache.contains(key) || texture_cache.getMemoryUsage() != 0)
+    {
+        std::cerr << log_ID << " Texture not deleted with the last SICAD object using it." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int main()
+{
+    std::string log_ID = "[Test - Texture cache]";
+    std::cout << log_ID << "This test checks whether textures are reference counted, shared among SICAD objects and downscaled to fit the memory budget." << std::endl;
+
+    if (testContext(log_ID) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    if (testSharing(log_ID) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    std::cout << log_ID << " Textures are reference counted, shared and downscaled." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2016-2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD 3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <SuperimposeMesh/SICAD.h>
+
+
+int main()
+{
+    std::string log_ID = "[Test - Vertex quantization]";
+    std::cout << log_ID << "This test checks whether mesh models with quantized vertex positions render as with floating point positions." << std::endl;
+
+    SICAD::ModelPathContainer obj;
+    obj.emplace("alien", "./spaceinvader.obj");
+
+    const unsigned int cam_width  = 320;
+    const unsigned int cam_height = 240;
+    const float        cam_fx     = 257.34;
+    const float        cam_cx     = 160;
+    const float        cam_fy     = 257.34;
+    const float        cam_cy     = 120;
+
+    SICAD si_cad(obj, cam_width, cam_height, cam_fx, cam_fy, cam_cx, cam_cy, 2);
+
+    /* Facing the camera, and rotated so that the edges of the model are not aligned with the pixels. */
+    Superimpose::ModelPose obj_pose(7);
+    obj_pose[0] = 0;
+    obj_pose[1] = 0;
+    obj_pose[2] = -0.1;
+    obj_pose[3] = 0;
+    obj_pose[4] = 1.0;
+    obj_pose[5] = 0;
+    obj_pose[6] = 0;
+
+    Superimpose::ModelPose rotated_pose(obj_pose);
+    rotated_pose[3] = 0.3;
+    rotated_pose[4] = 1.0;
+    rotated_pose[5] = 0.2;
+    rotated_pose[6] = 0.7;
+
+    std::vector<Superimpose::ModelPoseContainer> objposes(2);
+    objposes[0].emplace("alien", obj_pose);
+    objposes[1].emplace("alien", rotated_pose);
+
+    double cam_x[] = { 0, 0, 0 };
+    double cam_o[] = { 1.0, 0, 0, 0 };
+
+    /* The built-in shader of untextured mesh models reads the vertex position only, hence positions are quantized. */
+    cv::Mat img_float;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_float);
+
+    si_cad.setVertexQuantizationOpt(true);
+
+    cv::Mat img_quantized;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_quantized);
+
+    cv::imwrite("./test_vertex_quantization.png", img_quantized);
+
+    cv::Mat mask_float;
+    cv::cvtColor(img_float, mask_float, cv::COLOR_BGR2GRAY);
+    mask_float = mask_float > 0;
+
+    cv::Mat mask_quantized;
+    cv::cvtColor(img_quantized, mask_quantized, cv::COLOR_BGR2GRAY);
+    mask_quantized = mask_quantized > 0;
+
+    /* Positions are quantized to 1/65535 of the model extent, i.e. about 2 um, hence only a few pixels on the silhouette may flip. */
+    cv::Mat mask_diff;
+    cv::bitwise_xor(mask_float, mask_quantized, mask_diff);
+
+    const int foreground = cv::countNonZero(mask_float);
+    if (foreground == 0 || cv::countNonZero(mask_diff) > foreground / 100)
+    {
+        std::cerr << log_ID << " " << cv::countNonZero(mask_diff) << " out of " << foreground << " pixels differ with quantized vertices." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    /* Back to floating point positions the image is rendered as before. */
+    si_cad.setVertexQuantizationOpt(false);
+
+    cv::Mat img_float_again;
+    si_cad.superimpose(objposes, cam_x, cam_o, img_float_again);
+
+    if (cv::norm(img_float, img_float_again, cv::NORM_INF) != 0)
+    {
+        std::cerr << log_ID << " Image changed after disabling vertex quantization." << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    std::cout << log_ID << " Quantized vertices render as floating point ones. Saving rendered image for visual inspection." << std::endl;
+
+    return EXIT_SUCCESS;
+}